@@ -53,6 +53,9 @@ class G4CsvAnalysisManager : public G4ToolsAnalysisManager
     static G4CsvAnalysisManager* Instance();
     static G4bool IsInstance();
 
+    // Reset histograms, profiles and ntuples
+    G4bool Reset();
+
     // Access methods
     tools::wcsv::ntuple* GetNtuple() const;
     tools::wcsv::ntuple* GetNtuple(G4int ntupleId) const;
@@ -73,6 +76,7 @@ class G4CsvAnalysisManager : public G4ToolsAnalysisManager
     virtual G4bool WriteImpl() final;
     virtual G4bool CloseFileImpl() final; 
     virtual G4bool IsOpenFileImpl() const final;
+    virtual G4bool ResetImpl() final;
 
   private:
     // static data members
@@ -92,7 +96,6 @@ class G4CsvAnalysisManager : public G4ToolsAnalysisManager
     G4bool WriteP1();
     G4bool WriteP2();
     G4bool CloseNtupleFiles();
-    G4bool Reset();
  
     // data members
     G4CsvNtupleManager* fNtupleManager;
@@ -67,6 +67,10 @@ class G4VAnalysisManager
   public:
     G4VAnalysisManager(const G4String& type, G4bool isMaster);
     virtual ~G4VAnalysisManager();
+
+    // The analysis manager of the current thread, of any type, 
+    // or nullptr if it was not yet instantiated
+    static G4VAnalysisManager* GetInstanceIfExist();
    
     // Methods for handling files 
     G4bool OpenFile(const G4String& fileName = "");
@@ -74,6 +78,9 @@ class G4VAnalysisManager
     G4bool CloseFile(); 
     G4bool Merge(tools::histo::hmpi* hmpi);   
     G4bool Plot();
+    // Reset histograms, profiles and ntuples; 
+    // returns false if not supported by the manager type
+    G4bool Reset();
     G4bool IsOpenFile() const;
 
     // Methods for handling files and directories names  
@@ -590,6 +597,7 @@ class G4VAnalysisManager
     virtual G4bool CloseFileImpl() = 0;
     virtual G4bool PlotImpl() = 0;
     virtual G4bool MergeImpl(tools::histo::hmpi* hmpi) = 0;
+    virtual G4bool ResetImpl();
     virtual G4bool IsOpenFileImpl() const = 0;
  
     // methods
@@ -609,6 +617,9 @@ class G4VAnalysisManager
     std::shared_ptr<G4VFileManager>  fVFileManager;
 
   private:
+    // static data members
+    static G4ThreadLocal G4VAnalysisManager* fgThreadInstance;
+
     // data members
     std::unique_ptr<G4AnalysisMessenger> fMessenger;
     std::shared_ptr<G4HnManager>   fH1HnManager;
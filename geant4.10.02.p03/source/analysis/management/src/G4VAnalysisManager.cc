@@ -43,6 +43,14 @@
 
 using namespace G4Analysis;
 
+G4ThreadLocal G4VAnalysisManager* G4VAnalysisManager::fgThreadInstance = nullptr;
+
+//_____________________________________________________________________________
+G4VAnalysisManager* G4VAnalysisManager::GetInstanceIfExist()
+{
+  return fgThreadInstance;
+}
+
 //_____________________________________________________________________________
 G4VAnalysisManager::G4VAnalysisManager(const G4String& type, G4bool isMaster)
  : fState(type, isMaster),
@@ -61,16 +69,25 @@ G4VAnalysisManager::G4VAnalysisManager(const G4String& type, G4bool isMaster)
    fVNtupleManager(nullptr)
 {
   //fMessenger = G4Analysis::make_unique<G4AnalysisMessenger>(this);
+  fgThreadInstance = this;
 }
 
 //_____________________________________________________________________________
 G4VAnalysisManager::~G4VAnalysisManager()
-{}
+{
+  if ( fgThreadInstance == this ) fgThreadInstance = nullptr;
+}
 
 // 
 // protected methods
 //
 
+//_____________________________________________________________________________
+G4bool G4VAnalysisManager::ResetImpl()
+{
+  return false;
+}  
+
 //_____________________________________________________________________________
 void G4VAnalysisManager::SetH1Manager(G4VH1Manager* h1Manager)
 {
@@ -231,6 +248,12 @@ G4bool G4VAnalysisManager::Plot()
   return PlotImpl();
 }  
 
+//_____________________________________________________________________________
+G4bool G4VAnalysisManager::Reset()
+{
+  return ResetImpl();
+}  
+
 //_____________________________________________________________________________
 G4bool G4VAnalysisManager::IsOpenFile() const
 {
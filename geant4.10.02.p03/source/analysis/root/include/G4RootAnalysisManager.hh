@@ -60,6 +60,9 @@ class G4RootAnalysisManager : public  G4ToolsAnalysisManager
     static G4RootAnalysisManager* Instance();
     static G4bool IsInstance();
 
+    // Reset histograms, profiles and ntuples
+    G4bool Reset();
+
     // Access methods
     tools::wroot::ntuple* GetNtuple() const;
     tools::wroot::ntuple* GetNtuple(G4int ntupleId) const;
@@ -76,6 +79,7 @@ class G4RootAnalysisManager : public  G4ToolsAnalysisManager
     virtual G4bool WriteImpl() final;
     virtual G4bool CloseFileImpl() final; 
     virtual G4bool IsOpenFileImpl() const final;
+    virtual G4bool ResetImpl() final;
 
   private:
     // static data members
@@ -93,7 +97,6 @@ class G4RootAnalysisManager : public  G4ToolsAnalysisManager
     G4bool WriteH3();
     G4bool WriteP1();
     G4bool WriteP2();
-    G4bool Reset();
 
     // data members
     G4RootNtupleManager* fNtupleManager;
@@ -53,6 +53,9 @@ class G4XmlAnalysisManager : public G4ToolsAnalysisManager
     static G4XmlAnalysisManager* Instance();
     static G4bool IsInstance();
 
+    // Reset histograms, profiles and ntuples
+    G4bool Reset();
+
     // Access methods
     tools::waxml::ntuple* GetNtuple() const;
     tools::waxml::ntuple* GetNtuple(G4int ntupleId) const;
@@ -69,6 +72,7 @@ class G4XmlAnalysisManager : public G4ToolsAnalysisManager
     virtual G4bool WriteImpl() final;
     virtual G4bool CloseFileImpl() final; 
     virtual G4bool IsOpenFileImpl() const final;
+    virtual G4bool ResetImpl() final;
 
   private:
     // static data members
@@ -88,7 +92,6 @@ class G4XmlAnalysisManager : public G4ToolsAnalysisManager
     G4bool WriteP2();
     G4bool WriteNtuple();
     G4bool CloseNtupleFiles();
-    G4bool Reset();
 
     // data members
     G4XmlNtupleManager*  fNtupleManager;
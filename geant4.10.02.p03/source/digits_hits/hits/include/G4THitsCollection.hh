@@ -35,6 +35,7 @@
 #include "globals.hh"
 //#include "g4rw/tpordvec.h"
 #include <vector>
+#include <type_traits>
 
 // class description:
 //
@@ -122,6 +123,14 @@ template <class T> class G4THitsCollection : public G4HitsCollection
       {
           if (!anHCAllocator_G4MT_TLS_) anHCAllocator_G4MT_TLS_ = new G4Allocator<G4HitsCollection>;
           return ((std::vector<T*>*)theCollection)->size(); }
+      virtual G4bool Merge(const G4VHitsCollection* right);
+      //  Copies of the hits of the given collection are appended. The hit
+      // class must be copy-constructible.
+
+  private:
+      G4bool MergeCopies(const G4THitsCollection<T>* right, std::true_type);
+      G4bool MergeCopies(const G4THitsCollection<T>*, std::false_type)
+      { return false; }
 
 };
 
@@ -192,5 +201,22 @@ template <class T> void G4THitsCollection<T>::PrintAllHits()
   { (*theHitsCollection)[i]->Print(); }
 }
 
+template <class T> G4bool G4THitsCollection<T>::Merge(const G4VHitsCollection* right)
+{
+  const G4THitsCollection<T>* aHC = dynamic_cast<const G4THitsCollection<T>*>(right);
+  if(!aHC) return false;
+  return MergeCopies(aHC,std::is_copy_constructible<T>());
+}
+
+template <class T> G4bool G4THitsCollection<T>::MergeCopies
+                   (const G4THitsCollection<T>* right, std::true_type)
+{
+  std::vector<T*> * theHitsCollection = (std::vector<T*>*)theCollection;
+  std::vector<T*> * rightCollection = right->GetVector();
+  for(size_t i=0;i<rightCollection->size();i++)
+  { theHitsCollection->push_back(new T(*((*rightCollection)[i]))); }
+  return true;
+}
+
 #endif
 
@@ -85,6 +85,13 @@ template <typename T> class G4THitsMap : public G4HitsCollection
     virtual G4VHit* GetHit(size_t) const {return 0;}
     virtual size_t GetSize() const
     { return ((std::map<G4int,T*>*)theCollection)->size(); }
+    virtual G4bool Merge(const G4VHitsCollection* right)
+    {
+      const G4THitsMap<T>* aMap = dynamic_cast<const G4THitsMap<T>*>(right);
+      if(!aMap) return false;
+      *this += *aMap;
+      return true;
+    }
 
 };
 
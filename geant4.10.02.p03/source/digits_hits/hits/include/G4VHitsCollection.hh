@@ -78,6 +78,13 @@ class G4VHitsCollection
       virtual G4VHit* GetHit(size_t) const { return nullptr; } 
       virtual size_t GetSize() const { return 0; };
 
+  public: // with description
+      virtual G4bool Merge(const G4VHitsCollection*) { return false; }
+      //  Appends copies of the hits of the given collection of the same
+      // kind to this collection. Used by G4EventManager to merge the hits
+      // of a sub-event transported by another thread. Returns false if
+      // this collection does not support merging.
+
 };
 
 #endif
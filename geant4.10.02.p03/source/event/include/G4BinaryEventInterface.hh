@@ -0,0 +1,170 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+//
+// class description:
+//
+// G4BinaryEventInterface is a concrete class of G4VPrimaryGenerator which
+// reads pre-generated events from a compact binary file. The file is
+// mapped in memory (mmap) and events are accessed by their index through
+// an index table, so that the worker threads of a multi-threaded run read
+// disjoint events without any lock: event i of the run uses the event
+// (first event + i) of the file. The records are converted directly into
+// G4PrimaryVertex and G4PrimaryParticle objects.
+//
+// G4BinaryEventWriter writes the primary vertices and particles of
+// G4Event objects in this format, e.g. to convert the output of another
+// primary generator (G4HEPEvtInterface, G4GeneralParticleSource, ...)
+// once before many runs.
+//
+// File format, in the byte order of the writing machine and in Geant4
+// internal units (mm, ns, MeV):
+//   G4BinaryEventHeader
+//   for each event:
+//     G4BinaryEventRecord
+//     for each vertex: G4BinaryVertexRecord followed by its particles,
+//                      G4BinaryParticleRecord
+//   index : nEvents 64-bit offsets of the G4BinaryEventRecord objects
+// A particle whose parent index is not negative is a pre-assigned decay
+// product of the particle of this index in the same vertex.
+
+#ifndef G4BinaryEventInterface_h
+#define G4BinaryEventInterface_h 1
+
+#include "globals.hh"
+#include "G4VPrimaryGenerator.hh"
+#include <fstream>
+#include <vector>
+#include <map>
+#include <stdint.h>
+
+class G4Event;
+class G4PrimaryParticle;
+class G4ParticleDefinition;
+
+struct G4BinaryEventHeader
+{
+  char magic[8];          // "G4EVTBIN"
+  G4int version;
+  G4int byteOrder;        // 0x01020304 as written
+  G4int nEvents;
+  G4int reserved;
+  int64_t indexOffset;    // offset of the event index
+};
+
+struct G4BinaryEventRecord
+{
+  G4int nVertices;
+  G4int nParticles;       // in all the vertices
+};
+
+struct G4BinaryVertexRecord
+{
+  G4double position[3];
+  G4double time;
+  G4double weight;
+  G4int nParticles;
+  G4int reserved;
+};
+
+struct G4BinaryParticleRecord
+{
+  G4double momentum[3];
+  G4double mass;          // negative : mass of the particle definition
+  G4double polarization[3];
+  G4double weight;
+  G4int pdgCode;
+  G4int parent;           // index in the vertex, -1 for a primary
+};
+
+class G4BinaryEventInterface : public G4VPrimaryGenerator
+{
+  public: // with description
+    G4BinaryEventInterface(const G4String& fileName, G4int vl = 0);
+    //  Map the given file. The format is checked at once.
+    virtual ~G4BinaryEventInterface();
+
+    virtual void GeneratePrimaryVertex(G4Event* evt);
+    //  Add the vertices of event (first event + event ID) of the file.
+
+    inline void SetFirstEvent(G4int i) { firstEvent = i; }
+    inline G4int GetFirstEvent() const { return firstEvent; }
+    //  Index of the file event used for the event 0 of each run.
+    inline G4int GetNumberOfEvents() const { return nEvents; }
+    inline void SetVerboseLevel(G4int vl) { vLevel = vl; }
+
+  private:
+    G4BinaryEventInterface(const G4BinaryEventInterface&);
+    G4BinaryEventInterface& operator=(const G4BinaryEventInterface&);
+
+    void Map();
+    void Unmap();
+    G4PrimaryParticle* MakeParticle(const G4BinaryParticleRecord& rec);
+
+  private:
+    G4String fileName;
+    G4int vLevel;
+    G4int firstEvent;
+    G4int nEvents;
+    const char* data;
+    size_t dataSize;
+    size_t recordsEnd;
+    G4bool isMapped;
+    std::vector<char> fileContent;   // used where mmap is not available
+    const int64_t* eventIndex;
+    std::map<G4int,const G4ParticleDefinition*> definitions;
+    std::vector<G4PrimaryParticle*> vertexParticles;
+};
+
+class G4BinaryEventWriter
+{
+  public: // with description
+    G4BinaryEventWriter(const G4String& fileName);
+    ~G4BinaryEventWriter();
+    //  The file is completed by Close(), called by the destructor.
+
+    G4bool Write(const G4Event* evt);
+    //  Append the primary vertices of the event.
+    void Close();
+    inline G4int GetNumberOfEvents() const { return G4int(offsets.size()); }
+
+  private:
+    G4BinaryEventWriter(const G4BinaryEventWriter&);
+    G4BinaryEventWriter& operator=(const G4BinaryEventWriter&);
+
+    void AddParticles(const G4PrimaryParticle* first, G4int parent);
+
+  private:
+    G4String fileName;
+    std::ofstream file;
+    std::vector<int64_t> offsets;
+    std::vector<G4BinaryParticleRecord> particles;
+    size_t vertexFirst;
+};
+
+#endif
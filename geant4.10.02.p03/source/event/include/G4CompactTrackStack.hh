@@ -0,0 +1,121 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#ifndef G4CompactTrackStack_h
+#define G4CompactTrackStack_h 1
+
+#include "G4VTrackStack.hh"
+#include "G4TrackStack.hh"
+#include "G4ThreeVector.hh"
+#include "G4TouchableHandle.hh"
+#include "G4TrackStatus.hh"
+#include "globals.hh"
+#include <vector>
+#include <deque>
+
+class G4Track;
+class G4ParticleDefinition;
+class G4VProcess;
+
+// class description:
+//
+// This is a stack class which can be used as the urgent stack of
+// G4StackManager (/event/stack/urgentStack compact). Fresh tracks, i.e.
+// tracks which have not made any step and carry only the state given to
+// secondaries by the physics processes, are stored in contiguous arrays
+// (struct of arrays) of positions, momentum directions, kinetic energies,
+// times, weights, track and parent IDs, particle indices, creator process
+// and touchable. Their G4Track and G4DynamicParticle objects are deleted
+// when pushed, and a new G4Track is materialized when the entry is popped
+// for transport. Other tracks (primaries with a G4PrimaryParticle, tracks
+// with a trajectory, user or auxiliary information, polarization, etc.)
+// are kept as G4StackedTrack objects. The last nRecent tracks pushed are
+// kept as they are, and a track is compacted only when it leaves this
+// window, so that the secondaries which are popped soon after they are
+// pushed (most of them in an electromagnetic shower) are not deleted and
+// created again. The last-in-first-out order of all tracks is the same as
+// the one of G4TrackStack, so the results of an event do not change.
+
+class G4CompactTrackStack : public G4VTrackStack
+{
+  public:
+      G4CompactTrackStack(size_t n = 5000, G4int nRecent = 128);
+      virtual ~G4CompactTrackStack();
+
+  private:
+      G4CompactTrackStack(const G4CompactTrackStack&);
+      const G4CompactTrackStack & operator=(const G4CompactTrackStack &right);
+
+  public:
+      void PushToStack(const G4StackedTrack& aStackedTrack);
+      G4StackedTrack PopFromStack();
+      void TransferTo(G4TrackStack* aStack);
+      void clearAndDestroy();
+      G4int GetNTrack() const { return G4int(particleIndex.size()+recent.size()); }
+      G4int GetMaxNTrack() const { return maxNTracks; }
+
+  public: // with description
+      static G4bool IsCompactable(const G4StackedTrack& aStackedTrack);
+      //  Returns true if the track can be stored in the arrays
+      G4int GetNCompactTrack() const { return G4int(position.size()); }
+
+  private:
+      void CompactTrack(const G4StackedTrack& aStackedTrack);
+      G4Track* PopCompactTrack(G4int iParticle);
+      G4int ParticleIndex(const G4ParticleDefinition* particle);
+
+  private:
+      // One entry per stacked track, in the order of arrival. Index -1
+      // means that the track is the last element of fullTracks, otherwise
+      // it is the index of the particle in "particles" and the track is
+      // the last element of the following arrays.
+      std::vector<G4int> particleIndex;
+      std::vector<G4ThreeVector> position;
+      std::vector<G4ThreeVector> direction;
+      std::vector<G4double> kineticEnergy;
+      std::vector<G4double> globalTime;
+      std::vector<G4double> localTime;
+      std::vector<G4double> weight;
+      std::vector<G4int> trackID;
+      std::vector<G4int> parentID;
+      std::vector<G4int> creatorModel;
+      std::vector<const G4VProcess*> creatorProcess;
+      std::vector<G4TouchableHandle> touchable;
+      std::vector<char> flags;
+
+      G4TrackStack fullTracks;
+      std::vector<const G4ParticleDefinition*> particles;
+
+      // Last tracks pushed, above all the entries of particleIndex
+      std::deque<G4StackedTrack> recent;
+      G4int nRecent;
+      G4int maxNTracks;
+};
+
+#endif
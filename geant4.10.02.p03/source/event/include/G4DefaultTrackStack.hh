@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#ifndef G4DefaultTrackStack_h
+#define G4DefaultTrackStack_h 1
+
+#include "G4VTrackStack.hh"
+#include "G4TrackStack.hh"
+
+// class description:
+//
+// This is the default urgent stack of G4StackManager. It is an ordinary
+// last-in-first-out G4TrackStack seen through the G4VTrackStack interface.
+// The underlying G4TrackStack is given by GetTrackStack(), e.g. for the
+// tracks to be written to the spill file (see G4StackSpillFile).
+
+class G4DefaultTrackStack : public G4VTrackStack
+{
+  public:
+      G4DefaultTrackStack(size_t n = 5000) : stack(n) {}
+      virtual ~G4DefaultTrackStack() {}
+
+  private:
+      G4DefaultTrackStack(const G4DefaultTrackStack&);
+      const G4DefaultTrackStack & operator=(const G4DefaultTrackStack &right);
+
+  public:
+      void PushToStack(const G4StackedTrack& aStackedTrack)
+      { stack.PushToStack(aStackedTrack); }
+      G4StackedTrack PopFromStack()
+      { return stack.PopFromStack(); }
+      void TransferTo(G4TrackStack* aStack)
+      { stack.TransferTo(aStack); }
+      void TransferFrom(G4TrackStack* aStack)
+      { aStack->TransferTo(&stack); }
+      void clearAndDestroy()
+      { stack.clearAndDestroy(); }
+      G4int GetNTrack() const
+      { return stack.GetNTrack(); }
+      G4int GetMaxNTrack() const
+      { return stack.GetMaxNTrack(); }
+
+  public: // with description
+      G4TrackStack* GetTrackStack()
+      { return &stack; }
+
+  private:
+      G4TrackStack stack;
+};
+
+#endif
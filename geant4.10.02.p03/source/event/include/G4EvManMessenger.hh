@@ -43,6 +43,8 @@ class G4UIcmdWithAnInteger;
 //     /event/
 //     /event/abort
 //     /event/verbose
+//     /event/keepCurrentEvent
+//     /event/subEvent/
 //
 
 class G4EvManMessenger: public G4UImessenger
@@ -58,6 +60,9 @@ class G4EvManMessenger: public G4UImessenger
     G4UIcmdWithoutParameter* abortCmd;
     G4UIcmdWithAnInteger* verboseCmd;
     G4UIcmdWithoutParameter* storeEvtCmd;
+    G4UIdirectory* subEventDirectory;
+    G4UIcmdWithAnInteger* bundleSizeCmd;
+    G4UIcmdWithAnInteger* minUrgentCmd;
 };
 
 #endif
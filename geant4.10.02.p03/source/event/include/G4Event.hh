@@ -111,6 +111,9 @@ class G4Event
       G4bool keepTheEvent;
       mutable G4int grips;
 
+      // Flag set for a bundle of tracks transported by a helper thread
+      G4bool subEvent;
+
   public:
       inline void SetEventID(G4int i)
       { eventID =  i; }
@@ -122,6 +125,8 @@ class G4Event
       { trajectoryContainer = value; }
       inline void SetEventAborted()
       { eventAborted = true; }
+      inline void SetSubEvent(G4bool vl=true)
+      { subEvent = vl; }
       inline void SetRandomNumberStatus(G4String& st)
       {
         randomNumberStatus = new G4String(st);
@@ -195,6 +200,14 @@ class G4Event
       inline G4bool IsAborted() const { return eventAborted; }
       //  Return a boolean which indicates the event has been aborted and thus
       // it should not be used for analysis.
+      inline G4bool IsSubEvent() const { return subEvent; }
+      //  Return true if this object does not represent a whole event but a
+      // bundle of its tracks transported by a helper thread in sub-event
+      // parallel mode (see /event/subEvent/). The user event action is
+      // invoked for such a bundle as well, so that quantities accumulated by
+      // the stepping action reach the G4Run of the helper thread. Hits of the
+      // bundle are merged into the event which exported it, thus analysis of
+      // hits and per-event bookkeeping should skip sub-events.
       inline void SetUserInformation(G4VUserEventInformation* anInfo) { userInfo = anInfo; }
       inline G4VUserEventInformation* GetUserInformation() const { return userInfo; }
       //  Set and Get method of G4VUserEventInformation
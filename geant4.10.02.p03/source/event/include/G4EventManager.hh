@@ -50,6 +50,10 @@ class G4SDManager;
 class G4StateManager;
 #include "globals.hh"
 class G4VUserEventInformation;
+class G4SubEvent;
+class G4TrajectoryStore;
+#include <vector>
+#include <atomic>
 
 // class description:
 //
@@ -93,15 +97,41 @@ class G4EventManager
       // will be associated to this event object. If this event object has valid
       // primary vertices/particles, they will be added to the given trackvector input.
 
+      void ProcessSubEvents();
+      //  Used by worker threads which have no more event to process in
+      // sub-event parallel mode (see G4SubEventQueue). Bundles of tracks
+      // exported by other threads are transported until all worker threads
+      // have finished their event loop. Both methods of the user's event
+      // action are invoked for each bundle with a G4Event object flagged by
+      // G4Event::SetSubEvent().
+
   private:
       void DoProcessing(G4Event* anEvent);
       void StackTracks(G4TrackVector *trackVector, G4bool IDhasAlreadySet=false);
-  
+      void TransportStackedTracks();
+
+      // Sub-event parallelism
+      void ExportSubEvents();
+      G4bool CollectSubEvents();
+      void MergeSubEvents();
+      void ProcessSubEvent(G4SubEvent* aSubEvent);
+      void CleanUpSubEvents();
+      void NextTrackIDBlock();
+      G4bool subEventOwner;
+      G4int trackIDLimit;
+      std::atomic<G4int> subEventTrackIDs;
+      std::atomic<G4int>* trackIDSource;
+      //  Track IDs are taken in blocks from trackIDSource once trackIDCounter
+      // exceeds trackIDLimit. The owner of an event processed in sub-event
+      // parallel mode shares subEventTrackIDs with the helper threads.
+      std::vector<G4SubEvent*> ownSubEvents;
+      std::vector<G4SubEvent*> helpedSubEvents;  
       G4Event* currentEvent;
 
       G4StackManager *trackContainer;
       G4TrackingManager *trackManager;
       G4TrajectoryContainer *trajectoryContainer;
+      G4TrajectoryStore *trajectoryStore;
       G4int trackIDCounter;
       G4int verboseLevel;
       G4SDManager* sdManager;
@@ -163,7 +193,8 @@ class G4EventManager
       { return trackContainer; }
       inline G4TrackingManager* GetTrackingManager() const
       { return trackManager; }
-
+      inline G4TrajectoryStore* GetTrajectoryStore() const
+      { return trajectoryStore; }
   public: // with description
       inline G4int GetVerboseLevel()
       { return verboseLevel; }
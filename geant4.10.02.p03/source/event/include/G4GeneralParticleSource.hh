@@ -210,6 +210,12 @@ class G4GeneralParticleSource : public G4VPrimaryGenerator
 
         void SetFlatSampling(G4bool av) { GPSData->SetFlatSampling(av); normalised = false;} ;
 
+        // Set the number of vertices pre-sampled at once by each source
+        // (see G4SingleParticleSource::SetPrimaryBatchSize)
+        void SetPrimaryBatchSize(G4int n) { GPSData->SetPrimaryBatchSize(n); } ;
+        G4int GetPrimaryBatchSize() const { return GPSData->GetPrimaryBatchSize(); } ;
+        void FlushPrimaryBuffers() { GPSData->FlushPrimaryBuffers(); } ;
+
         // Set the particle species
         void SetParticleDefinition (G4ParticleDefinition * aParticleDefinition) 
           {GPSData->GetCurrentSource()->SetParticleDefinition(aParticleDefinition); } ;
@@ -92,6 +92,12 @@ class G4GeneralParticleSourceData
         G4int GetCurrentSourceIdx() const { return currentSourceIdx; }
 
         void SetVerbosityAllSources(G4int vl);
+
+        // Batch size of the pipelined generation, applied to all the
+        // sources including those added later
+        void SetPrimaryBatchSize(G4int n);
+        G4int GetPrimaryBatchSize() const { return primaryBatchSize; }
+        void FlushPrimaryBuffers();
         //Lock/Unlock shared mutex
         void Lock();
         void Unlock();
@@ -113,6 +119,7 @@ class G4GeneralParticleSourceData
     
         G4int currentSourceIdx;
         G4SingleParticleSource* currentSource;
+        G4int primaryBatchSize;
         G4Mutex mutex;
 };
 
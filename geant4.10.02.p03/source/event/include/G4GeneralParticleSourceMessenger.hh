@@ -190,6 +190,7 @@ class G4GeneralParticleSourceMessenger: public G4UImessenger
     G4UIcmdWithADoubleAndUnit  *partheCmd1;
     G4UIcmdWithADoubleAndUnit  *parphiCmd1;  
     G4UIcmdWithAString         *confineCmd1;
+    G4UIcmdWithAnInteger       *confineGridCmd1;
          
 //  //old ones, will be reomved soon
 //  G4UIcmdWithAString         *typeCmd;
@@ -286,6 +287,7 @@ class G4GeneralParticleSourceMessenger: public G4UImessenger
     G4UIcmdWithAString         *resethistCmd1;
 
     G4UIcmdWithAnInteger* verbosityCmd;
+    G4UIcmdWithAnInteger* pipelineCmd;
 
     // Commands from G4ParticleGun
     G4UIcommand* ionCmd;
@@ -37,6 +37,7 @@ class G4Event;
 class G4PrimaryVertex;
 #include "G4PrimaryParticle.hh"
 #include "G4DynamicParticle.hh"
+#include <map>
 
 // class description:
 //
@@ -66,6 +67,16 @@ class G4PrimaryTransformer
 
     G4int nWarn;
 
+    // Definitions found for the PDG codes of primaries given without a
+    // G4ParticleDefinition. Codes the particle table does not know are kept
+    // as null, so that they do not take the particle table mutex of worker
+    // threads once per primary. The cache is dropped whenever the size of
+    // the particle table changes.
+    std::map<G4int,G4ParticleDefinition*> pdgCache;
+    G4int pdgCacheTableSize;
+    G4int lastPDGcode;
+    G4ParticleDefinition* lastPDGdefinition;
+
   public:
     inline void SetVerboseLevel(G4int vl)
     { verboseLevel = vl; };
@@ -85,6 +96,8 @@ class G4PrimaryTransformer
     void SetDecayProducts(G4PrimaryParticle* mother,
                             G4DynamicParticle* motherDP);
     G4bool CheckDynamicParticle(G4DynamicParticle*DP);
+    G4ParticleDefinition* FindDefinition(G4int pdgCode);
+    void ClearDefinitionCache();
 
   protected: //with description
   // Following two virtual methods are provided to customize the use of PrimaryTransformer
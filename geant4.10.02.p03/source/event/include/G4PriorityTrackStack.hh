@@ -0,0 +1,120 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#ifndef G4PriorityTrackStack_h
+#define G4PriorityTrackStack_h 1
+
+#include "G4VTrackStack.hh"
+#include "G4TrackStack.hh"
+#include "globals.hh"
+#include <vector>
+
+class G4ParticleDefinition;
+class G4Region;
+class G4Track;
+
+// class description:
+//
+// This is a stack class which can be used as the urgent stack of
+// G4StackManager (/event/stack/urgentStack priority). It generalises
+// G4SmartTrackStack: tracks are sorted into buckets defined by the user
+// with a particle type, a region and a kinetic energy range, and the
+// buckets are emptied in the order of their priority (the lowest value
+// first). Each bucket is an ordinary last-in-first-out stack.
+//  A track goes to the first bucket, in the order of definition, whose
+// particle (any if empty), region (any if empty) and energy range match.
+// Tracks which match no bucket go to the default bucket.
+//  Processing the low-energy tracks first (AddEnergyBuckets()) bounds the
+// number of stacked tracks of large showers, since each low-energy track
+// produces few secondaries, and buckets per particle type keep the tracks
+// of the same type together. The order of the tracks, hence the random
+// number sequence, differs from G4TrackStack, but not the physics.
+
+class G4PriorityTrackStack : public G4VTrackStack
+{
+  public:
+      G4PriorityTrackStack();
+      virtual ~G4PriorityTrackStack();
+
+  private:
+      G4PriorityTrackStack(const G4PriorityTrackStack&);
+      const G4PriorityTrackStack & operator=(const G4PriorityTrackStack &right);
+
+  public:
+      void PushToStack(const G4StackedTrack& aStackedTrack);
+      G4StackedTrack PopFromStack();
+      void TransferTo(G4TrackStack* aStack);
+      void clearAndDestroy();
+      G4int GetNTrack() const { return nTracks; }
+      G4int GetMaxNTrack() const { return maxNTracks; }
+
+  public: // with description
+      void AddBucket(const G4String& particleName, const G4String& regionName,
+                     G4double eMin, G4double eMax, G4int priority);
+      //  Add a bucket. Empty names match any particle or region.
+      void AddEnergyBuckets(G4int nBins, G4double eMin, G4double eMax,
+                            const G4String& particleName = "", G4int firstPriority = 0);
+      //  Add nBins buckets with logarithmic kinetic energy ranges between
+      // eMin and eMax, with increasing priority values (lower energies are
+      // processed first). Energies below eMin go to the first bucket and
+      // above eMax to the last one.
+      void SetDefaultPriority(G4int priority);
+      void ClearBuckets();
+      //  Remove all buckets but the default one. Stacked tracks are kept.
+      void DumpBuckets() const;
+
+  private:
+      struct Bucket
+      {
+        G4String particleName;
+        G4String regionName;
+        G4double eMin;
+        G4double eMax;
+        G4int priority;
+        const G4ParticleDefinition* particle;
+        const G4Region* region;
+        G4TrackStack* stack;
+      };
+
+      size_t FindBucket(const G4Track* aTrack);
+      void ResolveBuckets();
+      void SortByPriority();
+      void AddBucket(const Bucket& aBucket);
+
+  private:
+      std::vector<Bucket> buckets;
+      // Last one is the default bucket
+      std::vector<size_t> popOrder;
+      // Indices of the buckets sorted by priority
+      G4bool resolved;
+      G4int nTracks;
+      G4int maxNTracks;
+};
+
+#endif
@@ -141,6 +141,7 @@
 #include "G4SPSRandomGenerator.hh"
 #include "G4Threading.hh"
 #include "G4Cache.hh"
+#include <vector>
 
 /** Andrea Dotti Feb 2015
  * Important: This is a shared class between threads.
@@ -188,6 +189,15 @@ public:
   void SetParTheta(G4double);
   void SetParPhi(G4double);
   void ConfineSourceToVolume(G4String);
+  // Number of bins per axis of the confinement grid (0 : no grid). For a
+  // confined source of type Volume without x, y, z biasing, the box of
+  // random numbers of the shape is divided into n^3 cells, classified
+  // once per thread and geometry as outside, inside or on the boundary of
+  // the confining volume. Points are drawn uniformly in the cells which
+  // are not outside, and only points of boundary cells are tested with
+  // the navigator. The distribution of the points is unchanged.
+  void SetConfineGridBins(G4int n);
+  G4int GetConfineGridBins() const;
   //
   void SetBiasRndm (G4SPSRandomGenerator* a);
   // Set the verbosity level.
@@ -209,6 +219,10 @@ public:
     G4String GetSourcePosType() const;
     G4ThreeVector GetParticlePos() const;
 
+  // Fraction of the sampled points accepted by the confinement in this
+  // thread, 1 if no point has been tested
+  G4double GetConfinementAcceptance() const;
+
 private:
 
   void GenerateRotationMatrices();
@@ -221,6 +235,11 @@ private:
 
   G4bool IsSourceConfined(G4ThreeVector& outputPos);
 
+  G4ThreeVector LocalVolumePoint(G4double rx, G4double ry, G4double rz) const;
+  G4bool IsInVolumeShape(const G4ThreeVector& localPos) const;
+  G4ThreeVector VolumePointToGlobal(const G4ThreeVector& localPos) const;
+  G4bool GeneratePointsInGrid(G4ThreeVector& outputPos);
+
 private:
   //VERY IMPORTANT:
   //This is a shared resource, however setters that
@@ -233,8 +252,21 @@ private:
     G4ThreeVector CSideRefVec2;
     G4ThreeVector CSideRefVec3;
     G4ThreeVector CParticlePos;
+    // Physical volumes named VolName, found once per confinement setting
+    // and world volume
+    std::vector<const G4VPhysicalVolume*> ConfineVolumes;
+    const G4VPhysicalVolume* ConfineWorld;
+    G4int ConfineRevision;
+    G4double NTried;
+    G4double NAccepted;
+    // Confinement grid: cell index*2, plus 1 for cells inside VolName
+    std::vector<G4int> GridCells;
+    const G4VPhysicalVolume* GridWorld;
+    G4int GridRevision;
     thread_data_t();
   };
+  G4Navigator* GetConfineNavigator(thread_data_t& td);
+  G4bool UpdateConfineGrid(thread_data_t& td);
   //Point,Plane,Surface,Volume
   G4String SourcePosType;
   //Circle,Square,Rectangle etc..
@@ -264,6 +296,8 @@ private:
   //If true confines source distribution to VolName
   G4bool Confine;
   G4String VolName;
+  G4int ConfineRevision;
+  G4int ConfineGridBins;
   // Verbosity
   G4int verbosityLevel;
   G4Cache<thread_data_t> ThreadData;
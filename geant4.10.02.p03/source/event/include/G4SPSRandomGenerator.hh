@@ -178,6 +178,9 @@ public:
 	G4double GenRandPosTheta();
 	G4double GenRandPosPhi();
 
+	// True if the x, y or z random numbers are biased
+	inline G4bool IsPositionBiased() const { return XBias || YBias || ZBias; }
+
     void SetIntensityWeight(G4double weight);
 
     G4double GetBiasWeight();
@@ -127,6 +127,8 @@
 #include "G4SPSRandomGenerator.hh"
 #include "G4Threading.hh"
 #include "G4Cache.hh"
+#include "CLHEP/Random/PhiloxEngine.h"
+#include <vector>
 
 /** Andrea Dotti Feb 2015
  * Important: This is a shared class between threads.
@@ -220,6 +222,35 @@ public:
 	}
 	;
 
+	// Pipelined generation: if the batch size is larger than 1, the
+	// positions, directions, energies and weights of the vertices of the
+	// next n events are sampled together and then served one vertex per
+	// event from a per-thread buffer. The distributions are then sampled
+	// in a tight loop, with the confinement navigator, histograms and
+	// random engine hot in the cache. It requires the per-event random
+	// streams of the run manager (/random/eventStreams): the vertex of
+	// event i+k is sampled from the stream of event i+k, at the position
+	// the stream of event i had reached, and it is used only if the engine
+	// is found in that very state at event i+k, after which the engine is
+	// moved past the numbers drawn for it. The primaries are thus the same
+	// as without buffering. Vertices of events processed by another thread
+	// are discarded, so that in multi-threaded mode the batch size should
+	// not exceed the event modulo (/run/eventModulo). Without per-event
+	// streams every vertex is sampled in its own event.
+	// 0 or 1 (default) means no buffering.
+	void SetPrimaryBatchSize(G4int n);
+	inline G4int GetPrimaryBatchSize() const {
+		return primaryBatchSize;
+	}
+	;
+	// Discard the pre-sampled primaries of all threads. This is done by
+	// the /gps/ commands; call it after changing the distributions with
+	// the set methods.
+	inline void FlushPrimaryBuffer() {
+		++bufferRevision;
+	}
+	;
+
 private:
 
 	G4SPSPosDistribution* posGenerator;
@@ -238,6 +269,33 @@ private:
 	  part_prop_t();
 	};
 	G4Cache<part_prop_t> ParticleProperties;
+
+	// Pre-sampled primaries of a thread, nParticles entries per vertex.
+	// startState is the state the engine must have when the vertex is
+	// used, endState the state after sampling it.
+	struct primary_buffer_t {
+	  std::vector<G4ThreeVector> position;
+	  std::vector<G4ParticleMomentum> direction;
+	  std::vector<G4double> energy;
+	  std::vector<G4double> weight;
+	  std::vector<std::vector<unsigned long> > startState;
+	  std::vector<std::vector<unsigned long> > endState;
+	  size_t nVertices;
+	  size_t next;
+	  G4int nParticles;
+	  G4int revision;
+	  const G4ParticleDefinition* definition;
+	  CLHEP::PhiloxEngine engine;
+	  primary_buffer_t();
+	};
+	G4bool FindBufferedVertex(primary_buffer_t& buffer,
+	                          const CLHEP::PhiloxEngine& eventEngine);
+	void FillPrimaryBuffer(primary_buffer_t& buffer,
+	                       const CLHEP::PhiloxEngine& eventEngine);
+	G4Cache<primary_buffer_t> PrimaryBuffer;
+	G4int primaryBatchSize;
+	G4int bufferRevision;
+
         G4int NumberOfParticlesToBeGenerated;
         G4ParticleDefinition * definition;
         G4double charge;
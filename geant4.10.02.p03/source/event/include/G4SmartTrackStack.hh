@@ -36,6 +36,7 @@
 
 #include "G4StackedTrack.hh"
 #include "G4TrackStack.hh"
+#include "G4VTrackStack.hh"
 #include "globals.hh"
 
 // class description:
@@ -43,7 +44,7 @@
 // This is a 'smart' stack class used by G4StackManager. This class object
 // stores G4StackedTrack class objects in various dedicated stacks
 
-class G4SmartTrackStack
+class G4SmartTrackStack : public G4VTrackStack
 {
   public:
       G4SmartTrackStack();
@@ -61,6 +62,7 @@ class G4SmartTrackStack
       void clear();
       void clearAndDestroy();
       void TransferTo(G4TrackStack* aStack);
+      void TransferFrom(G4TrackStack* aStack);
       G4double getEnergyOfStack(G4TrackStack* aTrackStack);
       void dumpStatistics();
 
@@ -36,7 +36,9 @@
 #include "G4UserStackingAction.hh"
 #include "G4StackedTrack.hh"
 #include "G4TrackStack.hh"
+#include "G4DefaultTrackStack.hh"
 #include "G4SmartTrackStack.hh"
+#include "G4VTrackStack.hh"
 #include "G4ClassificationOfNewTrack.hh"
 #include "G4Track.hh"
 #include "G4TrackStatus.hh"
@@ -44,6 +46,7 @@
 #include "evmandefs.hh"
 
 class G4StackingMessenger;
+class G4StackSpillFile;
 class G4VTrajectory;
 
 // class description:
@@ -106,20 +109,58 @@ class G4StackManager
       // If the destination is fKill, the track is deleted.
       // If the origin is fKill, nothing happen.
 
+      G4int ExtractFreshUrgentTracks(G4int nTracks, std::vector<G4Track*>& tracks);
+      //  Remove up to nTracks tracks from the urgent stack and append them to
+      // the given vector, which then owns them. Only tracks which have not
+      // made any step yet and have no trajectory are extracted, the others
+      // are left in the urgent stack. Tracks spilled to the scratch file are
+      // read back when the tracks in memory are exhausted. The number of
+      // extracted tracks is returned. Used by G4EventManager for sub-event
+      // parallelism.
+
+      void SetUrgentStack(G4VTrackStack* aStack);
+      //  Replace the urgent stack by the given one, which is then owned by
+      // this G4StackManager. Tracks already stacked are transferred.
+      // Available stacks are G4DefaultTrackStack, G4SmartTrackStack,
+      // G4CompactTrackStack and G4PriorityTrackStack, which are selected by
+      // /event/stack/urgentStack.
+      inline G4VTrackStack* GetUrgentStack() const
+      { return urgentStack; }
+
+      void SetSpillMemoryLimit(G4double limitInMB);
+      //  Set the memory, in MB, which may be used by the tracks of the
+      // urgent and waiting stacks. Beyond this limit the oldest tracks are
+      // written in blocks to a scratch file (see G4StackSpillFile) and read
+      // back when the tracks in memory are exhausted. 0 (default) means no
+      // limit. Tracks of the postponed and additional waiting stacks, and
+      // tracks of an urgent stack which is not a G4DefaultTrackStack, are never
+      // spilled. Set by /event/stack/spill/memoryLimit.
+      void SetSpillBlockSize(G4int nTracks);
+      //  Set the number of tracks written to or read from the scratch file
+      // at once (default 10000).
+      void SetSpillDirectory(const G4String& dirName);
+      //  Set the directory of the scratch file (default ".").
+      inline G4double GetSpillMemoryLimit() const
+      { return spillMemoryLimit; }
+      G4int GetNSpilledTrack() const;
+
   private:
       G4UserStackingAction * userStackingAction;
       G4int verboseLevel;
-#ifdef G4_USESMARTSTACK
-      G4SmartTrackStack * urgentStack;
-#else
-      G4TrackStack * urgentStack;
-#endif
+      G4VTrackStack * urgentStack;
       G4TrackStack * waitingStack;
       G4TrackStack * postponeStack;
       G4StackingMessenger* theMessenger;
       std::vector<G4TrackStack*> additionalWaitingStacks;
       G4int numberOfAdditionalWaitingStacks;
 
+      G4StackSpillFile* spillFile;
+      G4TrackStack* spillableUrgentStack;
+      G4double spillMemoryLimit;
+      G4int spillThreshold;
+      G4int spillBlockSize;
+      G4String spillDirectory;
+
   public:
       void clear();
       void ClearUrgentStack();
@@ -134,6 +175,8 @@ class G4StackManager
   
   private:
      G4ClassificationOfNewTrack DefaultClassification(G4Track *aTrack);
+     void CheckSpill();
+     G4int ReloadSpilledTracks(G4int index, G4bool all);
 };
 
 #endif
@@ -0,0 +1,133 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#ifndef G4StackSpillFile_h
+#define G4StackSpillFile_h 1
+
+#include "G4TrackStack.hh"
+#include "G4TouchableHandle.hh"
+#include "globals.hh"
+#include <vector>
+#include <fstream>
+
+class G4ParticleDefinition;
+class G4VProcess;
+
+// class description:
+//
+// This class is used by G4StackManager to move the oldest tracks of its
+// urgent and waiting stacks to a scratch file when the number of tracks
+// kept in memory exceeds the limit given by /event/stack/spill/memoryLimit.
+// Tracks are written in blocks of compact binary records holding their
+// kinematics, identifiers, creator process and particle definition. The
+// touchable handles are kept in memory with the block, and tracks which
+// cannot be rebuilt from these values (see G4CompactTrackStack::
+// IsCompactable()), e.g. tracks with user information or a trajectory,
+// are kept in memory as they are. A block is read back at the bottom of
+// its stack, so that the last-in-first-out order of the tracks does not
+// change. The file is removed when this object is deleted.
+
+struct G4StackSpillRecord
+{
+  G4double position[3];
+  G4double direction[3];
+  G4double kineticEnergy;
+  G4double globalTime;
+  G4double localTime;
+  G4double weight;
+  const G4ParticleDefinition* particle;  // 0 : index in the kept tracks
+  const G4VProcess* creatorProcess;
+  G4int trackID;
+  G4int parentID;
+  G4int creatorModel;
+  G4int flags;
+};
+
+class G4StackSpillFile
+{
+  public:
+      G4StackSpillFile(const G4String& dirName = ".");
+      ~G4StackSpillFile();
+
+  private:
+      G4StackSpillFile(const G4StackSpillFile&);
+      G4StackSpillFile& operator=(const G4StackSpillFile&);
+
+  public: // with description
+      enum { urgentIndex = 0, waitingIndex = 1, nStacks = 2 };
+
+      G4int Spill(G4TrackStack* aStack, G4int nTracks, G4int index);
+      //  Move the nTracks oldest tracks of aStack to a new block of the
+      // given stack index. Returns the number of spilled tracks, which is
+      // 0 if the scratch file cannot be written.
+      G4int Reload(G4TrackStack* aStack, G4int index, G4bool all = false);
+      //  Read back the most recent block (or all blocks) of the given
+      // stack index, below the tracks already in aStack. Returns the
+      // number of reloaded tracks.
+      void MoveBlocks(G4int from, G4int to);
+      //  Append the blocks of stack index "from" to those of "to". Used
+      // when the waiting stack is transferred to an empty urgent stack.
+      void Clear(G4int index);
+      //  Delete the spilled tracks of the given stack index.
+
+      inline G4int GetNTrack(G4int index) const
+      { return nSpilled[index]; }
+      inline G4int GetNBlock(G4int index) const
+      { return G4int(blocks[index].size()); }
+      inline G4int GetMaxNTrack() const
+      { return maxNSpilled; }
+      inline const G4String& GetFileName() const
+      { return fileName; }
+
+  private:
+      struct Block
+      {
+        std::streamoff offset;
+        G4int nRecords;
+        std::vector<G4TouchableHandle> touchables;
+        std::vector<G4StackedTrack> keptTracks;
+      };
+
+      G4bool Open();
+      void ReadBlock(Block& aBlock, std::vector<G4StackedTrack>& tracks);
+      void ReleaseSpace();
+
+  private:
+      G4String fileName;
+      std::fstream file;
+      G4bool isOpen;
+      G4bool isBroken;
+      std::streamoff fileEnd;
+      std::vector<Block> blocks[nStacks];
+      G4int nSpilled[nStacks];
+      G4int maxNSpilled;
+      std::vector<G4StackSpillRecord> buffer;
+};
+
+#endif
@@ -35,6 +35,9 @@ class G4StackManager;
 class G4UIdirectory;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcommand;
 
 // class description:
 //
@@ -44,6 +47,17 @@ class G4UIcmdWithAnInteger;
 //   /event/stack/status
 //   /event/stack/clear
 //   /event/stack/verbose
+//   /event/stack/urgentStack
+//   /event/stack/priority/
+//   /event/stack/priority/addBucket
+//   /event/stack/priority/energyBuckets
+//   /event/stack/priority/defaultPriority
+//   /event/stack/priority/clearBuckets
+//   /event/stack/priority/list
+//   /event/stack/spill/
+//   /event/stack/spill/memoryLimit
+//   /event/stack/spill/blockSize
+//   /event/stack/spill/directory
 
 class G4StackingMessenger: public G4UImessenger
 {
@@ -57,6 +71,17 @@ class G4StackingMessenger: public G4UImessenger
     G4UIcmdWithoutParameter* statusCmd;
     G4UIcmdWithAnInteger* clearCmd;
     G4UIcmdWithAnInteger* verboseCmd;
+    G4UIcmdWithAString* urgentStackCmd;
+    G4UIdirectory* priorityDir;
+    G4UIcommand* addBucketCmd;
+    G4UIcommand* energyBucketsCmd;
+    G4UIcmdWithAnInteger* defaultPriorityCmd;
+    G4UIcmdWithoutParameter* clearBucketsCmd;
+    G4UIcmdWithoutParameter* listBucketsCmd;
+    G4UIdirectory* spillDir;
+    G4UIcmdWithADouble* spillLimitCmd;
+    G4UIcmdWithAnInteger* spillBlockCmd;
+    G4UIcmdWithAString* spillDirCmd;
 };
 
 #endif
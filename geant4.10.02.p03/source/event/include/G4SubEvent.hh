@@ -0,0 +1,146 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#ifndef G4SubEvent_h
+#define G4SubEvent_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+#include <vector>
+#include <atomic>
+
+class G4Track;
+class G4Event;
+class G4ParticleDefinition;
+class G4VProcess;
+
+// class description:
+//
+//  A G4SubEvent is a bundle of tracks taken from the urgent stack of an
+// event, which can be transported by another worker thread than the one
+// processing the event itself (sub-event parallelism, see G4SubEventQueue).
+//  Tracks are stored by value, i.e. without any G4Track, G4DynamicParticle
+// or process object of the thread which created the bundle, so that the
+// thread transporting the bundle creates its own G4Track objects.
+// G4VUserTrackInformation attached to the original tracks is not carried.
+// The creator process is stored as its particle and its index in the
+// process list of that particle, and resolved once per bundle through the
+// process manager of the thread transporting the bundle.
+//  Track IDs of the secondaries created by the helper thread are taken
+// in blocks from a counter shared with the owner thread of the event.
+//  Once transported, the G4Event object used by the helper thread keeps
+// the hits collections of the bundle until they are merged to the event
+// of the owner thread by G4EventManager.
+
+class G4SubEvent
+{
+  public:
+      enum SubEventState { fQueued, fProcessing, fDone, fMerged };
+
+  public:
+      G4SubEvent(G4int evID, G4int ownerID, std::atomic<G4int>* trackIDs);
+      ~G4SubEvent();
+
+  private:
+      G4SubEvent(const G4SubEvent&) = delete;
+      G4SubEvent& operator=(const G4SubEvent&) = delete;
+
+  public:
+      void AddTrack(const G4Track* aTrack);
+      //  Stores the kinematics of a track which has not been transported yet.
+      G4Track* CreateTrack(size_t i) const;
+      //  Creates a new G4Track for the i-th stored track in the calling thread.
+
+      inline size_t GetNumberOfTracks() const
+      { return tracks.size(); }
+      inline G4int GetEventID() const
+      { return eventID; }
+      inline G4int GetOwnerID() const
+      { return ownerID; }
+      inline std::atomic<G4int>* GetTrackIDSource() const
+      { return trackIDSource; }
+      //  Next free track ID of the event, owned by the owner thread.
+      inline void SetSeeds(long s1, long s2)
+      { seeds[0] = s1; seeds[1] = s2; }
+      inline const long* GetSeeds() const
+      { return seeds; }
+
+      inline SubEventState GetState() const
+      { return state; }
+      inline void SetState(SubEventState val)
+      { state = val; }
+      //  The state is modified only under the lock of G4SubEventQueue.
+
+      inline G4Event* GetResult() const
+      { return result; }
+      inline void SetResult(G4Event* evt)
+      { result = evt; }
+      //  G4Event object of the helper thread. It is owned and deleted
+      // by the helper thread once the sub-event is merged.
+
+  private:
+      struct TrackData
+      {
+        const G4ParticleDefinition* particle;
+        G4ThreeVector position;
+        G4ThreeVector momentumDirection;
+        G4ThreeVector polarization;
+        G4double kineticEnergy;
+        G4double charge;
+        G4double globalTime;
+        G4double localTime;
+        G4double properTime;
+        G4double weight;
+        G4int trackID;
+        G4int parentID;
+        G4int creatorIndex;   // in creators, -1 for primaries
+      };
+
+      struct CreatorData
+      {
+        const G4VProcess* process;   // of the owner thread
+        const G4ParticleDefinition* particle;
+        G4int processIndex;
+      };
+
+      G4int GetCreatorIndex(const G4VProcess* creator);
+      void ResolveCreators() const;
+
+      std::vector<TrackData> tracks;
+      std::vector<CreatorData> creators;
+      mutable std::vector<G4VProcess*> resolvedCreators;
+      //  Process objects of the thread calling CreateTrack().
+      G4int eventID;
+      G4int ownerID;
+      std::atomic<G4int>* trackIDSource;
+      long seeds[3];
+      SubEventState state;
+      G4Event* result;
+};
+
+#endif
@@ -0,0 +1,115 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#ifndef G4SubEventQueue_h
+#define G4SubEventQueue_h 1
+
+#include "globals.hh"
+#include "G4Threading.hh"
+#include "G4SubEvent.hh"
+#include <deque>
+#include <condition_variable>
+
+// class description:
+//
+//  Shared (not thread-local) queue of G4SubEvent objects, used for
+// sub-event parallelism in multi-threaded mode.
+//  When the bundle size is set to a positive value, a worker thread
+// processing an event moves bundles of tracks from its urgent stack to
+// this queue whenever the urgent stack holds more than the given minimum
+// number of tracks. Worker threads which have no more event to process
+// wait on this queue, until the last worker has left its event loop, and
+// transport the bundles pushed meanwhile. At the end of the event, the
+// owner thread takes back the bundles which have not been started yet,
+// waits for the others and merges their hits collections to its own
+// G4HCofThisEvent before the user's EndOfEventAction is invoked.
+//  The helper thread invokes the user's BeginOfEventAction with the
+// G4Event of the bundle, but not EndOfEventAction: only hits collections
+// are merged, quantities accumulated by the user actions of the helper
+// thread are not added to the event.
+//  The mode is controlled by the /event/subEvent/ UI commands.
+
+class G4SubEventQueue
+{
+  public: // with description
+      static G4SubEventQueue* GetInstance();
+
+      void SetBundleSize(G4int val);
+      G4int GetBundleSize() const
+      { return bundleSize; }
+      //  Number of tracks in a bundle. Zero (default) disables the mode.
+      void SetMinimumUrgentTracks(G4int val);
+      G4int GetMinimumUrgentTracks() const
+      { return minUrgentTracks; }
+      //  Bundles are exported only while the urgent stack holds more
+      // tracks than this number.
+      G4bool IsEnabled() const;
+
+  public:
+      void BeginRun(G4int nWorkers);
+      //  Invoked by the master before the worker threads start their
+      // event loop, with the number of worker threads.
+      void LeaveEventLoop();
+      //  Invoked by each worker thread once it has no more event to
+      // process.
+
+      void Push(G4SubEvent* se);
+      G4SubEvent* WaitForSubEvent();
+      //  Takes the oldest queued sub-event and marks it as being processed,
+      // blocking until one is pushed. Null is returned once all worker
+      // threads have left their event loop and no event is processed
+      // with sub-event parallelism any more.
+      G4bool Reclaim(G4SubEvent* se);
+      //  Removes a sub-event from the queue if it has not been started.
+      void WaitWhileProcessing(const G4SubEvent* se);
+      //  Blocks until the sub-event has been transported.
+      void SetDone(G4SubEvent* se);
+      void SetMerged(G4SubEvent* se);
+      G4SubEvent::SubEventState GetState(const G4SubEvent* se);
+
+      void BeginEvent();
+      void EndEvent();
+      //  Number of events currently processed with sub-event parallelism.
+
+  private:
+      G4SubEventQueue();
+      ~G4SubEventQueue();
+      G4SubEventQueue(const G4SubEventQueue&) = delete;
+      G4SubEventQueue& operator=(const G4SubEventQueue&) = delete;
+
+  private:
+      G4Mutex mutex;
+      std::condition_variable_any changed;
+      std::deque<G4SubEvent*> queue;
+      G4int bundleSize;
+      G4int minUrgentTracks;
+      G4int nActiveEvents;
+      G4int nWorkersInEventLoop;
+};
+
+#endif
@@ -38,7 +38,7 @@
 #include "G4Types.hh"
 #include <vector>
 
-class G4SmartTrackStack;
+class G4VTrackStack;
 
 // class description:
 //
@@ -62,7 +62,7 @@ public:
 	void PushToStack(const G4StackedTrack& aStackedTrack) { push_back(aStackedTrack); }
 	G4StackedTrack PopFromStack() { G4StackedTrack st = back(); pop_back(); return st; }
 	void TransferTo(G4TrackStack* aStack);
-	void TransferTo(G4SmartTrackStack* aStack);
+	void TransferTo(G4VTrackStack* aStack);
   
         void clearAndDestroy();
 private:
@@ -0,0 +1,170 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#ifndef G4TrajectoryStore_h
+#define G4TrajectoryStore_h 1
+
+#include "globals.hh"
+#include "evmandefs.hh"
+#include <fstream>
+#include <set>
+
+class G4VTrajectory;
+class G4CompactTrajectory;
+class G4Track;
+class G4TrajectoryContainer;
+class G4TrajectoryStoreMessenger;
+
+// class description:
+//
+//  This class limits the memory taken by the trajectories of an event.
+// It is owned by G4EventManager, which passes to Process() each
+// trajectory of a completed track before it is stored in the
+// G4TrajectoryContainer of the event. Depending on the settings
+// (commands in /event/trajectory/), the trajectory is
+//   1) dropped if its particle or the kinetic energy of the track at
+//      its vertex do not pass the filters,
+//   2) replaced by a G4CompactTrajectory (collinear points removed,
+//      positions quantised),
+//   3) written to a file instead of being kept in memory, either always
+//      or only once the memory budget of the event is exhausted,
+//   4) dropped once the memory budget of the event is exhausted, if it
+//      is not written to a file.
+// The store is inactive (trajectories are kept untouched) unless one of
+// these options is set.
+//  Files are written per thread (the name is suffixed by ".t<thread ID>"
+// for worker threads) with the native byte order. After a header made
+// of the characters "G4TRAJST" and of the G4int version, each trajectory
+// is a G4TrajectoryStoreRecord followed by the nameLength characters of
+// the particle name and by 3*nPoints G4int quantised coordinates (see
+// G4CompactTrajectory). Read() restores the trajectories of an event.
+
+struct G4TrajectoryStoreRecord
+{
+  G4int eventID;
+  G4int trackID;
+  G4int parentID;
+  G4int pdgEncoding;
+  G4int nPoints;
+  G4int nameLength;
+  G4double charge;
+  G4double quantum;
+  G4double origin[3];
+  G4double initialMomentum[3];
+};
+
+class G4TrajectoryStore
+{
+  public:
+    enum StreamMode { streamNone = 0, streamOverflow, streamAll };
+
+  public: // with description
+    G4TrajectoryStore();
+    ~G4TrajectoryStore();
+
+    G4VTrajectory* Process(G4VTrajectory* aTrajectory, const G4Track* aTrack,
+                           G4int eventID);
+    //  Returns the trajectory to be stored in the event, which may differ
+    // from aTrajectory, or null if the trajectory was dropped or written.
+    // In both cases aTrajectory is deleted.
+    void EndOfEvent(G4int eventID);
+    //  Prints a summary (verbose level > 0) and resets the budget
+
+    static G4int Read(const G4String& fileName, G4int eventID,
+                      G4TrajectoryContainer* container);
+    //  Appends to container the trajectories of the given event (all
+    // events if eventID < 0) read from a file written by this class.
+    // Returns the number of trajectories read.
+
+  public:
+    inline G4bool IsActive() const
+    { return active; }
+
+    void SetMemoryBudget(G4double megaBytes);
+    //  Per event and per thread. Zero means no limit.
+    inline G4double GetMemoryBudget() const
+    { return memoryBudget/1048576.; }
+    void SetMinKineticEnergy(G4double energy);
+    inline G4double GetMinKineticEnergy() const
+    { return minKineticEnergy; }
+    void KeepParticle(const G4String& particleName);
+    //  If any particle is kept, the trajectories of the other ones are dropped
+    void DropParticle(const G4String& particleName);
+    void ClearFilters();
+    void SetCompaction(G4bool val);
+    inline G4bool GetCompaction() const
+    { return compaction; }
+    void SetTolerance(G4double length);
+    inline G4double GetTolerance() const
+    { return tolerance; }
+    void SetQuantum(G4double length);
+    inline G4double GetQuantum() const
+    { return quantum; }
+    void SetStreamMode(StreamMode mode);
+    inline StreamMode GetStreamMode() const
+    { return streamMode; }
+    void SetOutputFile(const G4String& fileName);
+    inline const G4String& GetOutputFile() const
+    { return outputFile; }
+    inline void SetVerboseLevel(G4int value)
+    { verboseLevel = value; }
+    inline G4int GetVerboseLevel() const
+    { return verboseLevel; }
+
+  private:
+    void UpdateActive();
+    G4bool Accept(const G4VTrajectory* aTrajectory, const G4Track* aTrack) const;
+    G4CompactTrajectory* Compact(G4VTrajectory*& aTrajectory);
+    G4bool Write(const G4CompactTrajectory* aTrajectory, G4int eventID);
+    G4bool OpenFile();
+
+  private:
+    G4TrajectoryStoreMessenger* messenger;
+    G4bool active;
+    G4double memoryBudget;  // bytes
+    G4double minKineticEnergy;
+    std::set<G4String> keptParticles;
+    std::set<G4String> droppedParticles;
+    G4bool compaction;
+    G4double tolerance;
+    G4double quantum;
+    StreamMode streamMode;
+    G4String outputFile;
+    G4String openedFile;
+    std::ofstream file;
+    G4int verboseLevel;
+
+    // Counters of the current event
+    G4double usedMemory;
+    G4int nKept;
+    G4int nFiltered;
+    G4int nWritten;
+    G4int nOverBudget;
+};
+
+#endif
@@ -0,0 +1,82 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#ifndef G4TrajectoryStoreMessenger_h
+#define G4TrajectoryStoreMessenger_h 1
+
+#include "G4UImessenger.hh"
+class G4TrajectoryStore;
+class G4UIdirectory;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+
+// class description:
+//
+//  This is a concrete class of G4UImessenger which handles the commands
+// for G4TrajectoryStore. It has the following commands:
+//   /event/trajectory/
+//   /event/trajectory/memoryBudget
+//   /event/trajectory/minEnergy
+//   /event/trajectory/keepParticle
+//   /event/trajectory/dropParticle
+//   /event/trajectory/clearFilters
+//   /event/trajectory/compact
+//   /event/trajectory/tolerance
+//   /event/trajectory/quantum
+//   /event/trajectory/stream
+//   /event/trajectory/file
+//   /event/trajectory/verbose
+
+class G4TrajectoryStoreMessenger: public G4UImessenger
+{
+  public:
+    G4TrajectoryStoreMessenger(G4TrajectoryStore* store);
+    ~G4TrajectoryStoreMessenger();
+    void SetNewValue(G4UIcommand * command,G4String newValues);
+    G4String GetCurrentValue(G4UIcommand * command);
+  private:
+    G4TrajectoryStore* fStore;
+    G4UIdirectory* trajDir;
+    G4UIcmdWithADouble* budgetCmd;
+    G4UIcmdWithADoubleAndUnit* minEnergyCmd;
+    G4UIcmdWithAString* keepParticleCmd;
+    G4UIcmdWithAString* dropParticleCmd;
+    G4UIcmdWithoutParameter* clearFiltersCmd;
+    G4UIcmdWithABool* compactCmd;
+    G4UIcmdWithADoubleAndUnit* toleranceCmd;
+    G4UIcmdWithADoubleAndUnit* quantumCmd;
+    G4UIcmdWithAString* streamCmd;
+    G4UIcmdWithAString* fileCmd;
+    G4UIcmdWithAnInteger* verboseCmd;
+};
+
+#endif
@@ -0,0 +1,65 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#ifndef G4VTrackStack_h
+#define G4VTrackStack_h 1
+
+#include "G4StackedTrack.hh"
+#include "G4Types.hh"
+
+class G4TrackStack;
+
+// class description:
+//
+// This is the abstract base class of the stacks which can be used as the
+// urgent stack of G4StackManager (see G4StackManager::SetUrgentStack()).
+// Tracks are pushed and popped as G4StackedTrack objects. A concrete stack
+// may store them in any form, e.g. ordered by priority (G4SmartTrackStack)
+// or in compact arrays (G4CompactTrackStack), provided that the G4Track
+// given back by PopFromStack() is equivalent to the one pushed.
+// TransferFrom() receives all the tracks of an ordinary G4TrackStack, which
+// is left empty. The default implementation pushes them in their order.
+
+class G4VTrackStack
+{
+  public:
+      G4VTrackStack() {}
+      virtual ~G4VTrackStack() {}
+
+  public: // with description
+      virtual void PushToStack(const G4StackedTrack& aStackedTrack) = 0;
+      virtual G4StackedTrack PopFromStack() = 0;
+      virtual void TransferTo(G4TrackStack* aStack) = 0;
+      virtual void TransferFrom(G4TrackStack* aStack);
+      virtual void clearAndDestroy() = 0;
+      virtual G4int GetNTrack() const = 0;
+      virtual G4int GetMaxNTrack() const = 0;
+};
+
+#endif
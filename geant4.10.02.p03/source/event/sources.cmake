@@ -54,7 +54,10 @@ GEANT4_DEFINE_MODULE(NAME G4event
         G4AdjointPosOnPhysVolGenerator.hh
         G4AdjointPrimaryGenerator.hh
         G4AdjointStackingAction.hh
+        G4BinaryEventInterface.hh
         G4ClassificationOfNewTrack.hh
+        G4CompactTrackStack.hh
+        G4DefaultTrackStack.hh
         G4EvManMessenger.hh
         G4Event.hh
         G4EventManager.hh
@@ -65,6 +68,7 @@ GEANT4_DEFINE_MODULE(NAME G4event
         G4ParticleGun.hh
         G4ParticleGunMessenger.hh
         G4PrimaryTransformer.hh
+        G4PriorityTrackStack.hh
         G4RayShooter.hh
         G4SPSAngDistribution.hh
         G4SPSEneDistribution.hh
@@ -74,13 +78,19 @@ GEANT4_DEFINE_MODULE(NAME G4event
         G4SmartTrackStack.hh
         G4StackChecker.hh
         G4StackManager.hh
+        G4StackSpillFile.hh
         G4StackedTrack.hh
         G4StackingMessenger.hh
+        G4SubEvent.hh
+        G4SubEventQueue.hh
         G4TrackStack.hh
         G4TrajectoryContainer.hh
+        G4TrajectoryStore.hh
+        G4TrajectoryStoreMessenger.hh
         G4UserEventAction.hh
         G4UserStackingAction.hh
         G4VPrimaryGenerator.hh
+        G4VTrackStack.hh
         G4VUserEventInformation.hh
         eventgendefs.hh
         evmandefs.hh
@@ -91,6 +101,8 @@ GEANT4_DEFINE_MODULE(NAME G4event
         G4AdjointPosOnPhysVolGenerator.cc
         G4AdjointPrimaryGenerator.cc
         G4AdjointStackingAction.cc
+        G4BinaryEventInterface.cc
+        G4CompactTrackStack.cc
         G4EvManMessenger.cc
         G4Event.cc
         G4EventManager.cc
@@ -101,6 +113,7 @@ GEANT4_DEFINE_MODULE(NAME G4event
         G4ParticleGun.cc
         G4ParticleGunMessenger.cc
         G4PrimaryTransformer.cc
+        G4PriorityTrackStack.cc
         G4RayShooter.cc
         G4SPSAngDistribution.cc
         G4SPSEneDistribution.cc
@@ -110,12 +123,18 @@ GEANT4_DEFINE_MODULE(NAME G4event
         G4SmartTrackStack.cc
         G4StackChecker.cc
         G4StackManager.cc
+        G4StackSpillFile.cc
         G4StackingMessenger.cc
+        G4SubEvent.cc
+        G4SubEventQueue.cc
         G4TrackStack.cc
         G4TrajectoryContainer.cc
+        G4TrajectoryStore.cc
+        G4TrajectoryStoreMessenger.cc
         G4UserEventAction.cc
         G4UserStackingAction.cc
         G4VPrimaryGenerator.cc
+        G4VTrackStack.cc
 	G4GeneralParticleSourceData.cc
     GRANULAR_DEPENDENCIES
         G4baryons
@@ -0,0 +1,379 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#include "G4BinaryEventInterface.hh"
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
+#include "G4ios.hh"
+#include <cstring>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  const char binaryEventMagic[8] = { 'G','4','E','V','T','B','I','N' };
+  const G4int binaryEventVersion = 1;
+  const G4int binaryEventByteOrder = 0x01020304;
+}
+
+G4BinaryEventInterface::G4BinaryEventInterface(const G4String& evfile, G4int vl)
+  : fileName(evfile), vLevel(vl), firstEvent(0), nEvents(0),
+    data(0), dataSize(0), recordsEnd(0), isMapped(false), eventIndex(0)
+{
+  G4ThreeVector zero;
+  particle_position = zero;
+  particle_time = 0.0;
+  Map();
+}
+
+G4BinaryEventInterface::~G4BinaryEventInterface()
+{
+  Unmap();
+}
+
+void G4BinaryEventInterface::Map()
+{
+#ifndef WIN32
+  int fd = open(fileName.c_str(),O_RDONLY);
+  struct stat st;
+  if(fd >= 0 && fstat(fd,&st) == 0 && st.st_size > 0)
+  {
+    void* p = mmap(0,size_t(st.st_size),PROT_READ,MAP_SHARED,fd,0);
+    if(p != MAP_FAILED)
+    {
+      data = static_cast<const char*>(p);
+      dataSize = size_t(st.st_size);
+      isMapped = true;
+    }
+  }
+  if(fd >= 0) close(fd);
+#endif
+  if(!data)
+  {
+    // Read the whole file where it cannot be mapped
+    std::ifstream in(fileName.c_str(),std::ios::binary);
+    if(in)
+    {
+      in.seekg(0,std::ios::end);
+      fileContent.resize(size_t(in.tellg()));
+      in.seekg(0,std::ios::beg);
+      if(!fileContent.empty()) in.read(&fileContent[0],fileContent.size());
+      if(in && !fileContent.empty())
+      {
+        data = &fileContent[0];
+        dataSize = fileContent.size();
+      }
+    }
+  }
+  if(!data)
+  {
+    G4ExceptionDescription ED;
+    ED << "Cannot open binary event file <" << fileName << ">.";
+    G4Exception("G4BinaryEventInterface::G4BinaryEventInterface","Event0241",
+                FatalException,ED);
+    return;
+  }
+
+  // Check the header and the index
+  G4BinaryEventHeader header;
+  G4bool valid = dataSize >= sizeof(header);
+  if(valid)
+  {
+    std::memcpy(&header,data,sizeof(header));
+    valid = std::memcmp(header.magic,binaryEventMagic,8) == 0
+         && header.version == binaryEventVersion
+         && header.byteOrder == binaryEventByteOrder
+         && header.nEvents >= 0
+         && header.indexOffset >= int64_t(sizeof(header))
+         && header.indexOffset % sizeof(int64_t) == 0
+         && uint64_t(header.indexOffset) + uint64_t(header.nEvents)*sizeof(int64_t)
+            <= uint64_t(dataSize);
+  }
+  if(valid)
+  {
+    nEvents = header.nEvents;
+    eventIndex = reinterpret_cast<const int64_t*>(data + header.indexOffset);
+    for(G4int i=0; i<nEvents && valid; i++)
+    {
+      valid = eventIndex[i] >= int64_t(sizeof(header))
+           && eventIndex[i] % sizeof(G4double) == 0
+           && eventIndex[i] + int64_t(sizeof(G4BinaryEventRecord)) <= header.indexOffset;
+    }
+  }
+  if(!valid)
+  {
+    G4ExceptionDescription ED;
+    ED << "<" << fileName << "> is not a binary event file of version "
+       << binaryEventVersion << " written on a machine of the same byte order.";
+    G4Exception("G4BinaryEventInterface::G4BinaryEventInterface","Event0242",
+                FatalException,ED);
+    nEvents = 0;
+    return;
+  }
+  // Records must stop at the index
+  recordsEnd = size_t(header.indexOffset);
+
+  if(vLevel > 0)
+  {
+    G4cout << "G4BinaryEventInterface - " << fileName << " is "
+           << (isMapped ? "mapped" : "read") << ", " << nEvents
+           << " events." << G4endl;
+  }
+}
+
+void G4BinaryEventInterface::Unmap()
+{
+#ifndef WIN32
+  if(isMapped)
+  {
+    munmap(const_cast<char*>(data),dataSize);
+  }
+#endif
+  isMapped = false;
+  data = 0;
+  fileContent.clear();
+}
+
+G4PrimaryParticle* G4BinaryEventInterface::MakeParticle(const G4BinaryParticleRecord& rec)
+{
+  const G4ParticleDefinition* pd = 0;
+  std::map<G4int,const G4ParticleDefinition*>::const_iterator it
+    = definitions.find(rec.pdgCode);
+  if(it != definitions.end())
+  { pd = it->second; }
+  else
+  {
+    pd = G4ParticleTable::GetParticleTable()->FindParticle(rec.pdgCode);
+    if(!pd && std::abs(rec.pdgCode) >= 1000000000)
+    { pd = G4IonTable::GetIonTable()->GetIon(rec.pdgCode); }
+    definitions[rec.pdgCode] = pd;
+  }
+
+  G4PrimaryParticle* particle = pd ? new G4PrimaryParticle(pd)
+                                   : new G4PrimaryParticle(rec.pdgCode);
+  if(rec.mass >= 0.) particle->SetMass(rec.mass);
+  particle->SetMomentum(rec.momentum[0],rec.momentum[1],rec.momentum[2]);
+  particle->SetPolarization(rec.polarization[0],rec.polarization[1],
+                            rec.polarization[2]);
+  particle->SetWeight(rec.weight);
+  return particle;
+}
+
+void G4BinaryEventInterface::GeneratePrimaryVertex(G4Event* evt)
+{
+  G4int iEvent = firstEvent + evt->GetEventID();
+  if(iEvent < 0 || iEvent >= nEvents)
+  {
+    G4ExceptionDescription ED;
+    ED << "Event " << iEvent << " is not in binary event file <" << fileName
+       << "> of " << nEvents << " events.";
+    G4Exception("G4BinaryEventInterface::GeneratePrimaryVertex","Event0243",
+                JustWarning,ED);
+    return;
+  }
+
+  const char* p = data + eventIndex[iEvent];
+  const char* end = data + recordsEnd;
+  const G4BinaryEventRecord* eventRec
+    = reinterpret_cast<const G4BinaryEventRecord*>(p);
+  p += sizeof(G4BinaryEventRecord);
+  if(vLevel > 0)
+  {
+    G4cout << "G4BinaryEventInterface - reading event " << iEvent << " : "
+           << eventRec->nVertices << " vertices, " << eventRec->nParticles
+           << " particles." << G4endl;
+  }
+
+  for(G4int iv=0; iv<eventRec->nVertices; iv++)
+  {
+    const G4BinaryVertexRecord* vertexRec
+      = reinterpret_cast<const G4BinaryVertexRecord*>(p);
+    if(p + sizeof(G4BinaryVertexRecord) > end || vertexRec->nParticles < 0
+       || size_t(end-p-sizeof(G4BinaryVertexRecord))
+          < size_t(vertexRec->nParticles)*sizeof(G4BinaryParticleRecord))
+    {
+      G4ExceptionDescription ED;
+      ED << "Event " << iEvent << " of <" << fileName << "> is truncated.";
+      G4Exception("G4BinaryEventInterface::GeneratePrimaryVertex","Event0242",
+                  FatalException,ED);
+      return;
+    }
+    p += sizeof(G4BinaryVertexRecord);
+
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(
+      G4ThreeVector(vertexRec->position[0],vertexRec->position[1],
+                    vertexRec->position[2]),vertexRec->time);
+    vertex->SetWeight(vertexRec->weight);
+    vertexParticles.resize(vertexRec->nParticles);
+    for(G4int ip=0; ip<vertexRec->nParticles; ip++)
+    {
+      const G4BinaryParticleRecord& rec
+        = *reinterpret_cast<const G4BinaryParticleRecord*>(p);
+      p += sizeof(G4BinaryParticleRecord);
+      G4PrimaryParticle* particle = MakeParticle(rec);
+      vertexParticles[ip] = particle;
+      if(rec.parent < 0)
+      { vertex->SetPrimary(particle); }
+      else if(rec.parent < ip)
+      { vertexParticles[rec.parent]->SetDaughter(particle); }
+      else
+      {
+        G4ExceptionDescription ED;
+        ED << "Particle " << ip << " of event " << iEvent << " of <"
+           << fileName << "> has an invalid parent index " << rec.parent << ".";
+        G4Exception("G4BinaryEventInterface::GeneratePrimaryVertex","Event0242",
+                    FatalException,ED);
+        delete particle;
+      }
+    }
+    evt->AddPrimaryVertex(vertex);
+  }
+}
+
+G4BinaryEventWriter::G4BinaryEventWriter(const G4String& evfile)
+  : fileName(evfile), vertexFirst(0)
+{
+  file.open(fileName.c_str(),std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!file)
+  {
+    G4ExceptionDescription ED;
+    ED << "Cannot open binary event file <" << fileName << "> for writing.";
+    G4Exception("G4BinaryEventWriter::G4BinaryEventWriter","Event0241",
+                FatalException,ED);
+    return;
+  }
+  // The header is written again by Close()
+  G4BinaryEventHeader header;
+  std::memset(&header,0,sizeof(header));
+  file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+}
+
+G4BinaryEventWriter::~G4BinaryEventWriter()
+{
+  Close();
+}
+
+void G4BinaryEventWriter::AddParticles(const G4PrimaryParticle* first, G4int parent)
+{
+  // Depth first, so that a parent always precedes its daughters
+  for(const G4PrimaryParticle* pp = first; pp; pp = pp->GetNext())
+  {
+    G4BinaryParticleRecord rec;
+    G4ThreeVector mom = pp->GetMomentum();
+    G4ThreeVector pol = pp->GetPolarization();
+    for(G4int j=0; j<3; j++)
+    {
+      rec.momentum[j] = mom[j];
+      rec.polarization[j] = pol[j];
+    }
+    rec.mass = pp->GetMass();
+    rec.weight = pp->GetWeight();
+    rec.pdgCode = pp->GetPDGcode();
+    rec.parent = parent;
+    particles.push_back(rec);
+    if(pp->GetDaughter())
+    { AddParticles(pp->GetDaughter(),G4int(particles.size()-1-vertexFirst)); }
+  }
+}
+
+G4bool G4BinaryEventWriter::Write(const G4Event* evt)
+{
+  if(!file.is_open()) return false;
+  offsets.push_back(int64_t(file.tellp()));
+
+  G4BinaryEventRecord eventRec;
+  eventRec.nVertices = evt->GetNumberOfPrimaryVertex();
+  eventRec.nParticles = 0;
+  std::vector<G4BinaryVertexRecord> vertexRecs(eventRec.nVertices);
+  std::vector<size_t> firstParticle(eventRec.nVertices+1);
+  particles.clear();
+  G4int iv = 0;
+  for(const G4PrimaryVertex* vertex = evt->GetPrimaryVertex(); vertex;
+      vertex = vertex->GetNext(), iv++)
+  {
+    G4BinaryVertexRecord& vr = vertexRecs[iv];
+    G4ThreeVector pos = vertex->GetPosition();
+    for(G4int j=0; j<3; j++) vr.position[j] = pos[j];
+    vr.time = vertex->GetT0();
+    vr.weight = vertex->GetWeight();
+    vr.reserved = 0;
+    firstParticle[iv] = particles.size();
+    vertexFirst = particles.size();
+    AddParticles(vertex->GetPrimary(),-1);
+    vr.nParticles = G4int(particles.size() - firstParticle[iv]);
+  }
+  firstParticle[iv] = particles.size();
+  eventRec.nParticles = G4int(particles.size());
+
+  file.write(reinterpret_cast<const char*>(&eventRec),sizeof(eventRec));
+  for(G4int i=0; i<eventRec.nVertices; i++)
+  {
+    file.write(reinterpret_cast<const char*>(&vertexRecs[i]),sizeof(G4BinaryVertexRecord));
+    if(vertexRecs[i].nParticles > 0)
+    {
+      file.write(reinterpret_cast<const char*>(&particles[firstParticle[i]]),
+                 vertexRecs[i].nParticles*sizeof(G4BinaryParticleRecord));
+    }
+  }
+  return file.good();
+}
+
+void G4BinaryEventWriter::Close()
+{
+  if(!file.is_open()) return;
+  G4BinaryEventHeader header;
+  std::memset(&header,0,sizeof(header));
+  std::memcpy(header.magic,binaryEventMagic,8);
+  header.version = binaryEventVersion;
+  header.byteOrder = binaryEventByteOrder;
+  header.nEvents = G4int(offsets.size());
+  header.indexOffset = int64_t(file.tellp());
+  if(!offsets.empty())
+  {
+    file.write(reinterpret_cast<const char*>(&offsets[0]),
+               offsets.size()*sizeof(int64_t));
+  }
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+  if(!file.good())
+  {
+    G4ExceptionDescription ED;
+    ED << "Error while writing binary event file <" << fileName << ">.";
+    G4Exception("G4BinaryEventWriter::Close","Event0244",JustWarning,ED);
+  }
+  file.close();
+}
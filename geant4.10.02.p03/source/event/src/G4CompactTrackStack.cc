@@ -0,0 +1,224 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#include "G4CompactTrackStack.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VTrajectory.hh"
+
+namespace
+{
+  enum { goodForTrackingFlag = 1, belowThresholdFlag = 2, stopButAliveFlag = 4 };
+}
+
+G4CompactTrackStack::G4CompactTrackStack(size_t n, G4int nRecentTracks)
+  : fullTracks(), nRecent(nRecentTracks), maxNTracks(0)
+{
+  particleIndex.reserve(n);
+  position.reserve(n);
+  direction.reserve(n);
+  kineticEnergy.reserve(n);
+  globalTime.reserve(n);
+  localTime.reserve(n);
+  weight.reserve(n);
+  trackID.reserve(n);
+  parentID.reserve(n);
+  creatorModel.reserve(n);
+  creatorProcess.reserve(n);
+  touchable.reserve(n);
+  flags.reserve(n);
+}
+
+G4CompactTrackStack::~G4CompactTrackStack()
+{
+  clearAndDestroy();
+}
+
+G4bool G4CompactTrackStack::IsCompactable(const G4StackedTrack& aStackedTrack)
+{
+  const G4Track* aTrack = aStackedTrack.GetTrack();
+  if(aStackedTrack.GetTrajectory()) return false;
+  if(aTrack->GetCurrentStepNumber()!=0 || aTrack->GetTrackLength()!=0.) return false;
+  if(aTrack->GetTrackStatus()!=fAlive && aTrack->GetTrackStatus()!=fStopButAlive) return false;
+  if(aTrack->GetUserInformation() || aTrack->GetAuxiliaryTrackInformationMap()) return false;
+  if(aTrack->UseGivenVelocity()) return false;
+  if(!aTrack->GetTouchableHandle()) return false;
+  if(aTrack->GetNextTouchableHandle()
+     && aTrack->GetNextTouchableHandle()!=aTrack->GetTouchableHandle()) return false;
+
+  // Dynamic particle must be the one built from the particle definition,
+  // the momentum direction and the kinetic energy
+  const G4DynamicParticle* dp = aTrack->GetDynamicParticle();
+  const G4ParticleDefinition* pd = dp->GetParticleDefinition();
+  if(dp->GetPrimaryParticle() || dp->GetPreAssignedDecayProducts()) return false;
+  if(dp->GetPreAssignedDecayProperTime()>=0.) return false;
+  if(dp->GetPDGcode()!=0 && dp->GetPDGcode()!=pd->GetPDGEncoding()) return false;
+  if(dp->GetElectronOccupancy()) return false;
+  if(dp->GetMass()!=pd->GetPDGMass() || dp->GetCharge()!=pd->GetPDGCharge()) return false;
+  if(dp->GetMagneticMoment()!=pd->GetPDGMagneticMoment()) return false;
+  if(dp->GetPolarization().mag2()!=0. || dp->GetProperTime()!=0.) return false;
+  return true;
+}
+
+G4int G4CompactTrackStack::ParticleIndex(const G4ParticleDefinition* particle)
+{
+  // Only a few particle types are found in a stack
+  for(size_t i=0;i<particles.size();i++)
+  { if(particles[i]==particle) return G4int(i); }
+  particles.push_back(particle);
+  return G4int(particles.size())-1;
+}
+
+void G4CompactTrackStack::PushToStack(const G4StackedTrack& aStackedTrack)
+{
+  recent.push_back(aStackedTrack);
+  if(G4int(recent.size())>nRecent)
+  {
+    // The oldest track of the window goes on top of the arrays
+    CompactTrack(recent.front());
+    recent.pop_front();
+  }
+  if(GetNTrack()>maxNTracks) maxNTracks = GetNTrack();
+}
+
+void G4CompactTrackStack::CompactTrack(const G4StackedTrack& aStackedTrack)
+{
+  if(!IsCompactable(aStackedTrack))
+  {
+    particleIndex.push_back(-1);
+    fullTracks.PushToStack(aStackedTrack);
+  }
+  else
+  {
+    G4Track* aTrack = aStackedTrack.GetTrack();
+    const G4DynamicParticle* dp = aTrack->GetDynamicParticle();
+    particleIndex.push_back(ParticleIndex(dp->GetParticleDefinition()));
+    position.push_back(aTrack->GetPosition());
+    direction.push_back(dp->GetMomentumDirection());
+    kineticEnergy.push_back(dp->GetKineticEnergy());
+    globalTime.push_back(aTrack->GetGlobalTime());
+    localTime.push_back(aTrack->GetLocalTime());
+    weight.push_back(aTrack->GetWeight());
+    trackID.push_back(aTrack->GetTrackID());
+    parentID.push_back(aTrack->GetParentID());
+    creatorModel.push_back(aTrack->GetCreatorModelID());
+    creatorProcess.push_back(aTrack->GetCreatorProcess());
+    touchable.push_back(aTrack->GetTouchableHandle());
+    char f = 0;
+    if(aTrack->IsGoodForTracking()) f |= goodForTrackingFlag;
+    if(aTrack->IsBelowThreshold()) f |= belowThresholdFlag;
+    if(aTrack->GetTrackStatus()==fStopButAlive) f |= stopButAliveFlag;
+    flags.push_back(f);
+    delete aTrack;
+  }
+}
+
+G4Track* G4CompactTrackStack::PopCompactTrack(G4int iParticle)
+{
+  G4DynamicParticle* dp = new G4DynamicParticle(particles[iParticle],
+                                                direction.back(),
+                                                kineticEnergy.back());
+  G4Track* aTrack = new G4Track(dp,globalTime.back(),position.back());
+  aTrack->SetLocalTime(localTime.back());
+  aTrack->SetWeight(weight.back());
+  aTrack->SetTrackID(trackID.back());
+  aTrack->SetParentID(parentID.back());
+  aTrack->SetCreatorModelIndex(creatorModel.back());
+  aTrack->SetCreatorProcess(creatorProcess.back());
+  aTrack->SetTouchableHandle(touchable.back());
+  aTrack->SetOriginTouchableHandle(touchable.back());
+  char f = flags.back();
+  aTrack->SetGoodForTrackingFlag((f & goodForTrackingFlag)!=0);
+  aTrack->SetBelowThresholdFlag((f & belowThresholdFlag)!=0);
+  if(f & stopButAliveFlag) aTrack->SetTrackStatus(fStopButAlive);
+
+  position.pop_back();
+  direction.pop_back();
+  kineticEnergy.pop_back();
+  globalTime.pop_back();
+  localTime.pop_back();
+  weight.pop_back();
+  trackID.pop_back();
+  parentID.pop_back();
+  creatorModel.pop_back();
+  creatorProcess.pop_back();
+  touchable.pop_back();
+  flags.pop_back();
+  return aTrack;
+}
+
+G4StackedTrack G4CompactTrackStack::PopFromStack()
+{
+  if(!recent.empty())
+  {
+    G4StackedTrack aStackedTrack = recent.back();
+    recent.pop_back();
+    return aStackedTrack;
+  }
+  if(particleIndex.empty()) return G4StackedTrack();
+  G4int iParticle = particleIndex.back();
+  particleIndex.pop_back();
+  if(iParticle<0) return fullTracks.PopFromStack();
+  return G4StackedTrack(PopCompactTrack(iParticle));
+}
+
+void G4CompactTrackStack::TransferTo(G4TrackStack* aStack)
+{
+  // Keep the order of arrival in the destination
+  std::vector<G4StackedTrack> tracks(GetNTrack());
+  for(size_t i=tracks.size();i>0;i--)
+  { tracks[i-1] = PopFromStack(); }
+  for(size_t i=0;i<tracks.size();i++)
+  { aStack->PushToStack(tracks[i]); }
+}
+
+void G4CompactTrackStack::clearAndDestroy()
+{
+  particleIndex.clear();
+  position.clear();
+  direction.clear();
+  kineticEnergy.clear();
+  globalTime.clear();
+  localTime.clear();
+  weight.clear();
+  trackID.clear();
+  parentID.clear();
+  creatorModel.clear();
+  creatorProcess.clear();
+  touchable.clear();
+  flags.clear();
+  fullTracks.clearAndDestroy();
+  for(size_t i=0;i<recent.size();i++)
+  {
+    delete recent[i].GetTrack();
+    delete recent[i].GetTrajectory();
+  }
+  recent.clear();
+}
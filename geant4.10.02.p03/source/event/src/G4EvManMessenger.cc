@@ -33,6 +33,7 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4SubEventQueue.hh"
 
 G4EvManMessenger::G4EvManMessenger(G4EventManager * fEvMan)
 :fEvManager(fEvMan)
@@ -58,6 +59,29 @@ G4EvManMessenger::G4EvManMessenger(G4EventManager * fEvMan)
   storeEvtCmd->SetGuidance("Given the potential large memory size of G4Event and its datamember objects stored in G4Event,");
   storeEvtCmd->SetGuidance("the user must be careful and responsible for not to store too many G4Event objects.");
   storeEvtCmd->AvailableForStates(G4State_EventProc);
+
+  subEventDirectory = new G4UIdirectory("/event/subEvent/");
+  subEventDirectory->SetGuidance("Control of sub-event parallelism (multi-threaded mode only).");
+  subEventDirectory->SetGuidance("Tracks of an event are shared with idle worker threads in bundles.");
+
+  bundleSizeCmd = new G4UIcmdWithAnInteger("/event/subEvent/bundleSize",this);
+  bundleSizeCmd->SetGuidance("Set the number of tracks in a bundle transported by another thread.");
+  bundleSizeCmd->SetGuidance("Bundles are made only of tracks which have not been transported yet.");
+  bundleSizeCmd->SetGuidance("Hits collections of the bundles are merged to the event before");
+  bundleSizeCmd->SetGuidance("EndOfEventAction. Hits must be copy-constructible.");
+  bundleSizeCmd->SetGuidance("Trajectories of the tracks of the bundles are not stored.");
+  bundleSizeCmd->SetGuidance(" 0 : disabled (default)");
+  bundleSizeCmd->SetParameterName("nTracks",false);
+  bundleSizeCmd->SetRange("nTracks>=0");
+  bundleSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  minUrgentCmd = new G4UIcmdWithAnInteger("/event/subEvent/minimumUrgentTracks",this);
+  minUrgentCmd->SetGuidance("Bundles are made only while the urgent stack holds more than");
+  minUrgentCmd->SetGuidance("the given number of tracks in addition to the bundle size.");
+  minUrgentCmd->SetParameterName("nTracks",true);
+  minUrgentCmd->SetDefaultValue(1000);
+  minUrgentCmd->SetRange("nTracks>=0");
+  minUrgentCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 G4EvManMessenger::~G4EvManMessenger()
@@ -65,6 +89,9 @@ G4EvManMessenger::~G4EvManMessenger()
   delete abortCmd;
   delete verboseCmd;
   delete storeEvtCmd;
+  delete bundleSizeCmd;
+  delete minUrgentCmd;
+  delete subEventDirectory;
   delete eventDirectory;
 }
 
@@ -76,6 +103,12 @@ void G4EvManMessenger::SetNewValue(G4UIcommand * command,G4String newValues)
   { fEvManager->AbortCurrentEvent(); }
   if( command == storeEvtCmd )
   { fEvManager->KeepTheCurrentEvent(); }
+  if( command == bundleSizeCmd )
+  { G4SubEventQueue::GetInstance()
+      ->SetBundleSize(bundleSizeCmd->GetNewIntValue(newValues)); }
+  if( command == minUrgentCmd )
+  { G4SubEventQueue::GetInstance()
+      ->SetMinimumUrgentTracks(minUrgentCmd->GetNewIntValue(newValues)); }
 }
 
 G4String G4EvManMessenger::GetCurrentValue(G4UIcommand * command)
@@ -83,6 +116,10 @@ G4String G4EvManMessenger::GetCurrentValue(G4UIcommand * command)
   G4String cv;
   if( command == verboseCmd )
   { cv = verboseCmd->ConvertToString(fEvManager->GetVerboseLevel()); }
+  if( command == bundleSizeCmd )
+  { cv = bundleSizeCmd->ConvertToString(G4SubEventQueue::GetInstance()->GetBundleSize()); }
+  if( command == minUrgentCmd )
+  { cv = minUrgentCmd->ConvertToString(G4SubEventQueue::GetInstance()->GetMinimumUrgentTracks()); }
   return cv;
 }
 
@@ -46,7 +46,7 @@ G4Event::G4Event()
  eventAborted(false),userInfo(nullptr),
  randomNumberStatus(nullptr),validRandomNumberStatus(false),
  randomNumberStatusForProcessing(nullptr),validRandomNumberStatusForProcessing(false),
- keepTheEvent(false),grips(0)
+ keepTheEvent(false),grips(0),subEvent(false)
 {
 }
 
@@ -57,7 +57,7 @@ G4Event::G4Event(G4int evID)
  eventAborted(false),userInfo(nullptr),
  randomNumberStatus(nullptr),validRandomNumberStatus(false),
  randomNumberStatusForProcessing(nullptr),validRandomNumberStatusForProcessing(false),
- keepTheEvent(false),grips(0)
+ keepTheEvent(false),grips(0),subEvent(false)
 {
 }
 
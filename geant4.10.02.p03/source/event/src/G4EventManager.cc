@@ -40,14 +40,30 @@
 #include "G4ApplicationState.hh"
 #include "G4TransportationManager.hh"
 #include "G4Navigator.hh"
+#include "G4StepTraceWriter.hh"
+#include "G4SubEvent.hh"
+#include "G4TrajectoryStore.hh"
+#include "G4SubEventQueue.hh"
+#include "G4HCofThisEvent.hh"
 #include "Randomize.hh"
+#include <limits>
+
+namespace
+{
+  // Number of track IDs taken at once from the counter shared by the
+  // threads transporting an event in sub-event parallel mode.
+  const G4int subEventTrackIDBlock = 1000;
+}
 
 G4ThreadLocal G4EventManager* G4EventManager::fpEventManager = nullptr;
 G4EventManager* G4EventManager::GetEventManager()
 { return fpEventManager; }
 
 G4EventManager::G4EventManager()
-:currentEvent(nullptr),trajectoryContainer(nullptr),
+:subEventOwner(false),trackIDLimit(std::numeric_limits<G4int>::max()),
+ subEventTrackIDs(0),trackIDSource(nullptr),
+ 
+ currentEvent(nullptr),trajectoryContainer(nullptr),trajectoryStore(nullptr),
  verboseLevel(0),tracking(false),abortRequested(false),
  storetRandomNumberStatusToG4Event(false)
 {
@@ -61,6 +77,7 @@ G4EventManager::G4EventManager()
   trackManager = new G4TrackingManager;
   transformer = new G4PrimaryTransformer;
   trackContainer = new G4StackManager;
+  trajectoryStore = new G4TrajectoryStore;
   theMessenger = new G4EvManMessenger(this);
   sdManager = G4SDManager::GetSDMpointerIfExist();
   stateManager = G4StateManager::GetStateManager();
@@ -81,6 +98,7 @@ G4EventManager& G4EventManager::operator=(const G4EventManager&)
 G4EventManager::~G4EventManager()
 {
    delete trackContainer;
+   delete trajectoryStore;
    delete transformer;
    delete trackManager;
    delete theMessenger;
@@ -107,6 +125,7 @@ void G4EventManager::DoProcessing(G4Event* anEvent)
     return;
   }
   currentEvent = anEvent;
+  G4StepTraceWriter::SetCurrentEventID(anEvent->GetEventID());
   stateManager->SetNewState(G4State_EventProc);
   if(storetRandomNumberStatusToG4Event>1)
   {
@@ -122,9 +141,6 @@ void G4EventManager::DoProcessing(G4Event* anEvent)
   G4Navigator* navigator =
       G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
   navigator->LocateGlobalPointAndSetup(center,0,false);
-                                                                                      
-  G4Track * track = nullptr;
-  G4TrackStatus istop = fAlive;
 
 #ifdef G4VERBOSE
   if ( verboseLevel > 0 )
@@ -167,6 +183,55 @@ void G4EventManager::DoProcessing(G4Event* anEvent)
   }
 #endif
   
+  G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+  subEventOwner = subEventQueue->IsEnabled();
+  if(subEventOwner)
+  {
+    subEventQueue->BeginEvent();
+    // From now on track IDs are shared with the helper threads
+    subEventTrackIDs = trackIDCounter+1;
+    trackIDSource = &subEventTrackIDs;
+    trackIDLimit = trackIDCounter;
+  }
+
+  do
+  { TransportStackedTracks(); }
+  while( subEventOwner && CollectSubEvents() ); // Loop checking 17.10.2026
+
+#ifdef G4VERBOSE
+  if ( verboseLevel > 0 )
+  {
+    G4cout << "NULL returned from G4StackManager." << G4endl;
+    G4cout << "Terminate current event processing." << G4endl;
+  }
+#endif
+
+  if(sdManager)
+  { sdManager->TerminateCurrentEvent(currentEvent->GetHCofThisEvent()); }
+
+  if(subEventOwner)
+  {
+    MergeSubEvents();
+    subEventQueue->EndEvent();
+    subEventOwner = false;
+    trackIDSource = nullptr;
+    trackIDLimit = std::numeric_limits<G4int>::max();
+  }
+
+  trajectoryStore->EndOfEvent(currentEvent->GetEventID());
+
+  if(userEventAction) userEventAction->EndOfEventAction(currentEvent);
+
+  stateManager->SetNewState(G4State_GeomClosed);
+  currentEvent = nullptr;
+  abortRequested = false;
+}
+
+void G4EventManager::TransportStackedTracks()
+{
+  G4Track * track = nullptr;
+  G4TrackStatus istop = fAlive;
+
   G4VTrajectory* previousTrajectory;
   while( ( track = trackContainer->PopNextTrack(&previousTrajectory) ) != 0 ) // Loop checking 12.28.2015 M.Asai
   {
@@ -204,6 +269,13 @@ void G4EventManager::DoProcessing(G4Event* anEvent)
       delete aTrajectory;
       aTrajectory = previousTrajectory;
     }
+    if(aTrajectory&&(istop!=fStopButAlive)&&(istop!=fSuspend)
+       &&trajectoryStore->IsActive())
+    {
+      // The store may compact, write or drop the completed trajectory
+      aTrajectory = trajectoryStore->Process(aTrajectory,track,
+                                             currentEvent->GetEventID());
+    }
     if(aTrajectory&&(istop!=fStopButAlive)&&(istop!=fSuspend))
     {
       if(!trajectoryContainer)
@@ -246,26 +318,197 @@ void G4EventManager::DoProcessing(G4Event* anEvent)
         delete track;
         break;
     }
+  
+    if( subEventOwner && !abortRequested ) ExportSubEvents();
+  }
+}
+
+void G4EventManager::ExportSubEvents()
+{
+  // A bundle of tracks which have not been transported yet is moved to
+  // the shared queue, so that idle worker threads can transport it.
+  G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+  G4int bundleSize = subEventQueue->GetBundleSize();
+  if( trackContainer->GetNUrgentTrack()
+      <= subEventQueue->GetMinimumUrgentTracks()+bundleSize ) return;
+
+  std::vector<G4Track*> tracks;
+  if( trackContainer->ExtractFreshUrgentTracks(bundleSize,tracks)==0 ) return;
+
+  G4SubEvent* aSubEvent = new G4SubEvent(currentEvent->GetEventID(),
+                              G4Threading::G4GetThreadId(),&subEventTrackIDs);
+  for(auto aTrack : tracks)
+  {
+    aSubEvent->AddTrack(aTrack);
+    delete aTrack;
+  }
+  aSubEvent->SetSeeds((long)(100000000L * G4UniformRand()),
+                      (long)(100000000L * G4UniformRand()));
+  ownSubEvents.push_back(aSubEvent);
+  subEventQueue->Push(aSubEvent);
+
+#ifdef G4VERBOSE
+  if ( verboseLevel > 1 )
+  {
+    G4cout << aSubEvent->GetNumberOfTracks() << " tracks of event "
+           << currentEvent->GetEventID() << " are exported as sub-event "
+           << ownSubEvents.size() << G4endl;
+  }
+#endif
+}
+
+G4bool G4EventManager::CollectSubEvents()
+{
+  // Bundles which have not been taken by any other thread are transported
+  // by this thread. Otherwise wait for the bundles being transported.
+  G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+  G4bool reclaimed = false;
+  for(auto aSubEvent : ownSubEvents)
+  {
+    if(!subEventQueue->Reclaim(aSubEvent)) continue;
+    reclaimed = true;
+    if(abortRequested) continue;
+    for(size_t i=0;i<aSubEvent->GetNumberOfTracks();i++)
+    { trackContainer->PushOneTrack(aSubEvent->CreateTrack(i)); }
+  }
+  if(reclaimed) return true;
+
+  for(auto aSubEvent : ownSubEvents)
+  { subEventQueue->WaitWhileProcessing(aSubEvent); }
+  return false;
+}
+
+void G4EventManager::MergeSubEvents()
+{
+  G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+  G4HCofThisEvent* HCE = currentEvent->GetHCofThisEvent();
+  static G4ThreadLocal G4bool warned = false;
+  for(auto aSubEvent : ownSubEvents)
+  {
+    G4Event* subEvent = aSubEvent->GetResult();
+    if(!subEvent)
+    {
+      // taken back by this thread, thus not known by any other thread
+      delete aSubEvent;
+      continue;
+    }
+    G4HCofThisEvent* subHCE = subEvent->GetHCofThisEvent();
+    if(HCE && subHCE)
+    {
+      for(G4int i=0;i<subHCE->GetNumberOfCollections();i++)
+      {
+        G4VHitsCollection* subHC = subHCE->GetHC(i);
+        if(!subHC || subHC->GetSize()==0) continue;
+        G4VHitsCollection* hc = HCE->GetHC(i);
+        if((!hc || !hc->Merge(subHC)) && !warned)
+        {
+          G4ExceptionDescription ED;
+          ED << "Hits collection <" << subHC->GetName()
+             << "> of a sub-event cannot be merged to the event."
+             << " The hits class must be copy-constructible, or Merge()"
+             << " must be implemented for this hits collection."
+             << " These hits are lost.";
+          G4Exception("G4EventManager::MergeSubEvents","Event0201",
+                      JustWarning,ED);
+          warned = true;
+        }
+      }
+    }
+    // From now on the sub-event belongs to the thread which transported it
+    subEventQueue->SetMerged(aSubEvent);
   }
+  ownSubEvents.clear();
+}
+
+void G4EventManager::ProcessSubEvents()
+{
+  G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+  G4SubEvent* aSubEvent = nullptr;
+  while( ( aSubEvent = subEventQueue->WaitForSubEvent() ) != nullptr ) // Loop checking 17.10.2026
+  {
+    ProcessSubEvent(aSubEvent);
+    subEventQueue->SetDone(aSubEvent);
+    helpedSubEvents.push_back(aSubEvent);
+    CleanUpSubEvents();
+  }
+  // All the events are completed, hence all the bundles are merged
+  CleanUpSubEvents();
+}
+
+void G4EventManager::ProcessSubEvent(G4SubEvent* aSubEvent)
+{
+  G4Random::setTheSeeds(aSubEvent->GetSeeds(),-1);
+
+  G4Event* subEvent = new G4Event(aSubEvent->GetEventID());
+  aSubEvent->SetResult(subEvent);
+  currentEvent = subEvent;
+  G4int ownEventID = G4StepTraceWriter::GetCurrentEventID();
+  G4StepTraceWriter::SetCurrentEventID(aSubEvent->GetEventID());
+  abortRequested = false;
+  stateManager->SetNewState(G4State_EventProc);
+
+  G4ThreeVector center(0,0,0);
+  G4Navigator* navigator =
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+  navigator->LocateGlobalPointAndSetup(center,0,false);
+
+#ifdef G4_STORE_TRAJECTORY
+  trajectoryContainer = nullptr;
+#endif
+
+  sdManager = G4SDManager::GetSDMpointerIfExist();
+  if(sdManager)
+  { subEvent->SetHCofThisEvent(sdManager->PrepareNewEvent()); }
+
+  subEvent->SetSubEvent();
+  if(userEventAction) userEventAction->BeginOfEventAction(subEvent);
+
+  trackIDSource = aSubEvent->GetTrackIDSource();
+  trackIDCounter = trackIDLimit = 0;
+  for(size_t i=0;i<aSubEvent->GetNumberOfTracks();i++)
+  { trackContainer->PushOneTrack(aSubEvent->CreateTrack(i)); }
 
 #ifdef G4VERBOSE
   if ( verboseLevel > 0 )
   {
-    G4cout << "NULL returned from G4StackManager." << G4endl;
-    G4cout << "Terminate current event processing." << G4endl;
+    G4cout << "Transporting " << aSubEvent->GetNumberOfTracks()
+           << " tracks of event " << aSubEvent->GetEventID()
+           << " exported by thread " << aSubEvent->GetOwnerID() << G4endl;
   }
 #endif
 
+  TransportStackedTracks();
+
   if(sdManager)
-  { sdManager->TerminateCurrentEvent(currentEvent->GetHCofThisEvent()); }
+  { sdManager->TerminateCurrentEvent(subEvent->GetHCofThisEvent()); }
 
-  if(userEventAction) userEventAction->EndOfEventAction(currentEvent);
+  if(userEventAction) userEventAction->EndOfEventAction(subEvent);
 
+  trackIDSource = nullptr;
+  trackIDLimit = std::numeric_limits<G4int>::max();
   stateManager->SetNewState(G4State_GeomClosed);
   currentEvent = nullptr;
+  G4StepTraceWriter::SetCurrentEventID(ownEventID);
   abortRequested = false;
 }
 
+void G4EventManager::CleanUpSubEvents()
+{
+  G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+  auto itr = helpedSubEvents.begin();
+  while(itr!=helpedSubEvents.end()) // Loop checking 17.10.2026
+  {
+    if(subEventQueue->GetState(*itr)==G4SubEvent::fMerged)
+    {
+      delete (*itr)->GetResult();
+      delete *itr;
+      itr = helpedSubEvents.erase(itr);
+    }
+    else
+    { ++itr; }
+  }
+}
+
 void G4EventManager::StackTracks(G4TrackVector *trackVector,G4bool IDhasAlreadySet)
 {
   if( trackVector )
@@ -279,6 +522,7 @@ void G4EventManager::StackTracks(G4TrackVector *trackVector,G4bool IDhasAlreadyS
     for( auto newTrack : *trackVector )
     {
       trackIDCounter++;
+      if( trackIDCounter > trackIDLimit ) NextTrackIDBlock();
       if(!IDhasAlreadySet)
       {
         newTrack->SetTrackID( trackIDCounter );
@@ -305,6 +549,12 @@ void G4EventManager::StackTracks(G4TrackVector *trackVector,G4bool IDhasAlreadyS
   }
 }
 
+void G4EventManager::NextTrackIDBlock()
+{
+  trackIDCounter = trackIDSource->fetch_add(subEventTrackIDBlock);
+  trackIDLimit = trackIDCounter + subEventTrackIDBlock - 1;
+}
+
 void G4EventManager::SetUserAction(G4UserEventAction* userAction)
 {
   userEventAction = userAction;
@@ -66,7 +66,7 @@ namespace
 
 G4GeneralParticleSourceData::G4GeneralParticleSourceData() :
 		multiple_vertex(false) ,flat_sampling(false),
-		normalised(false),currentSourceIdx(0)
+		normalised(false),currentSourceIdx(0),primaryBatchSize(0)
 {
     G4MUTEXINIT(mutex);
     
@@ -142,6 +142,7 @@ void G4GeneralParticleSourceData::SetCurrentSourceIntensity(G4double intensity)
 void G4GeneralParticleSourceData::AddASource(G4double intensity)
 {
     currentSource = new G4SingleParticleSource();
+    currentSource->SetPrimaryBatchSize(primaryBatchSize);
     sourceVector.push_back(currentSource);
     sourceIntensity.push_back(intensity);
     currentSourceIdx = sourceVector.size() - 1;
@@ -191,6 +192,19 @@ void G4GeneralParticleSourceData::SetVerbosityAllSources(G4int vl )
 
 }
 
+void G4GeneralParticleSourceData::SetPrimaryBatchSize(G4int n)
+{
+    primaryBatchSize = n;
+    for ( std::vector<G4SingleParticleSource*>::iterator it = sourceVector.begin();
+    	  it != sourceVector.end() ; ++it ) { (*it)->SetPrimaryBatchSize(n); }
+}
+
+void G4GeneralParticleSourceData::FlushPrimaryBuffers()
+{
+    for ( std::vector<G4SingleParticleSource*>::iterator it = sourceVector.begin();
+    	  it != sourceVector.end() ; ++it ) { (*it)->FlushPrimaryBuffer(); }
+}
+
 G4SingleParticleSource* G4GeneralParticleSourceData::GetCurrentSource(G4int idx)
 {
     currentSource = sourceVector[idx];
@@ -291,6 +291,17 @@ G4GeneralParticleSourceMessenger::G4GeneralParticleSourceMessenger
   verbosityCmd->SetParameterName("level",false);
   verbosityCmd->SetRange("level>=0 && level <=2");
 
+  pipelineCmd = new G4UIcmdWithAnInteger("/gps/pipeline",this);
+  pipelineCmd->SetGuidance("Set the number of vertices pre-sampled at once by each source");
+  pipelineCmd->SetGuidance("and thread for the following events. They are then used one per");
+  pipelineCmd->SetGuidance("event. Requires per-event random streams (/random/eventStreams):");
+  pipelineCmd->SetGuidance("each vertex is sampled from the stream of its own event, and the");
+  pipelineCmd->SetGuidance("primaries are the same as without pre-sampling. In multi-threaded");
+  pipelineCmd->SetGuidance("mode it should not exceed the event modulo (/run/eventModulo).");
+  pipelineCmd->SetGuidance(" 0 : one vertex sampled per event (default)");
+  pipelineCmd->SetParameterName("nVertices",false);
+  pipelineCmd->SetRange("nVertices>=0");
+
   // now extended commands
   // Positional ones:
   positionDirectory = new G4UIdirectory("/gps/pos/");
@@ -403,6 +414,16 @@ G4GeneralParticleSourceMessenger::G4GeneralParticleSourceMessenger
   confineCmd1->SetParameterName("VolName",false,false);
   confineCmd1->SetDefaultValue("NULL");
 
+  confineGridCmd1 = new G4UIcmdWithAnInteger("/gps/pos/confineGrid",this);
+  confineGridCmd1->SetGuidance("Set the number of bins per axis of the confinement grid.");
+  confineGridCmd1->SetGuidance("For a source of type Volume, points are drawn only in the grid");
+  confineGridCmd1->SetGuidance("cells which are inside or on the boundary of the confining");
+  confineGridCmd1->SetGuidance("volume, and only points of boundary cells are tested.");
+  confineGridCmd1->SetGuidance("The grid is built once per thread and geometry.");
+  confineGridCmd1->SetGuidance(" 0 : no grid (default)");
+  confineGridCmd1->SetParameterName("nBins",false);
+  confineGridCmd1->SetRange("nBins>=0 && nBins<=512");
+
   // old implementations
 //  typeCmd = new G4UIcmdWithAString("/gps/type",this);
 //  typeCmd->SetGuidance("Sets source distribution type. (obsolete!)");
@@ -901,6 +922,7 @@ G4GeneralParticleSourceMessenger::~G4GeneralParticleSourceMessenger()
   delete partheCmd1;
   delete parphiCmd1;
   delete confineCmd1;
+  delete confineGridCmd1;
 
   delete angularDirectory;
 //  delete angtypeCmd;
@@ -970,6 +992,7 @@ G4GeneralParticleSourceMessenger::~G4GeneralParticleSourceMessenger()
   delete arbintCmd1;
 
   delete verbosityCmd;
+  delete pipelineCmd;
   delete ionCmd;
   delete ionLvlCmd;
   delete particleCmd;
@@ -1007,6 +1030,9 @@ G4GeneralParticleSourceMessenger::~G4GeneralParticleSourceMessenger()
 
 void G4GeneralParticleSourceMessenger::SetNewValue(G4UIcommand *command, G4String newValues)
 {
+  // Primaries pre-sampled with the previous settings are discarded
+  fGPS->FlushPrimaryBuffers();
+
 //  if(command == typeCmd)
 //    {
 //      CHECKPG(); fParticleGun->GetPosDist()->SetPosDisType(newValues);
@@ -1381,6 +1407,10 @@ void G4GeneralParticleSourceMessenger::SetNewValue(G4UIcommand *command, G4Strin
       fParticleGun->GetPosDist()->SetPosDisType("Point");    
       fParticleGun->GetPosDist()->SetCentreCoords(positionCmd->GetNew3VectorValue(newValues));
     }
+  else if(command == pipelineCmd)
+    {
+      fGPS->SetPrimaryBatchSize(pipelineCmd->GetNewIntValue(newValues));
+    }
   else if(command == verbosityCmd)
     {
 	  fGPS->SetVerbosity(verbosityCmd->GetNewIntValue(newValues));
@@ -1547,6 +1577,10 @@ void G4GeneralParticleSourceMessenger::SetNewValue(G4UIcommand *command, G4Strin
     {
       CHECKPG(); fParticleGun->GetPosDist()->ConfineSourceToVolume(newValues);
     }
+  else if(command == confineGridCmd1)
+    {
+      CHECKPG(); fParticleGun->GetPosDist()->SetConfineGridBins(confineGridCmd1->GetNewIntValue(newValues));
+    }
   else if(command == angtypeCmd1)
     {
       CHECKPG(); fParticleGun->GetAngDist()->SetAngDistType(newValues);
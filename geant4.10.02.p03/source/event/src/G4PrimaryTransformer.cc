@@ -44,7 +44,8 @@ G4PrimaryTransformer::G4PrimaryTransformer()
 :verboseLevel(0),trackID(0),
  unknown(nullptr),unknownParticleDefined(false),
  opticalphoton(nullptr),opticalphotonDefined(false),
- nWarn(0)
+ nWarn(0),pdgCacheTableSize(-1),
+ lastPDGcode(0),lastPDGdefinition(nullptr)
 {
   particleTable = G4ParticleTable::GetParticleTable();
   CheckUnknown();
@@ -65,6 +66,37 @@ void G4PrimaryTransformer::CheckUnknown()
   { opticalphotonDefined = true; }
   else
   { opticalphotonDefined = false; }
+  ClearDefinitionCache();
+}
+
+void G4PrimaryTransformer::ClearDefinitionCache()
+{
+  pdgCache.clear();
+  pdgCacheTableSize = particleTable->entries();
+  lastPDGcode = 0;
+  lastPDGdefinition = nullptr;
+}
+
+G4ParticleDefinition* G4PrimaryTransformer::FindDefinition(G4int pdgCode)
+{
+  if(pdgCode==0) return nullptr;
+  if(pdgCode==lastPDGcode) return lastPDGdefinition;
+
+  G4ParticleDefinition* partDef = nullptr;
+  std::map<G4int,G4ParticleDefinition*>::const_iterator itr = pdgCache.find(pdgCode);
+  if(itr!=pdgCache.end())
+  { partDef = itr->second; }
+  else
+  {
+    G4bool upToDate = (particleTable->entries()==pdgCacheTableSize);
+    partDef = particleTable->FindParticle(pdgCode);
+    // FindParticle may have copied the definition into the table of this thread
+    if(upToDate) pdgCacheTableSize = particleTable->entries();
+    pdgCache[pdgCode] = partDef;
+  }
+  lastPDGcode = pdgCode;
+  lastPDGdefinition = partDef;
+  return partDef;
 }
     
 G4TrackVector* G4PrimaryTransformer::GimmePrimaries(G4Event* anEvent,G4int trackIDCounter)
@@ -75,6 +107,9 @@ G4TrackVector* G4PrimaryTransformer::GimmePrimaries(G4Event* anEvent,G4int track
   for(auto tr : TV) delete tr;
   TV.clear();
 
+  // Particles (e.g. ions) may have been added since the previous event
+  if(particleTable->entries()!=pdgCacheTableSize) ClearDefinitionCache();
+
   //Loop over vertices
   G4PrimaryVertex* nextVertex = anEvent->GetPrimaryVertex();
   while(nextVertex) // Loop checking 12.28.2015 M.Asai
@@ -320,7 +355,7 @@ G4bool G4PrimaryTransformer::CheckDynamicParticle(G4DynamicParticle*DP)
 G4ParticleDefinition* G4PrimaryTransformer::GetDefinition(G4PrimaryParticle*pp)
 {
   G4ParticleDefinition* partDef = pp->GetG4code();
-  if(!partDef) partDef = particleTable->FindParticle(pp->GetPDGcode());
+  if(!partDef) partDef = FindDefinition(pp->GetPDGcode());
   if(unknownParticleDefined && ((!partDef)||partDef->IsShortLived())) partDef = unknown;
   return partDef;
 }
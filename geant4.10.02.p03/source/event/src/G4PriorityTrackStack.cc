@@ -0,0 +1,282 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#include "G4PriorityTrackStack.hh"
+#include "G4Track.hh"
+#include "G4VTrajectory.hh"
+#include "G4ParticleTable.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4UnitsTable.hh"
+#include "G4ios.hh"
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+  struct ByPriority
+  {
+    ByPriority(const std::vector<G4int>& p) : priorities(p) {}
+    G4bool operator()(size_t i, size_t j) const
+    {
+      if(priorities[i]!=priorities[j]) return priorities[i]<priorities[j];
+      return i<j;
+    }
+    const std::vector<G4int>& priorities;
+  };
+}
+
+G4PriorityTrackStack::G4PriorityTrackStack()
+  : resolved(true), nTracks(0), maxNTracks(0)
+{
+  Bucket defaultBucket;
+  defaultBucket.eMin = 0.;
+  defaultBucket.eMax = DBL_MAX;
+  defaultBucket.priority = 0;
+  AddBucket(defaultBucket);
+}
+
+G4PriorityTrackStack::~G4PriorityTrackStack()
+{
+  for(size_t i=0;i<buckets.size();i++) delete buckets[i].stack;
+}
+
+const G4PriorityTrackStack &
+G4PriorityTrackStack::operator=(const G4PriorityTrackStack &) {
+  return *this;
+}
+
+void G4PriorityTrackStack::AddBucket(const G4String& particleName,
+              const G4String& regionName,
+              G4double eMin, G4double eMax, G4int priority)
+{
+  Bucket aBucket;
+  aBucket.particleName = particleName;
+  aBucket.regionName = regionName;
+  aBucket.eMin = eMin;
+  aBucket.eMax = eMax;
+  aBucket.priority = priority;
+  AddBucket(aBucket);
+}
+
+void G4PriorityTrackStack::AddBucket(const Bucket& aBucket)
+{
+  Bucket newBucket = aBucket;
+  newBucket.particle = 0;
+  newBucket.region = 0;
+  newBucket.stack = new G4TrackStack(1000);
+  if(buckets.empty())
+  { buckets.push_back(newBucket); }
+  else
+  {
+    // The default bucket stays the last one
+    buckets.insert(buckets.end()-1,newBucket);
+    resolved = false;
+  }
+  SortByPriority();
+}
+
+void G4PriorityTrackStack::AddEnergyBuckets(G4int nBins,
+              G4double eMin, G4double eMax,
+              const G4String& particleName, G4int firstPriority)
+{
+  if(nBins<1 || eMin<=0. || eMax<=eMin) return;
+  G4double ratio = std::log(eMax/eMin)/nBins;
+  for(G4int i=0;i<nBins;i++)
+  {
+    G4double e1 = (i==0) ? 0. : eMin*std::exp(i*ratio);
+    G4double e2 = (i==nBins-1) ? DBL_MAX : eMin*std::exp((i+1)*ratio);
+    AddBucket(particleName,"",e1,e2,firstPriority+i);
+  }
+}
+
+void G4PriorityTrackStack::SetDefaultPriority(G4int priority)
+{
+  buckets.back().priority = priority;
+  SortByPriority();
+}
+
+void G4PriorityTrackStack::ClearBuckets()
+{
+  G4TrackStack tmpStack;
+  TransferTo(&tmpStack);
+  for(size_t i=0;i<buckets.size()-1;i++) delete buckets[i].stack;
+  buckets.erase(buckets.begin(),buckets.end()-1);
+  SortByPriority();
+  resolved = true;
+  TransferFrom(&tmpStack);
+}
+
+void G4PriorityTrackStack::SortByPriority()
+{
+  std::vector<G4int> priorities(buckets.size());
+  popOrder.resize(buckets.size());
+  for(size_t i=0;i<buckets.size();i++)
+  {
+    priorities[i] = buckets[i].priority;
+    popOrder[i] = i;
+  }
+  std::sort(popOrder.begin(),popOrder.end(),ByPriority(priorities));
+}
+
+void G4PriorityTrackStack::ResolveBuckets()
+{
+  // Particles and regions are looked up at the first push, since they
+  // may not exist yet when the buckets are defined
+  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+  G4RegionStore* regionStore = G4RegionStore::GetInstance();
+  for(size_t i=0;i<buckets.size()-1;i++)
+  {
+    Bucket& aBucket = buckets[i];
+    if(!(aBucket.particleName.empty()) && !(aBucket.particle))
+    {
+      aBucket.particle = particleTable->FindParticle(aBucket.particleName);
+      if(!(aBucket.particle))
+      {
+        G4ExceptionDescription ed;
+        ed << "Particle <" << aBucket.particleName << "> is not found."
+           << " The bucket will not be used.";
+        G4Exception("G4PriorityTrackStack::ResolveBuckets()","Event0211",
+                    JustWarning,ed);
+      }
+    }
+    if(!(aBucket.regionName.empty()) && !(aBucket.region))
+    {
+      aBucket.region = regionStore->GetRegion(aBucket.regionName,false);
+      if(!(aBucket.region))
+      {
+        G4ExceptionDescription ed;
+        ed << "Region <" << aBucket.regionName << "> is not found."
+           << " The bucket will not be used.";
+        G4Exception("G4PriorityTrackStack::ResolveBuckets()","Event0211",
+                    JustWarning,ed);
+      }
+    }
+  }
+  resolved = true;
+}
+
+size_t G4PriorityTrackStack::FindBucket(const G4Track* aTrack)
+{
+  if(!resolved) ResolveBuckets();
+  const G4DynamicParticle* dp = aTrack->GetDynamicParticle();
+  const G4ParticleDefinition* particle = dp->GetDefinition();
+  G4double eKin = dp->GetKineticEnergy();
+  const G4Region* region = 0;
+  G4bool regionChecked = false;
+
+  size_t nBuckets = buckets.size()-1;
+  for(size_t i=0;i<nBuckets;i++)
+  {
+    const Bucket& aBucket = buckets[i];
+    if(eKin<aBucket.eMin || eKin>=aBucket.eMax) continue;
+    if(!(aBucket.particleName.empty()) && aBucket.particle!=particle) continue;
+    if(!(aBucket.regionName.empty()))
+    {
+      if(!regionChecked)
+      {
+        // Primary tracks do not have a touchable yet
+        G4VPhysicalVolume* pv = aTrack->GetVolume();
+        if(pv) region = pv->GetLogicalVolume()->GetRegion();
+        regionChecked = true;
+      }
+      if(!region || aBucket.region!=region) continue;
+    }
+    return i;
+  }
+  return nBuckets;
+}
+
+void G4PriorityTrackStack::PushToStack(const G4StackedTrack& aStackedTrack)
+{
+  buckets[FindBucket(aStackedTrack.GetTrack())].stack->PushToStack(aStackedTrack);
+  nTracks++;
+  if(nTracks>maxNTracks) maxNTracks = nTracks;
+}
+
+G4StackedTrack G4PriorityTrackStack::PopFromStack()
+{
+  G4StackedTrack aStackedTrack;
+  if(nTracks)
+  {
+    for(size_t i=0;i<popOrder.size();i++)
+    {
+      G4TrackStack* aStack = buckets[popOrder[i]].stack;
+      if(aStack->GetNTrack())
+      {
+        aStackedTrack = aStack->PopFromStack();
+        nTracks--;
+        break;
+      }
+    }
+  }
+  return aStackedTrack;
+}
+
+void G4PriorityTrackStack::TransferTo(G4TrackStack* aStack)
+{
+  // The buckets to be processed first end up at the top of aStack
+  for(size_t i=popOrder.size();i>0;i--)
+  { buckets[popOrder[i-1]].stack->TransferTo(aStack); }
+  nTracks = 0;
+}
+
+void G4PriorityTrackStack::clearAndDestroy()
+{
+  for(size_t i=0;i<buckets.size();i++) buckets[i].stack->clearAndDestroy();
+  nTracks = 0;
+}
+
+void G4PriorityTrackStack::DumpBuckets() const
+{
+  G4cout << "G4PriorityTrackStack : " << buckets.size() << " buckets"
+         << " (in the order of processing)" << G4endl;
+  for(size_t i=0;i<popOrder.size();i++)
+  {
+    const Bucket& aBucket = buckets[popOrder[i]];
+    G4cout << "  priority " << aBucket.priority;
+    if(popOrder[i]==buckets.size()-1)
+    { G4cout << " : default bucket"; }
+    else
+    {
+      G4cout << " : particle "
+             << (aBucket.particleName.empty() ? G4String("any") : aBucket.particleName)
+             << " region "
+             << (aBucket.regionName.empty() ? G4String("any") : aBucket.regionName)
+             << " Ekin [" << G4BestUnit(aBucket.eMin,"Energy") << ", ";
+      if(aBucket.eMax<DBL_MAX) G4cout << G4BestUnit(aBucket.eMax,"Energy");
+      else G4cout << "inf ";
+      G4cout << ")";
+    }
+    G4cout << " - " << aBucket.stack->GetNTrack() << " tracks" << G4endl;
+  }
+}
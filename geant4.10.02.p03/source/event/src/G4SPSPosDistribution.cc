@@ -54,7 +54,15 @@
 #include "G4PhysicalVolumeStore.hh"
 #include "G4AutoLock.hh"
 #include "G4AutoDelete.hh"
+#include <algorithm>
 
+namespace
+{
+  // Navigator used only to test the confinement, so that the tracking
+  // navigator is left untouched and successive points are located
+  // relative to the previous one
+  G4ThreadLocal G4Navigator* confineNavigator = 0;
+}
 
 G4SPSPosDistribution::thread_data_t::thread_data_t()
 {
@@ -62,6 +70,12 @@ G4SPSPosDistribution::thread_data_t::thread_data_t()
   CSideRefVec2 = G4ThreeVector(CLHEP::HepYHat);
   CSideRefVec3 =  G4ThreeVector(CLHEP::HepZHat);
   CParticlePos = G4ThreeVector(0,0,0);
+  ConfineWorld = 0;
+  ConfineRevision = -1;
+  GridWorld = 0;
+  GridRevision = -1;
+  NTried = 0.;
+  NAccepted = 0.;
 }
 
 G4SPSPosDistribution::G4SPSPosDistribution() : PosRndm(0)
@@ -85,6 +99,8 @@ G4SPSPosDistribution::G4SPSPosDistribution() : PosRndm(0)
   ParPhi = 0.;
   Confine = false; //If true confines source distribution to VolName
   VolName = "NULL";
+  ConfineRevision = 0;
+  ConfineGridBins = 0;
   verbosityLevel = 0 ;
   G4MUTEXINIT(a_mutex);
 }
@@ -97,16 +113,19 @@ G4SPSPosDistribution::~G4SPSPosDistribution()
 void G4SPSPosDistribution::SetPosDisType(G4String PosType)
 {
     SourcePosType = PosType;
+    ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetPosDisShape(G4String shapeType)
 {
      Shape = shapeType;
+     ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetCentreCoords(G4ThreeVector coordsOfCentre)
 {
   CentreCoords = coordsOfCentre;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetPosRot1(G4ThreeVector posrot1)
@@ -135,21 +154,25 @@ void G4SPSPosDistribution::SetPosRot2(G4ThreeVector posrot2)
 void G4SPSPosDistribution::SetHalfX(G4double xhalf)
 {
   halfx = xhalf;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetHalfY(G4double yhalf)
 {
   halfy = yhalf;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetHalfZ(G4double zhalf)
 {
   halfz = zhalf;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetRadius(G4double rds)
 {
   Radius = rds;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetRadius0(G4double rds)
@@ -176,16 +199,19 @@ void G4SPSPosDistribution::SetBeamSigmaInY(G4double r)
 void G4SPSPosDistribution::SetParAlpha(G4double paralp)
 {
   ParAlpha = paralp;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetParTheta(G4double parthe)
 {
   ParTheta = parthe;
+  ++ConfineRevision;
 }
 
 void G4SPSPosDistribution::SetParPhi(G4double parphi)
 {
   ParPhi = parphi;
+  ++ConfineRevision;
 }
 
 G4String G4SPSPosDistribution::GetPosDisType() const
@@ -266,6 +292,7 @@ void G4SPSPosDistribution::GenerateRotationMatrices()
   Rotz = Rotz.unit();
   Roty =Rotz.cross(Rotx); // y'
   Roty =Roty.unit();
+  ++ConfineRevision;
   if(verbosityLevel == 2)
     {
       G4cout << "The new axes, x', y', z' " << Rotx << " " << Roty << " " << Rotz << G4endl;
@@ -275,6 +302,7 @@ void G4SPSPosDistribution::GenerateRotationMatrices()
 void G4SPSPosDistribution::ConfineSourceToVolume(G4String Vname)
 {
   VolName = Vname;
+  ++ConfineRevision;
   if(verbosityLevel == 2)
     G4cout << VolName << G4endl;
   G4VPhysicalVolume *tempPV      = NULL;
@@ -1020,6 +1048,35 @@ void G4SPSPosDistribution::GeneratePointsInVolume(G4ThreeVector& pos)
     } 
 }
 
+G4Navigator* G4SPSPosDistribution::GetConfineNavigator(thread_data_t& td)
+{
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking()->GetWorldVolume();
+  if(!confineNavigator)
+    {
+      confineNavigator = new G4Navigator();
+      G4AutoDelete::Register(confineNavigator);
+    }
+  if(confineNavigator->GetWorldVolume() != world)
+    confineNavigator->SetWorldVolume(world);
+
+  // Resolve VolName to volume pointers, instead of comparing the names
+  // of the volumes found for each point
+  if(td.ConfineRevision != ConfineRevision || td.ConfineWorld != world)
+    {
+      td.ConfineVolumes.clear();
+      G4PhysicalVolumeStore* PVStore = G4PhysicalVolumeStore::GetInstance();
+      for(size_t i=0; i<PVStore->size(); i++)
+        {
+          if((*PVStore)[i]->GetName() == VolName)
+            td.ConfineVolumes.push_back((*PVStore)[i]);
+        }
+      td.ConfineRevision = ConfineRevision;
+      td.ConfineWorld = world;
+    }
+  return confineNavigator;
+}
+
 G4bool G4SPSPosDistribution::IsSourceConfined(G4ThreeVector& pos)
 {
   // Method to check point is within the volume specified
@@ -1029,15 +1086,19 @@ G4bool G4SPSPosDistribution::IsSourceConfined(G4ThreeVector& pos)
   G4ThreeVector *ptr;
   ptr = &null;
 
+  thread_data_t& td = ThreadData.Get();
+  G4Navigator* gNavigator = GetConfineNavigator(td);
+
   // Check position is within VolName, if so true,
   // else false
   G4VPhysicalVolume *theVolume;
-  G4Navigator *gNavigator =G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+  td.NTried += 1.;
   theVolume=gNavigator->LocateGlobalPointAndSetup(pos,ptr,true);
   if(!theVolume) return(false);
-  G4String theVolName = theVolume->GetName();
-  if(theVolName == VolName)
+  if(std::find(td.ConfineVolumes.begin(),td.ConfineVolumes.end(),theVolume)
+     != td.ConfineVolumes.end())
     {
+      td.NAccepted += 1.;
       if(verbosityLevel >= 1)
 	G4cout << "Particle is in volume " << VolName << G4endl;
       return(true);
@@ -1046,12 +1107,180 @@ G4bool G4SPSPosDistribution::IsSourceConfined(G4ThreeVector& pos)
     return(false);
 }
 
+G4double G4SPSPosDistribution::GetConfinementAcceptance() const
+{
+  const thread_data_t& td = ThreadData.Get();
+  if(td.NTried == 0.) return 1.;
+  return td.NAccepted/td.NTried;
+}
+
+G4ThreeVector G4SPSPosDistribution::LocalVolumePoint(G4double rx, G4double ry,
+                                                     G4double rz) const
+{
+  // Same mapping of the random numbers as GeneratePointsInVolume()
+  if(Shape == "Sphere")
+    return G4ThreeVector((rx*2.*Radius) - Radius, (ry*2.*Radius) - Radius,
+                         (rz*2.*Radius) - Radius);
+  else if(Shape == "Cylinder")
+    return G4ThreeVector((rx*2.*Radius) - Radius, (ry*2.*Radius) - Radius,
+                         (rz*2.*halfz) - halfz);
+  return G4ThreeVector((rx*2.*halfx) - halfx, (ry*2.*halfy) - halfy,
+                       (rz*2.*halfz) - halfz);
+}
+
+G4bool G4SPSPosDistribution::IsInVolumeShape(const G4ThreeVector& p) const
+{
+  if(Shape == "Sphere")
+    return p.mag2() <= Radius*Radius;
+  else if(Shape == "Ellipsoid")
+    return ((p.x()*p.x())/(halfx*halfx)) + ((p.y()*p.y())/(halfy*halfy))
+      + ((p.z()*p.z())/(halfz*halfz)) <= 1.;
+  else if(Shape == "Cylinder")
+    return p.perp2() <= Radius*Radius;
+  return true;
+}
+
+G4ThreeVector G4SPSPosDistribution::VolumePointToGlobal(const G4ThreeVector& p) const
+{
+  G4double x = p.x(), y = p.y(), z = p.z();
+  if(Shape == "Para")
+    {
+      x = x + z*std::tan(ParTheta)*std::cos(ParPhi) + y*std::tan(ParAlpha);
+      y = y + z*std::tan(ParTheta)*std::sin(ParPhi);
+    }
+  return CentreCoords + x*Rotx + y*Roty + z*Rotz;
+}
+
+void G4SPSPosDistribution::SetConfineGridBins(G4int n)
+{
+  ConfineGridBins = (n > 0) ? n : 0;
+  ++ConfineRevision;
+}
+
+G4int G4SPSPosDistribution::GetConfineGridBins() const
+{
+  return ConfineGridBins;
+}
+
+G4bool G4SPSPosDistribution::UpdateConfineGrid(thread_data_t& td)
+{
+  G4Navigator* gNavigator = GetConfineNavigator(td);
+  if(td.GridRevision == ConfineRevision && td.GridWorld == td.ConfineWorld)
+    return !td.GridCells.empty();
+  td.GridCells.clear();
+  td.GridRevision = ConfineRevision;
+  td.GridWorld = td.ConfineWorld;
+  if(!td.GridWorld) return false;
+
+  // The mapping of the random numbers to positions is affine, so all
+  // the cells have the same half diagonal in the global frame
+  const G4int n = ConfineGridBins;
+  const G4double h = 0.5/n;
+  const G4ThreeVector c0 = VolumePointToGlobal(LocalVolumePoint(0.5,0.5,0.5));
+  G4double halfDiagonal = 0.;
+  for(G4int sx=-1; sx<=1; sx+=2)
+    for(G4int sy=-1; sy<=1; sy+=2)
+      {
+        G4ThreeVector corner
+          = VolumePointToGlobal(LocalVolumePoint(0.5+sx*h,0.5+sy*h,0.5+h));
+        halfDiagonal = std::max(halfDiagonal,(corner-c0).mag());
+      }
+
+  // A cell whose centre is further than its half diagonal from any
+  // boundary is entirely in the volume found at its centre
+  G4int nInside = 0;
+  for(G4int iz=0; iz<n; iz++)
+    for(G4int iy=0; iy<n; iy++)
+      for(G4int ix=0; ix<n; ix++)
+        {
+          G4ThreeVector centre = VolumePointToGlobal(
+            LocalVolumePoint((ix+0.5)/n,(iy+0.5)/n,(iz+0.5)/n));
+          G4int cell = 2*(ix + n*(iy + n*iz));
+          G4VPhysicalVolume* pv
+            = gNavigator->LocateGlobalPointAndSetup(centre,0,true);
+          if(!pv)
+            {
+              td.GridCells.push_back(cell);
+              continue;
+            }
+          G4double safety = gNavigator->ComputeSafety(centre,halfDiagonal);
+          G4bool inVolume = std::find(td.ConfineVolumes.begin(),
+                                      td.ConfineVolumes.end(),pv)
+                            != td.ConfineVolumes.end();
+          if(safety < halfDiagonal)
+            td.GridCells.push_back(cell);
+          else if(inVolume)
+            {
+              td.GridCells.push_back(cell+1);
+              nInside++;
+            }
+        }
+
+  if(verbosityLevel >= 1)
+    G4cout << "Confinement grid of " << VolName << " : " << n*n*n
+           << " cells, " << nInside << " inside, "
+           << td.GridCells.size() - nInside << " on the boundary" << G4endl;
+  return !td.GridCells.empty();
+}
+
+G4bool G4SPSPosDistribution::GeneratePointsInGrid(G4ThreeVector& pos)
+{
+  if(SourcePosType != "Volume") return false;
+  if(Shape != "Sphere" && Shape != "Ellipsoid" && Shape != "Cylinder"
+     && Shape != "Para") return false;
+  if(PosRndm->IsPositionBiased()) return false;
+  thread_data_t& td = ThreadData.Get();
+  if(!UpdateConfineGrid(td)) return false;
+
+  // All the cells have the same probability, a point is then drawn
+  // uniformly in the cell and in the shape
+  const G4int n = ConfineGridBins;
+  const size_t nCells = td.GridCells.size();
+  G4ThreeVector localP;
+  for(G4int LoopCount=0; LoopCount<100000; LoopCount++)
+    {
+      size_t i = size_t(G4UniformRand()*nCells);
+      if(i >= nCells) i = nCells-1;
+      const G4int cell = td.GridCells[i];
+      const G4int idx = cell/2;
+      G4double rx = (idx%n + G4UniformRand())/n;
+      G4double ry = ((idx/n)%n + G4UniformRand())/n;
+      G4double rz = (idx/(n*n) + G4UniformRand())/n;
+      localP = LocalVolumePoint(rx,ry,rz);
+      if(!IsInVolumeShape(localP)) continue;
+      pos = VolumePointToGlobal(localP);
+      if((cell%2) == 1 || IsSourceConfined(pos))
+        {
+          // Cosine-law reference vectors as in GeneratePointsInVolume()
+          G4ThreeVector zdash = (pos - CentreCoords).unit();
+          G4ThreeVector xdash = Rotz.cross(zdash);
+          G4ThreeVector ydash = xdash.cross(zdash);
+          td.CSideRefVec1 = xdash.unit();
+          td.CSideRefVec2 = ydash.unit();
+          td.CSideRefVec3 = zdash.unit();
+          if(verbosityLevel >= 1)
+            G4cout << "Rotated and translated position " << pos << G4endl;
+          return true;
+        }
+    }
+  G4ExceptionDescription msg;
+  msg << "LoopCount = 100000\n";
+  msg << "No point of the source distribution found in the\n";
+  msg << "confinement grid cells of " << VolName << "\n";
+  msg << "The confine condition is ignored for this event.\n" << G4endl;
+  G4Exception("G4SPSPosDistribution::GenerateOne()","G4GPS001",JustWarning,msg);
+  pos = VolumePointToGlobal(localP);
+  return true;
+}
+
 G4ThreeVector G4SPSPosDistribution::GenerateOne()
 {
   //
   G4ThreeVector localP;
   G4bool srcconf = false;
   G4int LoopCount = 0;
+  if(Confine == true && ConfineGridBins > 0 && GeneratePointsInGrid(localP))
+    srcconf = true; // the point has been drawn in the confinement grid
   while(srcconf == false)
     {
       if(SourcePosType == "Point")
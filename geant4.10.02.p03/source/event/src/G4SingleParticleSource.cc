@@ -68,6 +68,10 @@ G4SingleParticleSource::part_prop_t::part_prop_t() {
   position = G4ThreeVector();
 }
 
+G4SingleParticleSource::primary_buffer_t::primary_buffer_t()
+  : nVertices(0), next(0), nParticles(0), revision(-1), definition(0) {
+}
+
 G4SingleParticleSource::G4SingleParticleSource() {
 //	// Initialise all variables
 //	// Position distribution Variables
@@ -93,6 +97,9 @@ G4SingleParticleSource::G4SingleParticleSource() {
 	eneGenerator = new G4SPSEneDistribution();
 	eneGenerator->SetBiasRndm(biasRndm);
 
+	primaryBatchSize = 0;
+	bufferRevision = 0;
+
 	// verbosity
 	verbosityLevel = 0;
     
@@ -123,6 +130,69 @@ void G4SingleParticleSource::SetParticleDefinition(
 	charge = aParticleDefinition->GetPDGCharge();
 }
 
+void G4SingleParticleSource::SetPrimaryBatchSize(G4int n) {
+	primaryBatchSize = (n > 1) ? n : 0;
+	FlushPrimaryBuffer();
+}
+
+G4bool G4SingleParticleSource::FindBufferedVertex(primary_buffer_t& buffer,
+		const CLHEP::PhiloxEngine& eventEngine) {
+	if (buffer.revision != bufferRevision
+	    || buffer.nParticles != NumberOfParticlesToBeGenerated
+	    || buffer.definition != definition)
+		return false;
+	// Vertices of events skipped by this thread are dropped
+	const std::vector<unsigned long> state = eventEngine.put();
+	for (size_t i = buffer.next; i < buffer.nVertices; i++) {
+		if (buffer.startState[i] == state) {
+			buffer.next = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+void G4SingleParticleSource::FillPrimaryBuffer(primary_buffer_t& buffer,
+		const CLHEP::PhiloxEngine& eventEngine) {
+	// Same sampling sequence as GeneratePrimaryVertex(), for the vertices
+	// of the n events following the current one, each from the stream of
+	// its event at the position reached by the stream of the current event
+	const size_t n = primaryBatchSize;
+	const G4int np = NumberOfParticlesToBeGenerated;
+	buffer.position.resize(n);
+	buffer.direction.resize(n*np);
+	buffer.energy.resize(n*np);
+	buffer.weight.resize(n*np);
+	buffer.startState.resize(n);
+	buffer.endState.resize(n);
+	unsigned long id0, id1;
+	eventEngine.getStream(id0, id1);
+	const std::vector<unsigned long> state = eventEngine.put();
+	CLHEP::HepRandomEngine* engineOfEvent = G4Random::getTheEngine();
+	G4Random::setTheEngine(&buffer.engine);
+	for (size_t i = 0; i < n; i++) {
+		buffer.engine.get(state);
+		buffer.engine.changeStream(id0, id1 + i + 1);
+		buffer.startState[i] = buffer.engine.put();
+		buffer.position[i] = posGenerator->GenerateOne();
+		for (G4int j = 0; j < np; j++) {
+			const size_t k = i*np + j;
+			buffer.direction[k] = angGenerator->GenerateOne();
+			buffer.energy[k] = eneGenerator->GenerateOne(definition);
+			buffer.weight[k] = eneGenerator->GetWeight()*biasRndm->GetBiasWeight();
+		}
+		buffer.endState[i] = buffer.engine.put();
+	}
+	G4Random::setTheEngine(engineOfEvent);
+	buffer.nVertices = n;
+	buffer.next = 0;
+	buffer.nParticles = np;
+	buffer.revision = bufferRevision;
+	buffer.definition = definition;
+	if (verbosityLevel > 1)
+		G4cout << " " << n << " vertices pre-sampled" << G4endl;
+}
+
 void G4SingleParticleSource::GeneratePrimaryVertex(G4Event *evt) {
 
     //G4AutoLock l(&mutex);
@@ -138,17 +208,52 @@ void G4SingleParticleSource::GeneratePrimaryVertex(G4Event *evt) {
 				<<NumberOfParticlesToBeGenerated << G4endl;
 
         part_prop_t& pp = ParticleProperties.Get();
+	primary_buffer_t* buffer = 0;
+	CLHEP::PhiloxEngine* eventEngine = 0;
+	if (primaryBatchSize > 1) {
+		eventEngine = dynamic_cast<CLHEP::PhiloxEngine*>(G4Random::getTheEngine());
+		if (eventEngine) {
+			buffer = &PrimaryBuffer.Get();
+			if (!FindBufferedVertex(*buffer, *eventEngine)) {
+				// This event is sampled directly, the following ones
+				// are pre-sampled
+				FillPrimaryBuffer(*buffer, *eventEngine);
+				buffer = 0;
+			}
+		} else {
+			static G4ThreadLocal G4bool warned = false;
+			if (!warned) {
+				G4Exception("G4SingleParticleSource::GeneratePrimaryVertex",
+					"Event0311", JustWarning,
+					"/gps/pipeline requires per-event random streams (/random/eventStreams). Vertices are sampled one per event.");
+				warned = true;
+			}
+		}
+	}
 	// Position stuff
-	pp.position = posGenerator->GenerateOne();
+	if (buffer)
+		pp.position = buffer->position[buffer->next];
+	else
+		pp.position = posGenerator->GenerateOne();
 
 	// create a new vertex
 	G4PrimaryVertex* vertex = new G4PrimaryVertex(pp.position,time);
 
 	for (G4int i = 0; i < NumberOfParticlesToBeGenerated; i++) {
-		// Angular stuff
-		pp.momentum_direction = angGenerator->GenerateOne();
-		// Energy stuff
-		pp.energy = eneGenerator->GenerateOne(definition);
+		G4double weight;
+		if (buffer) {
+			const size_t k = buffer->next*NumberOfParticlesToBeGenerated + i;
+			pp.momentum_direction = buffer->direction[k];
+			pp.energy = buffer->energy[k];
+			weight = buffer->weight[k];
+		} else {
+			// Angular stuff
+			pp.momentum_direction = angGenerator->GenerateOne();
+			// Energy stuff
+			pp.energy = eneGenerator->GenerateOne(definition);
+			// Set bweight equal to the multiple of all non-zero weights
+			weight = eneGenerator->GetWeight()*biasRndm->GetBiasWeight();
+		}
 
 		if (verbosityLevel >= 2)
 			G4cout << "Creating primaries and assigning to vertex" << G4endl;
@@ -171,8 +276,6 @@ void G4SingleParticleSource::GeneratePrimaryVertex(G4Event *evt) {
 			G4cout << "    Direction: " << pp.momentum_direction
 					<< G4endl;
 		}
-		// Set bweight equal to the multiple of all non-zero weights
-		G4double weight = eneGenerator->GetWeight()*biasRndm->GetBiasWeight();
 		// pass it to primary particle
 		particle->SetWeight(weight);
 
@@ -182,6 +285,11 @@ void G4SingleParticleSource::GeneratePrimaryVertex(G4Event *evt) {
 	// now pass the weight to the primary vertex. CANNOT be used here!
 	//  vertex->SetWeight(particle_weight);
 	evt->AddPrimaryVertex(vertex);
+	if (buffer) {
+		// Skip the numbers drawn for this vertex when it was pre-sampled
+		eventEngine->get(buffer->endState[buffer->next]);
+		++buffer->next;
+	}
 	if (verbosityLevel > 1)
 		G4cout << " Primary Vetex generated !" << G4endl;
 }
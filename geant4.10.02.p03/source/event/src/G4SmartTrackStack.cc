@@ -80,6 +80,11 @@ void G4SmartTrackStack::TransferTo(G4TrackStack* aStack)
   nTracks = 0;
 }
 
+void G4SmartTrackStack::TransferFrom(G4TrackStack* aStack)
+{
+  while(aStack->GetNTrack()) { PushToStack(aStack->PopFromStack()); }
+}
+
 G4StackedTrack G4SmartTrackStack::PopFromStack()
 {
 	G4StackedTrack aStackedTrack;
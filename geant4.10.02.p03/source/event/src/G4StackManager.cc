@@ -32,23 +32,111 @@
 
 #include "G4StackManager.hh"
 #include "G4StackingMessenger.hh"
+#include "G4StackSpillFile.hh"
+#include "G4DynamicParticle.hh"
 #include "G4VTrajectory.hh"
 #include "evmandefs.hh"
 #include "G4ios.hh"
 
 G4StackManager::G4StackManager()
-:userStackingAction(0),verboseLevel(0),numberOfAdditionalWaitingStacks(0)
+:userStackingAction(0),verboseLevel(0),numberOfAdditionalWaitingStacks(0),
+ spillFile(0),spillableUrgentStack(0),spillMemoryLimit(0.),spillThreshold(0),
+ spillBlockSize(10000),spillDirectory(".")
 {
   theMessenger = new G4StackingMessenger(this);
 #ifdef G4_USESMARTSTACK
   urgentStack = new G4SmartTrackStack;
  // G4cout<<"+++ G4StackManager uses G4SmartTrackStack. +++"<<G4endl;
 #else
-  urgentStack = new G4TrackStack(5000);
+  urgentStack = new G4DefaultTrackStack(5000);
 //  G4cout<<"+++ G4StackManager uses ordinary G4TrackStack. +++"<<G4endl;
 #endif
   waitingStack = new G4TrackStack(1000);
   postponeStack = new G4TrackStack(1000);
+  G4DefaultTrackStack* defaultStack = dynamic_cast<G4DefaultTrackStack*>(urgentStack);
+  spillableUrgentStack = defaultStack ? defaultStack->GetTrackStack() : 0;
+}
+
+void G4StackManager::SetUrgentStack(G4VTrackStack* aStack)
+{
+  if(aStack==urgentStack) return;
+  ReloadSpilledTracks(G4StackSpillFile::urgentIndex,true);
+  G4TrackStack tmpStack;
+  urgentStack->TransferTo(&tmpStack);
+  tmpStack.TransferTo(aStack);
+  delete urgentStack;
+  urgentStack = aStack;
+  G4DefaultTrackStack* defaultStack = dynamic_cast<G4DefaultTrackStack*>(urgentStack);
+  spillableUrgentStack = defaultStack ? defaultStack->GetTrackStack() : 0;
+}
+
+void G4StackManager::SetSpillMemoryLimit(G4double limitInMB)
+{
+  if(limitInMB < 0.) limitInMB = 0.;
+  spillMemoryLimit = limitInMB;
+  // Approximate memory used by a stacked track, its dynamic particle and
+  // the pool overhead of their allocators
+  static const G4double bytesPerTrack
+    = sizeof(G4Track)+sizeof(G4DynamicParticle)+sizeof(G4StackedTrack)+32;
+  spillThreshold = G4int(limitInMB*1024.*1024./bytesPerTrack);
+  if(limitInMB > 0. && spillThreshold < 2) spillThreshold = 2;
+  if(spillThreshold==0 && spillFile)
+  {
+    ReloadSpilledTracks(G4StackSpillFile::urgentIndex,true);
+    ReloadSpilledTracks(G4StackSpillFile::waitingIndex,true);
+    delete spillFile;
+    spillFile = 0;
+  }
+}
+
+void G4StackManager::SetSpillBlockSize(G4int nTracks)
+{
+  spillBlockSize = (nTracks > 0) ? nTracks : 1;
+}
+
+void G4StackManager::SetSpillDirectory(const G4String& dirName)
+{
+  if(dirName==spillDirectory) return;
+  spillDirectory = dirName;
+  // The scratch file is created again in the new directory when needed
+  if(spillFile && GetNSpilledTrack()==0)
+  {
+    delete spillFile;
+    spillFile = 0;
+  }
+}
+
+G4int G4StackManager::GetNSpilledTrack() const
+{
+  if(!spillFile) return 0;
+  return spillFile->GetNTrack(G4StackSpillFile::urgentIndex)
+       + spillFile->GetNTrack(G4StackSpillFile::waitingIndex);
+}
+
+void G4StackManager::CheckSpill()
+{
+  if(spillThreshold<=0) return;
+  if(waitingStack->GetNTrack()+urgentStack->GetNTrack() <= spillThreshold) return;
+
+  // A block must not be larger than half of the tracks allowed in memory,
+  // otherwise reloading it would trigger a new spill at once
+  G4int nBlock = spillBlockSize;
+  if(nBlock > spillThreshold/2) nBlock = spillThreshold/2;
+  if(!spillFile) spillFile = new G4StackSpillFile(spillDirectory);
+  if(waitingStack->GetNTrack() >= nBlock)
+  { spillFile->Spill(waitingStack,nBlock,G4StackSpillFile::waitingIndex); }
+  else if(spillableUrgentStack && spillableUrgentStack->GetNTrack() >= nBlock)
+  { spillFile->Spill(spillableUrgentStack,nBlock,G4StackSpillFile::urgentIndex); }
+}
+
+G4int G4StackManager::ReloadSpilledTracks(G4int index, G4bool all)
+{
+  if(!spillFile || spillFile->GetNTrack(index)==0) return 0;
+  if(index==G4StackSpillFile::waitingIndex)
+  { return spillFile->Reload(waitingStack,index,all); }
+  else if(spillableUrgentStack)
+  { return spillFile->Reload(spillableUrgentStack,index,all); }
+  return 0;
 }
 
 G4StackManager::~G4StackManager()
@@ -60,9 +148,15 @@ G4StackManager::~G4StackManager()
   {
     G4cout << "++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++" << G4endl;
     G4cout << " Maximum number of tracks in the urgent stack : " << urgentStack->GetMaxNTrack() << G4endl;
+    if(spillFile)
+    {
+      G4cout << " Maximum number of tracks spilled to " << spillFile->GetFileName()
+             << " : " << spillFile->GetMaxNTrack() << G4endl;
+    }
     G4cout << "++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++" << G4endl;
   }
 #endif
+  delete spillFile;
   delete urgentStack;
   delete waitingStack;
   delete postponeStack;
@@ -206,6 +300,7 @@ G4int G4StackManager::PushOneTrack(G4Track *newTrack,G4VTrajectory *newTrajector
         }
         break;
     }
+    if(classification==fUrgent || classification==fWaiting) CheckSpill();
   }
 
   return GetNUrgentTrack();
@@ -228,6 +323,15 @@ G4Track * G4StackManager::PopNextTrack(G4VTrajectory**newTrajectory)
     if( verboseLevel > 1 ) G4cout << "### " << GetNWaitingTrack()
                       << " waiting tracks are re-classified to" << G4endl;
 #endif
+    if(spillFile && spillFile->GetNTrack(G4StackSpillFile::waitingIndex)>0)
+    {
+      // The urgent stack is empty, spilled waiting tracks become the
+      // spilled urgent tracks below the transferred ones
+      if(spillableUrgentStack)
+      { spillFile->MoveBlocks(G4StackSpillFile::waitingIndex,G4StackSpillFile::urgentIndex); }
+      else
+      { ReloadSpilledTracks(G4StackSpillFile::waitingIndex,true); }
+    }
     waitingStack->TransferTo(urgentStack);
     if(numberOfAdditionalWaitingStacks>0) {
       for(int i=0;i<numberOfAdditionalWaitingStacks;i++) {
@@ -247,6 +351,9 @@ G4Track * G4StackManager::PopNextTrack(G4VTrajectory**newTrajectory)
     if( ( GetNUrgentTrack()==0 ) && ( GetNWaitingTrack()==0 ) ) return 0;
   }
 
+  if(urgentStack->GetNTrack()==0)
+  { ReloadSpilledTracks(G4StackSpillFile::urgentIndex,false); }
+
   G4StackedTrack selectedStackedTrack = urgentStack->PopFromStack();
   G4Track * selectedTrack = selectedStackedTrack.GetTrack();
   *newTrajectory = selectedStackedTrack.GetTrajectory();
@@ -265,6 +372,33 @@ G4Track * G4StackManager::PopNextTrack(G4VTrajectory**newTrajectory)
   return selectedTrack;
 }
 
+G4int G4StackManager::ExtractFreshUrgentTracks(G4int nTracks,
+                                               std::vector<G4Track*>& tracks)
+{
+  G4int nExtracted = 0;
+  std::vector<G4StackedTrack> kept;
+  while( nExtracted < nTracks )
+  {
+    // Spilled tracks are older than all the tracks in memory, they are
+    // read back below the tracks not visited yet
+    if( urgentStack->GetNTrack()==0
+        && ReloadSpilledTracks(G4StackSpillFile::urgentIndex,false)==0 ) break;
+    G4StackedTrack aStackedTrack = urgentStack->PopFromStack();
+    G4Track* aTrack = aStackedTrack.GetTrack();
+    if( aStackedTrack.GetTrajectory() || aTrack->GetCurrentStepNumber() > 0 )
+    { kept.push_back(aStackedTrack); }
+    else
+    {
+      tracks.push_back(aTrack);
+      nExtracted++;
+    }
+  }
+  // put back the others in their original order
+  for(G4int i=kept.size()-1;i>=0;i--)
+  { urgentStack->PushToStack(kept[i]); }
+  return nExtracted;
+}
+
 void G4StackManager::ReClassify()
 {
   G4StackedTrack aStackedTrack;
@@ -273,6 +407,7 @@ void G4StackManager::ReClassify()
   if( !userStackingAction ) return;
   if( GetNUrgentTrack() == 0 ) return;
   
+  ReloadSpilledTracks(G4StackSpillFile::urgentIndex,true);
   urgentStack->TransferTo(&tmpStack);
   while( tmpStack.GetNTrack() > 0 )
   {
@@ -314,6 +449,7 @@ G4int G4StackManager::PrepareNewEvent()
   if(userStackingAction) userStackingAction->PrepareNewEvent();
   
   urgentStack->clearAndDestroy(); // Set the urgentStack in a defined state. Not doing it would affect reproducibility.
+  if(spillFile) spillFile->Clear(G4StackSpillFile::urgentIndex);
   
   G4int n_passedFromPrevious = 0;
   
@@ -405,6 +541,10 @@ void G4StackManager::TransferStackedTracks(G4ClassificationOfNewTrack origin, G4
 {
   if(origin==destination) return;
   if(origin==fKill) return;
+  if(origin==fUrgent)
+  { ReloadSpilledTracks(G4StackSpillFile::urgentIndex,true); }
+  else if(origin==fWaiting)
+  { ReloadSpilledTracks(G4StackSpillFile::waitingIndex,true); }
   G4TrackStack* originStack = 0;
   switch(origin)
   {
@@ -466,6 +606,10 @@ void G4StackManager::TransferOneStackedTrack(G4ClassificationOfNewTrack origin,
 {
   if(origin==destination) return;
   if(origin==fKill) return;
+  if(origin==fUrgent && urgentStack->GetNTrack()==0)
+  { ReloadSpilledTracks(G4StackSpillFile::urgentIndex,false); }
+  else if(origin==fWaiting && waitingStack->GetNTrack()==0)
+  { ReloadSpilledTracks(G4StackSpillFile::waitingIndex,false); }
   G4TrackStack* originStack = 0;
   switch(origin)
   {
@@ -541,12 +685,14 @@ void G4StackManager::clear()
 void G4StackManager::ClearUrgentStack()
 {
   urgentStack->clearAndDestroy();
+  if(spillFile) spillFile->Clear(G4StackSpillFile::urgentIndex);
 }
 
 void G4StackManager::ClearWaitingStack(int i)
 {
   if(i==0) {
     waitingStack->clearAndDestroy();
+    if(spillFile) spillFile->Clear(G4StackSpillFile::waitingIndex);
   } else {
     if(i<=numberOfAdditionalWaitingStacks) additionalWaitingStacks[i-1]->clearAndDestroy();
   }
@@ -559,19 +705,26 @@ void G4StackManager::ClearPostponeStack()
 
 G4int G4StackManager::GetNTotalTrack() const
 {
-  int n = urgentStack->GetNTrack() + waitingStack->GetNTrack() + postponeStack->GetNTrack();
+  int n = urgentStack->GetNTrack() + waitingStack->GetNTrack() + postponeStack->GetNTrack()
+        + GetNSpilledTrack();
   for(int i=1;i<=numberOfAdditionalWaitingStacks;i++) {n += additionalWaitingStacks[i-1]->GetNTrack();}
   return n;
 }
 
 G4int G4StackManager::GetNUrgentTrack() const
 {
-  return urgentStack->GetNTrack();
+  G4int n = urgentStack->GetNTrack();
+  if(spillFile) n += spillFile->GetNTrack(G4StackSpillFile::urgentIndex);
+  return n;
 }
 
 G4int G4StackManager::GetNWaitingTrack(int i) const
 {
-  if(i==0) { return waitingStack->GetNTrack(); }
+  if(i==0) {
+    G4int n = waitingStack->GetNTrack();
+    if(spillFile) n += spillFile->GetNTrack(G4StackSpillFile::waitingIndex);
+    return n;
+  }
   else {
     if(i<=numberOfAdditionalWaitingStacks) { return additionalWaitingStacks[i-1]->GetNTrack();}
   }
@@ -0,0 +1,262 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#include "G4StackSpillFile.hh"
+#include "G4CompactTrackStack.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VTrajectory.hh"
+#include "G4Threading.hh"
+#include "G4ios.hh"
+#include <sstream>
+#include <cstdio>
+
+namespace
+{
+  enum { goodForTrackingFlag = 1, belowThresholdFlag = 2, stopButAliveFlag = 4 };
+}
+
+G4StackSpillFile::G4StackSpillFile(const G4String& dirName)
+  : isOpen(false), isBroken(false), fileEnd(0), maxNSpilled(0)
+{
+  std::ostringstream os;
+  os << dirName << "/G4StackSpill." << G4Threading::G4GetPidId()
+     << "." << G4Threading::G4GetThreadId();
+  fileName = os.str();
+  for(G4int i=0;i<nStacks;i++) nSpilled[i] = 0;
+}
+
+G4StackSpillFile::~G4StackSpillFile()
+{
+  for(G4int i=0;i<nStacks;i++) Clear(i);
+  if(isOpen)
+  {
+    file.close();
+    std::remove(fileName.c_str());
+  }
+}
+
+G4bool G4StackSpillFile::Open()
+{
+  if(isOpen) return true;
+  if(isBroken) return false;
+  file.open(fileName.c_str(),
+            std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+  if(!file.is_open())
+  {
+    isBroken = true;
+    G4ExceptionDescription ED;
+    ED << "Scratch file <" << fileName << "> cannot be opened."
+       << " Stacked tracks are kept in memory.";
+    G4Exception("G4StackSpillFile::Open","Event0231",JustWarning,ED);
+    return false;
+  }
+  isOpen = true;
+  return true;
+}
+
+G4int G4StackSpillFile::Spill(G4TrackStack* aStack, G4int nTracks, G4int index)
+{
+  if(nTracks > aStack->GetNTrack()) nTracks = aStack->GetNTrack();
+  if(nTracks <= 0 || !Open()) return 0;
+
+  Block aBlock;
+  aBlock.offset = fileEnd;
+  aBlock.nRecords = nTracks;
+  buffer.resize(nTracks);
+  for(G4int i=0;i<nTracks;i++)
+  {
+    const G4StackedTrack& aStackedTrack = (*aStack)[i];
+    G4StackSpillRecord& rec = buffer[i];
+    if(!G4CompactTrackStack::IsCompactable(aStackedTrack))
+    {
+      rec = G4StackSpillRecord();
+      rec.particle = 0;
+      rec.trackID = G4int(aBlock.keptTracks.size());
+      aBlock.keptTracks.push_back(aStackedTrack);
+      continue;
+    }
+    const G4Track* aTrack = aStackedTrack.GetTrack();
+    const G4DynamicParticle* dp = aTrack->GetDynamicParticle();
+    const G4ThreeVector& pos = aTrack->GetPosition();
+    const G4ThreeVector& dir = dp->GetMomentumDirection();
+    for(G4int j=0;j<3;j++)
+    {
+      rec.position[j] = pos[j];
+      rec.direction[j] = dir[j];
+    }
+    rec.kineticEnergy = dp->GetKineticEnergy();
+    rec.globalTime = aTrack->GetGlobalTime();
+    rec.localTime = aTrack->GetLocalTime();
+    rec.weight = aTrack->GetWeight();
+    rec.particle = dp->GetParticleDefinition();
+    rec.creatorProcess = aTrack->GetCreatorProcess();
+    rec.trackID = aTrack->GetTrackID();
+    rec.parentID = aTrack->GetParentID();
+    rec.creatorModel = aTrack->GetCreatorModelID();
+    rec.flags = 0;
+    if(aTrack->IsGoodForTracking()) rec.flags |= goodForTrackingFlag;
+    if(aTrack->IsBelowThreshold()) rec.flags |= belowThresholdFlag;
+    if(aTrack->GetTrackStatus()==fStopButAlive) rec.flags |= stopButAliveFlag;
+    aBlock.touchables.push_back(aTrack->GetTouchableHandle());
+  }
+
+  file.seekp(fileEnd);
+  file.write(reinterpret_cast<const char*>(&buffer[0]),
+             nTracks*sizeof(G4StackSpillRecord));
+  if(!file)
+  {
+    // Nothing has been removed from the stack yet
+    isBroken = true;
+    file.close();
+    isOpen = false;
+    std::remove(fileName.c_str());
+    G4ExceptionDescription ED;
+    ED << "Tracks cannot be written to the scratch file <" << fileName
+       << ">. Stacked tracks are kept in memory from now on.";
+    G4Exception("G4StackSpillFile::Spill","Event0232",JustWarning,ED);
+    return 0;
+  }
+  fileEnd += std::streamoff(nTracks*sizeof(G4StackSpillRecord));
+
+  for(G4int i=0;i<nTracks;i++)
+  { if(buffer[i].particle) delete (*aStack)[i].GetTrack(); }
+  aStack->erase(aStack->begin(),aStack->begin()+nTracks);
+
+  blocks[index].push_back(aBlock);
+  nSpilled[index] += nTracks;
+  if(nSpilled[0]+nSpilled[1] > maxNSpilled) maxNSpilled = nSpilled[0]+nSpilled[1];
+  return nTracks;
+}
+
+void G4StackSpillFile::ReadBlock(Block& aBlock, std::vector<G4StackedTrack>& tracks)
+{
+  buffer.resize(aBlock.nRecords);
+  file.seekg(aBlock.offset);
+  file.read(reinterpret_cast<char*>(&buffer[0]),
+            aBlock.nRecords*sizeof(G4StackSpillRecord));
+  if(!file)
+  {
+    G4ExceptionDescription ED;
+    ED << "Spilled tracks cannot be read back from the scratch file <"
+       << fileName << ">.";
+    G4Exception("G4StackSpillFile::ReadBlock","Event0233",FatalException,ED);
+    return;
+  }
+
+  size_t iTouchable = 0;
+  for(G4int i=0;i<aBlock.nRecords;i++)
+  {
+    const G4StackSpillRecord& rec = buffer[i];
+    if(!rec.particle)
+    {
+      tracks.push_back(aBlock.keptTracks[rec.trackID]);
+      continue;
+    }
+    G4DynamicParticle* dp = new G4DynamicParticle(rec.particle,
+      G4ThreeVector(rec.direction[0],rec.direction[1],rec.direction[2]),
+      rec.kineticEnergy);
+    G4Track* aTrack = new G4Track(dp,rec.globalTime,
+      G4ThreeVector(rec.position[0],rec.position[1],rec.position[2]));
+    aTrack->SetLocalTime(rec.localTime);
+    aTrack->SetWeight(rec.weight);
+    aTrack->SetTrackID(rec.trackID);
+    aTrack->SetParentID(rec.parentID);
+    aTrack->SetCreatorModelIndex(rec.creatorModel);
+    aTrack->SetCreatorProcess(rec.creatorProcess);
+    const G4TouchableHandle& touchable = aBlock.touchables[iTouchable++];
+    aTrack->SetTouchableHandle(touchable);
+    aTrack->SetOriginTouchableHandle(touchable);
+    aTrack->SetGoodForTrackingFlag((rec.flags & goodForTrackingFlag)!=0);
+    aTrack->SetBelowThresholdFlag((rec.flags & belowThresholdFlag)!=0);
+    if(rec.flags & stopButAliveFlag) aTrack->SetTrackStatus(fStopButAlive);
+    tracks.push_back(G4StackedTrack(aTrack));
+  }
+}
+
+G4int G4StackSpillFile::Reload(G4TrackStack* aStack, G4int index, G4bool all)
+{
+  std::vector<Block>& stackBlocks = blocks[index];
+  if(stackBlocks.empty()) return 0;
+
+  size_t first = all ? 0 : stackBlocks.size()-1;
+  std::vector<G4StackedTrack> tracks;
+  for(size_t i=first;i<stackBlocks.size();i++)
+  { ReadBlock(stackBlocks[i],tracks); }
+  stackBlocks.erase(stackBlocks.begin()+first,stackBlocks.end());
+  ReleaseSpace();
+
+  // Spilled tracks are older than all the tracks in memory
+  aStack->insert(aStack->begin(),tracks.begin(),tracks.end());
+  G4int n = G4int(tracks.size());
+  nSpilled[index] -= n;
+  return n;
+}
+
+void G4StackSpillFile::MoveBlocks(G4int from, G4int to)
+{
+  if(from==to || blocks[from].empty()) return;
+  blocks[to].insert(blocks[to].end(),blocks[from].begin(),blocks[from].end());
+  blocks[from].clear();
+  nSpilled[to] += nSpilled[from];
+  nSpilled[from] = 0;
+}
+
+void G4StackSpillFile::Clear(G4int index)
+{
+  std::vector<Block>& stackBlocks = blocks[index];
+  for(size_t i=0;i<stackBlocks.size();i++)
+  {
+    std::vector<G4StackedTrack>& kept = stackBlocks[i].keptTracks;
+    for(size_t j=0;j<kept.size();j++)
+    {
+      delete kept[j].GetTrack();
+      delete kept[j].GetTrajectory();
+    }
+  }
+  stackBlocks.clear();
+  nSpilled[index] = 0;
+  ReleaseSpace();
+}
+
+void G4StackSpillFile::ReleaseSpace()
+{
+  // The file is reused from the end of the last live block
+  fileEnd = 0;
+  for(G4int i=0;i<nStacks;i++)
+  {
+    for(size_t j=0;j<blocks[i].size();j++)
+    {
+      std::streamoff end = blocks[i][j].offset
+        + std::streamoff(blocks[i][j].nRecords*sizeof(G4StackSpillRecord));
+      if(end > fileEnd) fileEnd = end;
+    }
+  }
+}
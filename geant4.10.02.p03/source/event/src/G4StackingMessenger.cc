@@ -33,7 +33,17 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIparameter.hh"
+#include "G4TrackStack.hh"
+#include "G4DefaultTrackStack.hh"
+#include "G4SmartTrackStack.hh"
+#include "G4CompactTrackStack.hh"
+#include "G4PriorityTrackStack.hh"
 #include "G4ios.hh"
+#include "G4Tokenizer.hh"
+#include <cfloat>
 
 G4StackingMessenger::G4StackingMessenger(G4StackManager * fCont)
 :fContainer(fCont)
@@ -63,6 +73,118 @@ G4StackingMessenger::G4StackingMessenger(G4StackManager * fCont)
   verboseCmd->SetGuidance(" 2 : Detailed reports");
   verboseCmd->SetGuidance("Note - this value is overwritten by /event/verbose command.");
 
+  urgentStackCmd = new G4UIcmdWithAString("/event/stack/urgentStack",this);
+  urgentStackCmd->SetGuidance("Select the type of the urgent stack.");
+  urgentStackCmd->SetGuidance(" default : ordinary last-in-first-out stack (G4DefaultTrackStack)");
+  urgentStackCmd->SetGuidance(" smart   : dedicated stacks per particle type (G4SmartTrackStack)");
+  urgentStackCmd->SetGuidance(" compact : last-in-first-out stack storing fresh secondaries in");
+  urgentStackCmd->SetGuidance("           contiguous arrays (G4CompactTrackStack) once 128 newer");
+  urgentStackCmd->SetGuidance("           tracks are stacked. The G4Track object is created");
+  urgentStackCmd->SetGuidance("           again when such a track is popped.");
+  urgentStackCmd->SetGuidance(" priority: buckets by particle, region and energy processed in the");
+  urgentStackCmd->SetGuidance("           order of their priority (G4PriorityTrackStack). Define");
+  urgentStackCmd->SetGuidance("           the buckets with /event/stack/priority/ commands.");
+  urgentStackCmd->SetParameterName("type",false);
+  urgentStackCmd->SetCandidates("default smart compact priority");
+  urgentStackCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  priorityDir = new G4UIdirectory("/event/stack/priority/");
+  priorityDir->SetGuidance("Bucket definition of the priority urgent stack.");
+  priorityDir->SetGuidance("These commands are valid after /event/stack/urgentStack priority.");
+
+  addBucketCmd = new G4UIcommand("/event/stack/priority/addBucket",this);
+  addBucketCmd->SetGuidance("Add a bucket of tracks.");
+  addBucketCmd->SetGuidance("A track goes to the first bucket, in the order of definition,");
+  addBucketCmd->SetGuidance("whose particle, region and kinetic energy range [Emin,Emax) match.");
+  addBucketCmd->SetGuidance("Buckets with lower priority value are processed first.");
+  addBucketCmd->SetGuidance("Tracks matching no bucket go to the default bucket.");
+  addBucketCmd->SetGuidance("Emax = 0 stands for no upper limit.");
+  G4UIparameter* param;
+  param = new G4UIparameter("particle",'s',false);
+  param->SetGuidance("Particle name (all for any particle)");
+  addBucketCmd->SetParameter(param);
+  param = new G4UIparameter("region",'s',false);
+  param->SetGuidance("Region name (all for any region)");
+  addBucketCmd->SetParameter(param);
+  param = new G4UIparameter("Emin",'d',false);
+  param->SetParameterRange("Emin>=0.");
+  addBucketCmd->SetParameter(param);
+  param = new G4UIparameter("Emax",'d',false);
+  param->SetParameterRange("Emax>=0.");
+  addBucketCmd->SetParameter(param);
+  param = new G4UIparameter("unit",'s',true);
+  param->SetDefaultValue("MeV");
+  addBucketCmd->SetParameter(param);
+  param = new G4UIparameter("priority",'i',true);
+  param->SetDefaultValue(0);
+  addBucketCmd->SetParameter(param);
+  addBucketCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  energyBucketsCmd = new G4UIcommand("/event/stack/priority/energyBuckets",this);
+  energyBucketsCmd->SetGuidance("Add nBins buckets with logarithmic kinetic energy ranges");
+  energyBucketsCmd->SetGuidance("between Emin and Emax. Lower energies are processed first,");
+  energyBucketsCmd->SetGuidance("which bounds the number of stacked tracks of large showers.");
+  energyBucketsCmd->SetGuidance("Energies below Emin go to the first bucket and above Emax");
+  energyBucketsCmd->SetGuidance("to the last one.");
+  param = new G4UIparameter("nBins",'i',false);
+  param->SetParameterRange("nBins>0");
+  energyBucketsCmd->SetParameter(param);
+  param = new G4UIparameter("Emin",'d',false);
+  param->SetParameterRange("Emin>0.");
+  energyBucketsCmd->SetParameter(param);
+  param = new G4UIparameter("Emax",'d',false);
+  param->SetParameterRange("Emax>0.");
+  energyBucketsCmd->SetParameter(param);
+  param = new G4UIparameter("unit",'s',true);
+  param->SetDefaultValue("MeV");
+  energyBucketsCmd->SetParameter(param);
+  param = new G4UIparameter("particle",'s',true);
+  param->SetGuidance("Particle name (all for any particle)");
+  param->SetDefaultValue("all");
+  energyBucketsCmd->SetParameter(param);
+  param = new G4UIparameter("firstPriority",'i',true);
+  param->SetDefaultValue(0);
+  energyBucketsCmd->SetParameter(param);
+  energyBucketsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  defaultPriorityCmd = new G4UIcmdWithAnInteger("/event/stack/priority/defaultPriority",this);
+  defaultPriorityCmd->SetGuidance("Set the priority of the default bucket.");
+  defaultPriorityCmd->SetParameterName("priority",false);
+  defaultPriorityCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  clearBucketsCmd = new G4UIcmdWithoutParameter("/event/stack/priority/clearBuckets",this);
+  clearBucketsCmd->SetGuidance("Remove all the buckets but the default one.");
+  clearBucketsCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  listBucketsCmd = new G4UIcmdWithoutParameter("/event/stack/priority/list",this);
+  listBucketsCmd->SetGuidance("List the buckets in the order of processing.");
+
+  spillDir = new G4UIdirectory("/event/stack/spill/");
+  spillDir->SetGuidance("Overflow of the urgent and waiting stacks to a scratch file.");
+
+  spillLimitCmd = new G4UIcmdWithADouble("/event/stack/spill/memoryLimit",this);
+  spillLimitCmd->SetGuidance("Set the memory (in MB) of the tracks kept in the urgent");
+  spillLimitCmd->SetGuidance("and waiting stacks. Beyond this limit the oldest tracks are");
+  spillLimitCmd->SetGuidance("written to a scratch file in blocks, and read back when the");
+  spillLimitCmd->SetGuidance("tracks in memory are exhausted. 0 (default) means no limit.");
+  spillLimitCmd->SetGuidance("Tracks with user information or a trajectory stay in memory.");
+  spillLimitCmd->SetParameterName("limit",false);
+  spillLimitCmd->SetRange("limit>=0.");
+  spillLimitCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  spillBlockCmd = new G4UIcmdWithAnInteger("/event/stack/spill/blockSize",this);
+  spillBlockCmd->SetGuidance("Set the number of tracks written to or read from the");
+  spillBlockCmd->SetGuidance("scratch file at once (default 10000).");
+  spillBlockCmd->SetParameterName("nTracks",false);
+  spillBlockCmd->SetRange("nTracks>0");
+  spillBlockCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  spillDirCmd = new G4UIcmdWithAString("/event/stack/spill/directory",this);
+  spillDirCmd->SetGuidance("Set the directory of the scratch file (default current).");
+  spillDirCmd->SetGuidance("The file is G4StackSpill.<pid>.<thread> and is removed at exit.");
+  spillDirCmd->SetParameterName("dir",false);
+  spillDirCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
 }
 
 G4StackingMessenger::~G4StackingMessenger()
@@ -70,6 +192,17 @@ G4StackingMessenger::~G4StackingMessenger()
   delete statusCmd;
   delete clearCmd;
   delete verboseCmd;
+  delete urgentStackCmd;
+  delete addBucketCmd;
+  delete energyBucketsCmd;
+  delete defaultPriorityCmd;
+  delete clearBucketsCmd;
+  delete listBucketsCmd;
+  delete priorityDir;
+  delete spillLimitCmd;
+  delete spillBlockCmd;
+  delete spillDirCmd;
+  delete spillDir;
   delete stackDir;
 }
 
@@ -82,6 +215,11 @@ void G4StackingMessenger::SetNewValue(G4UIcommand * command,G4String newValues)
     G4cout << "    Urgent stack    : " << fContainer->GetNUrgentTrack() << G4endl;
     G4cout << "    Waiting stack   : " << fContainer->GetNWaitingTrack() << G4endl;
     G4cout << "    Postponed stack : " << fContainer->GetNPostponedTrack() << G4endl;
+    if(fContainer->GetSpillMemoryLimit()>0.)
+    {
+      G4cout << "    of which spilled to the scratch file : "
+             << fContainer->GetNSpilledTrack() << G4endl;
+    }
   }
   else if( command==clearCmd )
   {
@@ -107,5 +245,82 @@ void G4StackingMessenger::SetNewValue(G4UIcommand * command,G4String newValues)
   {
     fContainer->SetVerboseLevel(verboseCmd->GetNewIntValue(newValues));
   }
+  else if( command==urgentStackCmd )
+  {
+    if(newValues=="smart")
+    { fContainer->SetUrgentStack(new G4SmartTrackStack); }
+    else if(newValues=="compact")
+    { fContainer->SetUrgentStack(new G4CompactTrackStack(5000)); }
+    else if(newValues=="priority")
+    { fContainer->SetUrgentStack(new G4PriorityTrackStack); }
+    else
+    { fContainer->SetUrgentStack(new G4DefaultTrackStack(5000)); }
+  }
+  else if( command==spillLimitCmd )
+  {
+    fContainer->SetSpillMemoryLimit(spillLimitCmd->GetNewDoubleValue(newValues));
+  }
+  else if( command==spillBlockCmd )
+  {
+    fContainer->SetSpillBlockSize(spillBlockCmd->GetNewIntValue(newValues));
+  }
+  else if( command==spillDirCmd )
+  {
+    fContainer->SetSpillDirectory(newValues);
+  }
+  else if( command==addBucketCmd || command==energyBucketsCmd ||
+           command==defaultPriorityCmd || command==clearBucketsCmd ||
+           command==listBucketsCmd )
+  {
+    G4PriorityTrackStack* priorityStack
+      = dynamic_cast<G4PriorityTrackStack*>(fContainer->GetUrgentStack());
+    if(!priorityStack)
+    {
+      G4cerr << command->GetCommandPath() << " is ignored :"
+             << " the urgent stack is not a priority stack."
+             << " Use /event/stack/urgentStack priority first." << G4endl;
+      return;
+    }
+    if( command==addBucketCmd )
+    {
+      G4Tokenizer next(newValues);
+      G4String particleName = next();
+      G4String regionName = next();
+      G4double eMin = StoD(next());
+      G4double eMax = StoD(next());
+      G4String unitName = next();
+      G4double unit = G4UIcommand::ValueOf(unitName);
+      G4int priority = StoI(next());
+      if(particleName=="all") particleName = "";
+      if(regionName=="all") regionName = "";
+      priorityStack->AddBucket(particleName,regionName,eMin*unit,
+                               (eMax>0.) ? eMax*unit : DBL_MAX,priority);
+    }
+    else if( command==energyBucketsCmd )
+    {
+      G4Tokenizer next(newValues);
+      G4int nBins = StoI(next());
+      G4double eMin = StoD(next());
+      G4double eMax = StoD(next());
+      G4String unitName = next();
+      G4double unit = G4UIcommand::ValueOf(unitName);
+      G4String particleName = next();
+      G4int firstPriority = StoI(next());
+      if(particleName=="all") particleName = "";
+      if(eMax<=eMin)
+      {
+        G4cerr << command->GetCommandPath() << " is ignored : Emax <= Emin." << G4endl;
+        return;
+      }
+      priorityStack->AddEnergyBuckets(nBins,eMin*unit,eMax*unit,
+                                      particleName,firstPriority);
+    }
+    else if( command==defaultPriorityCmd )
+    { priorityStack->SetDefaultPriority(defaultPriorityCmd->GetNewIntValue(newValues)); }
+    else if( command==clearBucketsCmd )
+    { priorityStack->ClearBuckets(); }
+    else if( command==listBucketsCmd )
+    { priorityStack->DumpBuckets(); }
+  }
 }
 
@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#include "G4SubEvent.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4Event.hh"
+
+G4SubEvent::G4SubEvent(G4int evID, G4int owner, std::atomic<G4int>* trackIDs)
+:eventID(evID),ownerID(owner),trackIDSource(trackIDs),
+ state(fQueued),result(nullptr)
+{
+  seeds[0] = seeds[1] = seeds[2] = 0;
+}
+
+G4SubEvent::~G4SubEvent()
+{
+  // result must have been deleted by the thread which created it
+}
+
+void G4SubEvent::AddTrack(const G4Track* aTrack)
+{
+  const G4DynamicParticle* dp = aTrack->GetDynamicParticle();
+  TrackData td;
+  td.particle = aTrack->GetParticleDefinition();
+  td.position = aTrack->GetPosition();
+  td.momentumDirection = dp->GetMomentumDirection();
+  td.polarization = dp->GetPolarization();
+  td.kineticEnergy = dp->GetKineticEnergy();
+  td.charge = dp->GetCharge();
+  td.globalTime = aTrack->GetGlobalTime();
+  td.localTime = aTrack->GetLocalTime();
+  td.properTime = aTrack->GetProperTime();
+  td.weight = aTrack->GetWeight();
+  td.trackID = aTrack->GetTrackID();
+  td.parentID = aTrack->GetParentID();
+  td.creatorIndex = GetCreatorIndex(aTrack->GetCreatorProcess());
+  tracks.push_back(td);
+}
+
+G4int G4SubEvent::GetCreatorIndex(const G4VProcess* creator)
+{
+  if(!creator) return -1;
+  for(size_t i=0;i<creators.size();i++)
+  { if(creators[i].process==creator) return G4int(i); }
+
+  G4VProcess* proc = const_cast<G4VProcess*>(creator);
+  const G4ProcessManager* pm = proc->GetProcessManager();
+  if(!pm) return -1;
+  CreatorData cd;
+  cd.process = creator;
+  cd.particle = pm->GetParticleType();
+  cd.processIndex = pm->GetProcessIndex(proc);
+  if(!cd.particle || cd.processIndex<0) return -1;
+  creators.push_back(cd);
+  return G4int(creators.size())-1;
+}
+
+void G4SubEvent::ResolveCreators() const
+{
+  // Process objects are thread-local: take the ones at the same place in
+  // the process list of the same particle in this thread
+  resolvedCreators.assign(creators.size(),nullptr);
+  for(size_t i=0;i<creators.size();i++)
+  {
+    const CreatorData& cd = creators[i];
+    const G4ProcessManager* pm = cd.particle->GetProcessManager();
+    if(!pm || cd.processIndex>=pm->GetProcessListLength()) continue;
+    resolvedCreators[i] = (*(pm->GetProcessList()))[cd.processIndex];
+  }
+}
+
+G4Track* G4SubEvent::CreateTrack(size_t i) const
+{
+  const TrackData& td = tracks[i];
+  G4DynamicParticle* dp = new G4DynamicParticle(td.particle,
+                                   td.momentumDirection,td.kineticEnergy);
+  dp->SetPolarization(td.polarization.x(),td.polarization.y(),
+                      td.polarization.z());
+  dp->SetCharge(td.charge);
+  G4Track* aTrack = new G4Track(dp,td.globalTime,td.position);
+  aTrack->SetLocalTime(td.localTime);
+  aTrack->SetProperTime(td.properTime);
+  aTrack->SetWeight(td.weight);
+  aTrack->SetTrackID(td.trackID);
+  aTrack->SetParentID(td.parentID);
+  if(td.creatorIndex>=0)
+  {
+    if(resolvedCreators.size()!=creators.size()) ResolveCreators();
+    aTrack->SetCreatorProcess(resolvedCreators[td.creatorIndex]);
+  }
+  return aTrack;
+}
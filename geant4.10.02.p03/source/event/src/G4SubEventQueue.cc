@@ -0,0 +1,156 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#include "G4SubEventQueue.hh"
+#include "G4AutoLock.hh"
+
+G4SubEventQueue* G4SubEventQueue::GetInstance()
+{
+  static G4SubEventQueue theInstance;
+  return &theInstance;
+}
+
+G4SubEventQueue::G4SubEventQueue()
+:bundleSize(0),minUrgentTracks(1000),nActiveEvents(0),nWorkersInEventLoop(0)
+{
+  G4MUTEXINIT(mutex);
+}
+
+G4SubEventQueue::~G4SubEventQueue()
+{
+  G4MUTEXDESTROY(mutex);
+}
+
+void G4SubEventQueue::SetBundleSize(G4int val)
+{
+  G4AutoLock l(&mutex);
+  bundleSize = (val>0) ? val : 0;
+}
+
+void G4SubEventQueue::SetMinimumUrgentTracks(G4int val)
+{
+  G4AutoLock l(&mutex);
+  minUrgentTracks = (val>0) ? val : 0;
+}
+
+G4bool G4SubEventQueue::IsEnabled() const
+{
+  // Without helper threads bundles would only be taken back by their owner
+  return ( bundleSize>0 && G4Threading::IsMultithreadedApplication() );
+}
+
+void G4SubEventQueue::BeginRun(G4int nWorkers)
+{
+  G4AutoLock l(&mutex);
+  nWorkersInEventLoop = nWorkers;
+}
+
+void G4SubEventQueue::LeaveEventLoop()
+{
+  G4AutoLock l(&mutex);
+  if(nWorkersInEventLoop>0) nWorkersInEventLoop--;
+  changed.notify_all();
+}
+
+void G4SubEventQueue::Push(G4SubEvent* se)
+{
+  G4AutoLock l(&mutex);
+  se->SetState(G4SubEvent::fQueued);
+  queue.push_back(se);
+  changed.notify_one();
+}
+
+G4SubEvent* G4SubEventQueue::WaitForSubEvent()
+{
+  G4AutoLock l(&mutex);
+  // A worker still in its event loop may start an event and export
+  // bundles later, hence idle threads wait until the end of the run.
+  while(queue.empty()) // Loop checking 17.10.2026
+  {
+    if(nWorkersInEventLoop==0 && nActiveEvents==0) return nullptr;
+    changed.wait(l);
+  }
+  G4SubEvent* se = queue.front();
+  queue.pop_front();
+  se->SetState(G4SubEvent::fProcessing);
+  return se;
+}
+
+G4bool G4SubEventQueue::Reclaim(G4SubEvent* se)
+{
+  G4AutoLock l(&mutex);
+  if(se->GetState()!=G4SubEvent::fQueued) return false;
+  for(auto itr=queue.begin();itr!=queue.end();++itr)
+  {
+    if(*itr==se)
+    {
+      queue.erase(itr);
+      return true;
+    }
+  }
+  return false;
+}
+
+void G4SubEventQueue::WaitWhileProcessing(const G4SubEvent* se)
+{
+  G4AutoLock l(&mutex);
+  while(se->GetState()==G4SubEvent::fProcessing) // Loop checking 17.10.2026
+  { changed.wait(l); }
+}
+
+void G4SubEventQueue::SetDone(G4SubEvent* se)
+{
+  G4AutoLock l(&mutex);
+  se->SetState(G4SubEvent::fDone);
+  changed.notify_all();
+}
+
+void G4SubEventQueue::SetMerged(G4SubEvent* se)
+{
+  G4AutoLock l(&mutex);
+  se->SetState(G4SubEvent::fMerged);
+}
+
+G4SubEvent::SubEventState G4SubEventQueue::GetState(const G4SubEvent* se)
+{
+  G4AutoLock l(&mutex);
+  return se->GetState();
+}
+
+void G4SubEventQueue::BeginEvent()
+{
+  G4AutoLock l(&mutex);
+  nActiveEvents++;
+}
+
+void G4SubEventQueue::EndEvent()
+{
+  G4AutoLock l(&mutex);
+  nActiveEvents--;
+  changed.notify_all();
+}
@@ -28,7 +28,7 @@
 //
 
 #include "G4TrackStack.hh"
-#include "G4SmartTrackStack.hh"
+#include "G4VTrackStack.hh"
 #include "G4VTrajectory.hh"
 #include "G4Track.hh"
 
@@ -51,10 +51,8 @@ void G4TrackStack::TransferTo(G4TrackStack* aStack) {
   clear();
 }
 
-
-void G4TrackStack::TransferTo(G4SmartTrackStack * aStack)
-{
-  while(size()) { aStack->PushToStack(PopFromStack()); }
+void G4TrackStack::TransferTo(G4VTrackStack* aStack) {
+  aStack->TransferFrom(this);
 }
 
 
@@ -0,0 +1,340 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#include "G4TrajectoryStore.hh"
+#include "G4TrajectoryStoreMessenger.hh"
+#include "G4CompactTrajectory.hh"
+#include "G4TrajectoryContainer.hh"
+#include "G4VTrajectory.hh"
+#include "G4VTrajectoryPoint.hh"
+#include "G4Track.hh"
+#include "G4Threading.hh"
+#include "G4UIcommand.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+#include <cstring>
+
+namespace
+{
+  const G4int storeVersion = 1;
+
+  // Approximate memory taken by a trajectory and its points
+  G4double EstimatedSize(const G4VTrajectory* aTrajectory)
+  {
+    const G4CompactTrajectory* compact
+      = dynamic_cast<const G4CompactTrajectory*>(aTrajectory);
+    if(compact) return compact->GetMemorySize();
+    G4int n = aTrajectory->GetPointEntries();
+    G4double size = 128. + 48.*n;
+    for(G4int i=0;i<n;i++)
+    {
+      const std::vector<G4ThreeVector>* aux
+        = aTrajectory->GetPoint(i)->GetAuxiliaryPoints();
+      if(aux) size += sizeof(G4ThreeVector)*aux->capacity();
+    }
+    return size;
+  }
+}
+
+G4TrajectoryStore::G4TrajectoryStore()
+  : active(false), memoryBudget(0.), minKineticEnergy(0.),
+    compaction(false), tolerance(10.*um), quantum(10.*um),
+    streamMode(streamNone), verboseLevel(0),
+    usedMemory(0.), nKept(0), nFiltered(0), nWritten(0), nOverBudget(0)
+{
+  messenger = new G4TrajectoryStoreMessenger(this);
+}
+
+G4TrajectoryStore::~G4TrajectoryStore()
+{
+  if(file.is_open()) file.close();
+  delete messenger;
+}
+
+void G4TrajectoryStore::UpdateActive()
+{
+  active = (memoryBudget>0.) || (minKineticEnergy>0.)
+        || !(keptParticles.empty()) || !(droppedParticles.empty())
+        || compaction || (streamMode!=streamNone && !(outputFile.empty()));
+}
+
+void G4TrajectoryStore::SetMemoryBudget(G4double megaBytes)
+{
+  memoryBudget = (megaBytes>0.) ? megaBytes*1048576. : 0.;
+  UpdateActive();
+}
+
+void G4TrajectoryStore::SetMinKineticEnergy(G4double energy)
+{
+  minKineticEnergy = energy;
+  UpdateActive();
+}
+
+void G4TrajectoryStore::KeepParticle(const G4String& particleName)
+{
+  keptParticles.insert(particleName);
+  UpdateActive();
+}
+
+void G4TrajectoryStore::DropParticle(const G4String& particleName)
+{
+  droppedParticles.insert(particleName);
+  UpdateActive();
+}
+
+void G4TrajectoryStore::ClearFilters()
+{
+  keptParticles.clear();
+  droppedParticles.clear();
+  minKineticEnergy = 0.;
+  UpdateActive();
+}
+
+void G4TrajectoryStore::SetCompaction(G4bool val)
+{
+  compaction = val;
+  UpdateActive();
+}
+
+void G4TrajectoryStore::SetTolerance(G4double length)
+{ tolerance = length; }
+
+void G4TrajectoryStore::SetQuantum(G4double length)
+{ if(length>0.) quantum = length; }
+
+void G4TrajectoryStore::SetStreamMode(StreamMode mode)
+{
+  streamMode = mode;
+  UpdateActive();
+}
+
+void G4TrajectoryStore::SetOutputFile(const G4String& fileName)
+{
+  outputFile = fileName;
+  UpdateActive();
+}
+
+G4bool G4TrajectoryStore::Accept(const G4VTrajectory* aTrajectory,
+                                 const G4Track* aTrack) const
+{
+  if(minKineticEnergy>0. && aTrack->GetVertexKineticEnergy()<minKineticEnergy)
+  { return false; }
+  if(keptParticles.empty() && droppedParticles.empty()) return true;
+  G4String name = aTrajectory->GetParticleName();
+  if(!(keptParticles.empty()) && keptParticles.count(name)==0) return false;
+  return (droppedParticles.count(name)==0);
+}
+
+G4CompactTrajectory* G4TrajectoryStore::Compact(G4VTrajectory*& aTrajectory)
+{
+  G4CompactTrajectory* compact = dynamic_cast<G4CompactTrajectory*>(aTrajectory);
+  if(!compact)
+  {
+    // Without compaction, only the exactly collinear points are removed
+    compact = new G4CompactTrajectory(*aTrajectory,
+                                      compaction ? tolerance : 0., quantum);
+    delete aTrajectory;
+    aTrajectory = compact;
+  }
+  return compact;
+}
+
+G4bool G4TrajectoryStore::OpenFile()
+{
+  if(file.is_open()) file.close();
+  openedFile = outputFile;
+  G4String name = outputFile;
+  if(G4Threading::IsWorkerThread())
+  {
+    name += ".t";
+    name += G4UIcommand::ConvertToString(G4Threading::G4GetThreadId());
+  }
+  file.open(name, std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!file)
+  {
+    G4ExceptionDescription ed;
+    ed << "Trajectory file <" << name << "> cannot be opened."
+       << " Trajectories are kept in memory.";
+    G4Exception("G4TrajectoryStore::OpenFile()","Event0221",JustWarning,ed);
+    file.clear();
+    return false;
+  }
+  file.write("G4TRAJST",8);
+  file.write(reinterpret_cast<const char*>(&storeVersion),sizeof(G4int));
+  return true;
+}
+
+G4bool G4TrajectoryStore::Write(const G4CompactTrajectory* aTrajectory,
+                                G4int eventID)
+{
+  if(outputFile.empty()) return false;
+  if(openedFile!=outputFile)
+  { OpenFile(); }
+  if(!file.is_open()) return false;
+
+  G4TrajectoryStoreRecord rec;
+  std::memset(&rec,0,sizeof(rec));
+  G4String name = aTrajectory->GetParticleName();
+  rec.eventID = eventID;
+  rec.trackID = aTrajectory->GetTrackID();
+  rec.parentID = aTrajectory->GetParentID();
+  rec.pdgEncoding = aTrajectory->GetPDGEncoding();
+  rec.nPoints = aTrajectory->GetPointEntries();
+  rec.nameLength = name.length();
+  rec.charge = aTrajectory->GetCharge();
+  rec.quantum = aTrajectory->GetQuantum();
+  G4ThreeVector org = aTrajectory->GetOrigin();
+  G4ThreeVector mom = aTrajectory->GetInitialMomentum();
+  for(G4int k=0;k<3;k++)
+  {
+    rec.origin[k] = org[k];
+    rec.initialMomentum[k] = mom[k];
+  }
+  file.write(reinterpret_cast<const char*>(&rec),sizeof(rec));
+  file.write(name.c_str(),rec.nameLength);
+  if(rec.nPoints>0)
+  {
+    file.write(reinterpret_cast<const char*>(&(aTrajectory->GetQuantisedPoints()[0])),
+               3*rec.nPoints*sizeof(G4int));
+  }
+  return true;
+}
+
+G4VTrajectory* G4TrajectoryStore::Process(G4VTrajectory* aTrajectory,
+                                          const G4Track* aTrack, G4int eventID)
+{
+  if(!Accept(aTrajectory,aTrack))
+  {
+    delete aTrajectory;
+    ++nFiltered;
+    return 0;
+  }
+
+  if(compaction) Compact(aTrajectory);
+
+  if(streamMode==streamAll && !(outputFile.empty()))
+  {
+    if(Write(Compact(aTrajectory),eventID))
+    {
+      delete aTrajectory;
+      ++nWritten;
+      return 0;
+    }
+  }
+
+  G4double size = EstimatedSize(aTrajectory);
+  if(memoryBudget>0. && usedMemory+size>memoryBudget)
+  {
+    if(streamMode==streamOverflow && Write(Compact(aTrajectory),eventID))
+    { ++nWritten; }
+    else
+    { ++nOverBudget; }
+    delete aTrajectory;
+    return 0;
+  }
+
+  usedMemory += size;
+  ++nKept;
+  return aTrajectory;
+}
+
+void G4TrajectoryStore::EndOfEvent(G4int eventID)
+{
+  if(file.is_open())
+  {
+    if(openedFile!=outputFile || streamMode==streamNone)
+    {
+      file.close();
+      openedFile = "";
+    }
+    else
+    { file.flush(); }
+  }
+  if(verboseLevel>0 && active)
+  {
+    G4cout << "G4TrajectoryStore: event " << eventID << " : "
+           << nKept << " trajectories kept (" << usedMemory/1024.
+           << " kB), " << nWritten << " written to file, "
+           << nFiltered << " filtered out, " << nOverBudget
+           << " dropped beyond the memory budget." << G4endl;
+  }
+  if(nOverBudget>0)
+  {
+    G4ExceptionDescription ed;
+    ed << nOverBudget << " trajectories of event " << eventID
+       << " were dropped beyond the memory budget of "
+       << GetMemoryBudget() << " MB.";
+    G4Exception("G4TrajectoryStore::EndOfEvent()","Event0222",JustWarning,ed);
+  }
+  usedMemory = 0.;
+  nKept = 0;
+  nFiltered = 0;
+  nWritten = 0;
+  nOverBudget = 0;
+}
+
+G4int G4TrajectoryStore::Read(const G4String& fileName, G4int eventID,
+                              G4TrajectoryContainer* container)
+{
+  std::ifstream in(fileName, std::ios::in | std::ios::binary);
+  char magic[8];
+  G4int version = 0;
+  in.read(magic,8);
+  in.read(reinterpret_cast<char*>(&version),sizeof(G4int));
+  if(!in || std::memcmp(magic,"G4TRAJST",8)!=0 || version!=storeVersion)
+  {
+    G4ExceptionDescription ed;
+    ed << "<" << fileName << "> is not a trajectory file of version "
+       << storeVersion << ".";
+    G4Exception("G4TrajectoryStore::Read()","Event0223",JustWarning,ed);
+    return 0;
+  }
+
+  G4int nRead = 0;
+  G4TrajectoryStoreRecord rec;
+  std::vector<G4int> points;
+  while(in.read(reinterpret_cast<char*>(&rec),sizeof(rec))) // Loop checking 17.10.2026
+  {
+    if(rec.nameLength<0 || rec.nPoints<0) break;
+    std::vector<char> name(rec.nameLength);
+    points.resize(3*rec.nPoints);
+    if(rec.nameLength>0) in.read(&(name[0]),rec.nameLength);
+    if(rec.nPoints>0)
+    { in.read(reinterpret_cast<char*>(&(points[0])),3*rec.nPoints*sizeof(G4int)); }
+    if(!in) break;
+    if(eventID>=0 && rec.eventID!=eventID) continue;
+    G4ThreeVector org(rec.origin[0],rec.origin[1],rec.origin[2]);
+    G4ThreeVector mom(rec.initialMomentum[0],rec.initialMomentum[1],
+                      rec.initialMomentum[2]);
+    container->insert(new G4CompactTrajectory(rec.trackID,rec.parentID,
+                      std::string(name.begin(),name.end()),rec.pdgEncoding,
+                      rec.charge,mom,org,rec.quantum,points));
+    ++nRead;
+  }
+  return nRead;
+}
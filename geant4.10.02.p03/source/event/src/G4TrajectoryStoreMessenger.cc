@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+
+#include "G4TrajectoryStoreMessenger.hh"
+#include "G4TrajectoryStore.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+
+G4TrajectoryStoreMessenger::G4TrajectoryStoreMessenger(G4TrajectoryStore* store)
+:fStore(store)
+{
+  trajDir = new G4UIdirectory("/event/trajectory/");
+  trajDir->SetGuidance("Memory control of the trajectories stored in an event.");
+  trajDir->SetGuidance("Trajectories are filtered, compacted or written to a file when");
+  trajDir->SetGuidance("their track is completed, instead of being kept until the end");
+  trajDir->SetGuidance("of the event. These commands apply with /tracking/storeTrajectory.");
+
+  budgetCmd = new G4UIcmdWithADouble("/event/trajectory/memoryBudget",this);
+  budgetCmd->SetGuidance("Set the memory budget of the trajectories of an event (per thread)");
+  budgetCmd->SetGuidance("in MB. Trajectories beyond the budget are written to the file");
+  budgetCmd->SetGuidance("in the overflow stream mode, or dropped.");
+  budgetCmd->SetGuidance(" 0 : no limit (default)");
+  budgetCmd->SetParameterName("MB",false);
+  budgetCmd->SetRange("MB>=0.");
+  budgetCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  minEnergyCmd = new G4UIcmdWithADoubleAndUnit("/event/trajectory/minEnergy",this);
+  minEnergyCmd->SetGuidance("Drop the trajectories of tracks with a kinetic energy at their");
+  minEnergyCmd->SetGuidance("vertex below the given value.");
+  minEnergyCmd->SetParameterName("Emin",false);
+  minEnergyCmd->SetRange("Emin>=0.");
+  minEnergyCmd->SetDefaultUnit("MeV");
+  minEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  keepParticleCmd = new G4UIcmdWithAString("/event/trajectory/keepParticle",this);
+  keepParticleCmd->SetGuidance("Keep the trajectories of the given particle. Once a particle is");
+  keepParticleCmd->SetGuidance("kept, the trajectories of the particles not kept are dropped.");
+  keepParticleCmd->SetParameterName("particle",false);
+  keepParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  dropParticleCmd = new G4UIcmdWithAString("/event/trajectory/dropParticle",this);
+  dropParticleCmd->SetGuidance("Drop the trajectories of the given particle.");
+  dropParticleCmd->SetParameterName("particle",false);
+  dropParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  clearFiltersCmd = new G4UIcmdWithoutParameter("/event/trajectory/clearFilters",this);
+  clearFiltersCmd->SetGuidance("Clear the particle and energy filters.");
+  clearFiltersCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  compactCmd = new G4UIcmdWithABool("/event/trajectory/compact",this);
+  compactCmd->SetGuidance("Replace the trajectories by G4CompactTrajectory objects: points");
+  compactCmd->SetGuidance("within the tolerance of the polyline are removed and positions");
+  compactCmd->SetGuidance("are quantised. Attributes of rich trajectories are lost.");
+  compactCmd->SetParameterName("flag",true);
+  compactCmd->SetDefaultValue(true);
+  compactCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  toleranceCmd = new G4UIcmdWithADoubleAndUnit("/event/trajectory/tolerance",this);
+  toleranceCmd->SetGuidance("Set the distance below which a point is removed by the compaction.");
+  toleranceCmd->SetParameterName("tolerance",false);
+  toleranceCmd->SetRange("tolerance>=0.");
+  toleranceCmd->SetDefaultUnit("mm");
+  toleranceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  quantumCmd = new G4UIcmdWithADoubleAndUnit("/event/trajectory/quantum",this);
+  quantumCmd->SetGuidance("Set the quantum of the positions of compact trajectories.");
+  quantumCmd->SetGuidance("Positions are stored within 2^31 quanta of the track vertex.");
+  quantumCmd->SetParameterName("quantum",false);
+  quantumCmd->SetRange("quantum>0.");
+  quantumCmd->SetDefaultUnit("mm");
+  quantumCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  streamCmd = new G4UIcmdWithAString("/event/trajectory/stream",this);
+  streamCmd->SetGuidance("Select which trajectories are written to the file (compacted)");
+  streamCmd->SetGuidance("instead of being kept in the event.");
+  streamCmd->SetGuidance(" none     : no trajectory (default)");
+  streamCmd->SetGuidance(" overflow : trajectories beyond the memory budget");
+  streamCmd->SetGuidance(" all      : all trajectories");
+  streamCmd->SetParameterName("mode",false);
+  streamCmd->SetCandidates("none overflow all");
+  streamCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fileCmd = new G4UIcmdWithAString("/event/trajectory/file",this);
+  fileCmd->SetGuidance("Set the file the trajectories are written to. Worker threads");
+  fileCmd->SetGuidance("append \".t<thread ID>\" to the name.");
+  fileCmd->SetParameterName("fileName",false);
+  fileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  verboseCmd = new G4UIcmdWithAnInteger("/event/trajectory/verbose",this);
+  verboseCmd->SetGuidance("Set verbose level for G4TrajectoryStore");
+  verboseCmd->SetGuidance(" 0 : Silence (default)");
+  verboseCmd->SetGuidance(" 1 : Summary at the end of each event");
+  verboseCmd->SetParameterName("level",false);
+  verboseCmd->SetRange("level>=0");
+}
+
+G4TrajectoryStoreMessenger::~G4TrajectoryStoreMessenger()
+{
+  delete budgetCmd;
+  delete minEnergyCmd;
+  delete keepParticleCmd;
+  delete dropParticleCmd;
+  delete clearFiltersCmd;
+  delete compactCmd;
+  delete toleranceCmd;
+  delete quantumCmd;
+  delete streamCmd;
+  delete fileCmd;
+  delete verboseCmd;
+  delete trajDir;
+}
+
+void G4TrajectoryStoreMessenger::SetNewValue(G4UIcommand * command,G4String newValues)
+{
+  if( command==budgetCmd )
+  { fStore->SetMemoryBudget(budgetCmd->GetNewDoubleValue(newValues)); }
+  else if( command==minEnergyCmd )
+  { fStore->SetMinKineticEnergy(minEnergyCmd->GetNewDoubleValue(newValues)); }
+  else if( command==keepParticleCmd )
+  { fStore->KeepParticle(newValues); }
+  else if( command==dropParticleCmd )
+  { fStore->DropParticle(newValues); }
+  else if( command==clearFiltersCmd )
+  { fStore->ClearFilters(); }
+  else if( command==compactCmd )
+  { fStore->SetCompaction(compactCmd->GetNewBoolValue(newValues)); }
+  else if( command==toleranceCmd )
+  { fStore->SetTolerance(toleranceCmd->GetNewDoubleValue(newValues)); }
+  else if( command==quantumCmd )
+  { fStore->SetQuantum(quantumCmd->GetNewDoubleValue(newValues)); }
+  else if( command==streamCmd )
+  {
+    if(newValues=="overflow")
+    { fStore->SetStreamMode(G4TrajectoryStore::streamOverflow); }
+    else if(newValues=="all")
+    { fStore->SetStreamMode(G4TrajectoryStore::streamAll); }
+    else
+    { fStore->SetStreamMode(G4TrajectoryStore::streamNone); }
+  }
+  else if( command==fileCmd )
+  { fStore->SetOutputFile(newValues); }
+  else if( command==verboseCmd )
+  { fStore->SetVerboseLevel(verboseCmd->GetNewIntValue(newValues)); }
+}
+
+G4String G4TrajectoryStoreMessenger::GetCurrentValue(G4UIcommand * command)
+{
+  G4String cv;
+  if( command==budgetCmd )
+  { cv = budgetCmd->ConvertToString(fStore->GetMemoryBudget()); }
+  else if( command==minEnergyCmd )
+  { cv = minEnergyCmd->ConvertToString(fStore->GetMinKineticEnergy(),"MeV"); }
+  else if( command==compactCmd )
+  { cv = compactCmd->ConvertToString(fStore->GetCompaction()); }
+  else if( command==toleranceCmd )
+  { cv = toleranceCmd->ConvertToString(fStore->GetTolerance(),"mm"); }
+  else if( command==quantumCmd )
+  { cv = quantumCmd->ConvertToString(fStore->GetQuantum(),"mm"); }
+  else if( command==streamCmd )
+  {
+    const char* modes[] = { "none", "overflow", "all" };
+    cv = modes[fStore->GetStreamMode()];
+  }
+  else if( command==fileCmd )
+  { cv = fStore->GetOutputFile(); }
+  else if( command==verboseCmd )
+  { cv = verboseCmd->ConvertToString(fStore->GetVerboseLevel()); }
+  return cv;
+}
@@ -0,0 +1,124 @@
+// $Id:$
+// -*- C++ -*-
+//
+// -----------------------------------------------------------------------
+//                             HEP Random
+//                        --- PhiloxEngine ---
+//                          class header file
+// -----------------------------------------------------------------------
+// Counter-based random engine implementing the Philox4x32-10 algorithm of
+// J.K. Salmon, M.A. Moraes, R.O. Dror and D.E. Shaw, "Parallel random
+// numbers: as easy as 1, 2, 3", Proc. SC11 (2011).
+// Each block of four 32-bit numbers is a bijective function of a 128-bit
+// counter under a 64-bit key. The key is set by the seed; the upper 64
+// bits of the counter select a stream (setStream()), the lower 64 bits
+// are the position within the stream. Any stream can thus be started
+// directly without generating or storing any seed, e.g. one stream per
+// (run, event), with 2^64 blocks per stream.
+// flat() uses two 32-bit numbers, as MTwistEngine.
+// =======================================================================
+// Created: 17th Oct 2026
+// =======================================================================
+
+#ifndef PhiloxEngine_h
+#define PhiloxEngine_h 1
+
+#include "CLHEP/Random/RandomEngine.h"
+
+namespace CLHEP {
+
+/**
+ * @author
+ * @ingroup random
+ */
+class PhiloxEngine : public HepRandomEngine {
+
+public:
+
+  PhiloxEngine();
+  PhiloxEngine( long seed );
+  PhiloxEngine( std::istream & is );
+  virtual ~PhiloxEngine();
+  // Constructors and destructor.
+
+  double flat();
+  // Returns a pseudo random number between 0 and 1 
+  // (excluding the end points)
+
+  void flatArray(const int size, double* vect);
+  // Fills the array "vect" of specified size with flat random values.
+
+  void setSeed(long seed, int dum=0);
+  // Sets the key from the given seed. Stream and position are reset to 0.
+
+  void setSeeds(const long * seeds, int dum=0);
+  // Sets the key from the first two values of the zero-terminated array
+  // "seeds" (lower and upper 32 bits). Stream and position are reset to 0.
+
+  void setStream( unsigned long id0, unsigned long id1 );
+  // Selects the stream identified by the two 32-bit values id0 and id1
+  // and resets the position to the beginning of the stream. The key
+  // is unchanged.
+
+  void changeStream( unsigned long id0, unsigned long id1 );
+  // Selects the stream identified by id0 and id1 at the current position,
+  // i.e. the next numbers are those the new stream gives after as many
+  // numbers as have been drawn from the current one.
+
+  void getStream( unsigned long & id0, unsigned long & id1 ) const;
+  // Returns the two values identifying the current stream.
+
+  void saveStatus( const char filename[] = "Philox.conf" ) const;
+  // Saves the current engine status in the named file
+
+  void restoreStatus( const char filename[] = "Philox.conf" );
+  // Reads from named file the the last saved engine status and restores it.
+
+  void showStatus() const;
+  // Dumps the current engine status on the screen.
+
+  operator float();      // returns flat, without worrying about filling bits
+  operator unsigned int(); // 32-bit flat, quickest of all
+
+  virtual std::ostream & put (std::ostream & os) const;
+  virtual std::istream & get (std::istream & is);
+  static  std::string beginTag ( );
+  virtual std::istream & getState ( std::istream & is );
+
+  std::string name() const;
+  static std::string engineName() {return "PhiloxEngine";}
+
+  std::vector<unsigned long> put () const;
+  bool get (const std::vector<unsigned long> & v);
+  bool getState (const std::vector<unsigned long> & v);
+
+  static const unsigned int VECTOR_STATE_SIZE = 8;
+
+  static bool selfTest();
+  // Checks the block function against the known-answer vectors of the
+  // Random123 distribution. Returns false if any block differs, e.g. if
+  // the compiler miscompiles the 32x32->64 bit multiplications.
+
+private:
+
+  inline unsigned int nextWord();
+  void generateBlock();
+  // Computes the block of the current counter and increments the counter.
+  void regenerateBlock();
+  // Recomputes the block in use after the state has been restored.
+
+  unsigned int key[2];
+  unsigned int counter[4];
+  unsigned int block[4];
+  int index;
+
+}; // PhiloxEngine
+
+inline unsigned int PhiloxEngine::nextWord() {
+  if( index >= 4 ) generateBlock();
+  return block[index++];
+}
+
+}  // namespace CLHEP
+
+#endif // PhiloxEngine_h
@@ -29,6 +29,7 @@
 #include "CLHEP/Random/JamesRandom.h"
 #include "CLHEP/Random/MixMaxRng.h"
 #include "CLHEP/Random/MTwistEngine.h"
+#include "CLHEP/Random/PhiloxEngine.h"
 #include "CLHEP/Random/RanecuEngine.h"
 #include "CLHEP/Random/RanluxEngine.h"
 #include "CLHEP/Random/Ranlux64Engine.h"
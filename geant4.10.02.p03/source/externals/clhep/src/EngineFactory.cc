@@ -16,6 +16,7 @@
 #include "CLHEP/Random/JamesRandom.h"
 #include "CLHEP/Random/MixMaxRng.h"
 #include "CLHEP/Random/MTwistEngine.h"
+#include "CLHEP/Random/PhiloxEngine.h"
 #include "CLHEP/Random/RanecuEngine.h"
 #include "CLHEP/Random/Ranlux64Engine.h"
 #include "CLHEP/Random/RanluxEngine.h"
@@ -58,6 +59,7 @@ HepRandomEngine* EngineFactory::newEngine(std::istream& is) {
   eptr = makeAnEngine <Ranlux64Engine>  (tag, is); if (eptr) return eptr;
   eptr = makeAnEngine <MixMaxRng>       (tag, is); if (eptr) return eptr;
   eptr = makeAnEngine <MTwistEngine>    (tag, is); if (eptr) return eptr;
+  eptr = makeAnEngine <PhiloxEngine>    (tag, is); if (eptr) return eptr;
   eptr = makeAnEngine <DualRand>        (tag, is); if (eptr) return eptr;
   eptr = makeAnEngine <RanluxEngine>    (tag, is); if (eptr) return eptr;
   eptr = makeAnEngine <RanshiEngine>    (tag, is); if (eptr) return eptr;
@@ -78,6 +80,7 @@ EngineFactory::newEngine(std::vector<unsigned long> const & v) {
   eptr = makeAnEngine <Ranlux64Engine>  (v); if (eptr) return eptr;
   eptr = makeAnEngine <MixMaxRng>       (v); if (eptr) return eptr;
   eptr = makeAnEngine <MTwistEngine>    (v); if (eptr) return eptr;
+  eptr = makeAnEngine <PhiloxEngine>    (v); if (eptr) return eptr;
   eptr = makeAnEngine <DualRand>        (v); if (eptr) return eptr;
   eptr = makeAnEngine <RanluxEngine>    (v); if (eptr) return eptr;
   eptr = makeAnEngine <RanshiEngine>    (v); if (eptr) return eptr;
@@ -0,0 +1,318 @@
+// $Id:$
+// -*- C++ -*-
+//
+// -----------------------------------------------------------------------
+//                             HEP Random
+//                        --- PhiloxEngine ---
+//                      class implementation file
+// -----------------------------------------------------------------------
+// Philox4x32-10 counter-based random engine, see PhiloxEngine.h.
+// =======================================================================
+// Created: 17th Oct 2026
+// =======================================================================
+
+#include "CLHEP/Random/Random.h"
+#include "CLHEP/Random/PhiloxEngine.h"
+#include "CLHEP/Random/engineIDulong.h"
+#include "CLHEP/Utility/atomic_int.h"
+
+#include <string.h>	// for strcmp
+#include <cstdlib>	// for std::abs(int)
+
+namespace CLHEP {
+
+namespace {
+  // Number of instances with automatic seed selection
+  CLHEP_ATOMIC_INT_TYPE numberOfEngines(0);
+
+  // Maximum index into the seed table
+  const int maxIndex = 215;
+
+  // Multipliers and Weyl key increments of Philox4x32
+  const unsigned long long philoxM0 = 0xD2511F53ULL;
+  const unsigned long long philoxM1 = 0xCD9E8D57ULL;
+  const unsigned int philoxW0 = 0x9E3779B9U;
+  const unsigned int philoxW1 = 0xBB67AE85U;
+  const int philoxRounds = 10;
+}
+
+static const int MarkerLen = 64; // Enough room to hold a begin or end marker. 
+
+std::string PhiloxEngine::name() const {return "PhiloxEngine";}
+
+PhiloxEngine::PhiloxEngine() 
+: HepRandomEngine()
+{
+  int numEngines = numberOfEngines++;
+  int cycle = std::abs(int(numEngines/maxIndex));
+  int curIndex = std::abs(int(numEngines%maxIndex));
+  long seedlist[3];
+  HepRandom::getTheTableSeeds( seedlist, curIndex );
+  seedlist[1] = (seedlist[1])^(cycle & 0x7fffffff);
+  seedlist[2] = 0;
+  setSeeds( seedlist );
+}
+
+PhiloxEngine::PhiloxEngine(long seed)  
+: HepRandomEngine()
+{
+  setSeed( seed );
+}
+
+PhiloxEngine::PhiloxEngine( std::istream& is )  
+: HepRandomEngine()
+{
+  is >> *this;
+}
+
+PhiloxEngine::~PhiloxEngine() {}
+
+void PhiloxEngine::generateBlock() {
+  unsigned int c0 = counter[0], c1 = counter[1];
+  unsigned int c2 = counter[2], c3 = counter[3];
+  unsigned int k0 = key[0], k1 = key[1];
+  for( int r=0; r<philoxRounds; ++r ) {
+    unsigned long long p0 = philoxM0 * c0;
+    unsigned long long p1 = philoxM1 * c2;
+    unsigned int hi0 = (unsigned int)(p0 >> 32);
+    unsigned int lo0 = (unsigned int)(p0);
+    unsigned int hi1 = (unsigned int)(p1 >> 32);
+    unsigned int lo1 = (unsigned int)(p1);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += philoxW0;
+    k1 += philoxW1;
+  }
+  block[0] = c0; block[1] = c1; block[2] = c2; block[3] = c3;
+  index = 0;
+  // the position is the lower 64 bits of the counter
+  if( ++counter[0] == 0 ) ++counter[1];
+}
+
+void PhiloxEngine::regenerateBlock() {
+  if( index >= 4 ) return;
+  int saved = index;
+  if( counter[0]-- == 0 ) --counter[1];
+  generateBlock();
+  index = saved;
+}
+
+double PhiloxEngine::flat() {
+  unsigned int w0 = nextWord();
+  unsigned int w1 = nextWord();
+  return                   w0 * twoToMinus_32()  +    // Scale to range 
+                 (w1 >> 11) * twoToMinus_53()  +    // fill remaining bits
+                	    nearlyTwoToMinus_54();      // make sure non-zero
+}
+
+void PhiloxEngine::flatArray( const int size, double *vect ) {
+  for( int i=0; i < size; ++i) vect[i] = flat();
+}
+
+bool PhiloxEngine::selfTest() {
+  // counter[0..3], key[0..1], expected block[0..3] (Random123 kat_vectors)
+  static const unsigned int kat[3][10] = {
+    { 0x00000000U, 0x00000000U, 0x00000000U, 0x00000000U,
+      0x00000000U, 0x00000000U,
+      0x6627e8d5U, 0xe169c58dU, 0xbc57ac4cU, 0x9b00dbd8U },
+    { 0xffffffffU, 0xffffffffU, 0xffffffffU, 0xffffffffU,
+      0xffffffffU, 0xffffffffU,
+      0x408f276dU, 0x41c83b0eU, 0xa20bc7c6U, 0x6d5451fdU },
+    { 0x243f6a88U, 0x85a308d3U, 0x13198a2eU, 0x03707344U,
+      0xa4093822U, 0x299f31d0U,
+      0xd16cfe09U, 0x94fdccebU, 0x5001e420U, 0x24126ea1U } };
+  PhiloxEngine engine(0L);
+  for( int i=0; i<3; ++i ) {
+    for( int j=0; j<4; ++j ) engine.counter[j] = kat[i][j];
+    engine.key[0] = kat[i][4];
+    engine.key[1] = kat[i][5];
+    engine.generateBlock();
+    for( int j=0; j<4; ++j ) {
+      if( engine.block[j] != kat[i][6+j] ) return false;
+    }
+  }
+  return true;
+}
+
+void PhiloxEngine::setSeed(long seed, int) {
+  theSeed = seed;
+  unsigned long long s = (unsigned long long)seed;
+  key[0] = (unsigned int)(s & 0xffffffffULL);
+  key[1] = (unsigned int)(s >> 32);
+  setStream(0,0);
+}
+
+void PhiloxEngine::setSeeds(const long *seeds, int) {
+  theSeeds = seeds;
+  theSeed = seeds[0];
+  key[0] = (unsigned int)(seeds[0] & 0xffffffffUL);
+  key[1] = seeds[0] ? (unsigned int)(seeds[1] & 0xffffffffUL) : 0;
+  setStream(0,0);
+}
+
+void PhiloxEngine::setStream(unsigned long id0, unsigned long id1) {
+  counter[0] = 0;
+  counter[1] = 0;
+  counter[2] = (unsigned int)(id0 & 0xffffffffUL);
+  counter[3] = (unsigned int)(id1 & 0xffffffffUL);
+  index = 4;
+}
+
+void PhiloxEngine::changeStream(unsigned long id0, unsigned long id1) {
+  counter[2] = (unsigned int)(id0 & 0xffffffffUL);
+  counter[3] = (unsigned int)(id1 & 0xffffffffUL);
+  regenerateBlock();
+}
+
+void PhiloxEngine::getStream(unsigned long & id0, unsigned long & id1) const {
+  id0 = counter[2];
+  id1 = counter[3];
+}
+
+void PhiloxEngine::saveStatus( const char filename[] ) const
+{
+   std::ofstream outFile( filename, std::ios::out ) ;
+   if (!outFile.bad()) {
+     outFile << theSeed << std::endl;
+     outFile << key[0] << " " << key[1] << std::endl;
+     for (int i=0; i<4; ++i) outFile << counter[i] << " ";
+     outFile << std::endl;
+     outFile << index << std::endl;
+   }
+}
+
+void PhiloxEngine::restoreStatus( const char filename[] )
+{
+   std::ifstream inFile( filename, std::ios::in);
+   if (!checkFile ( inFile, filename, engineName(), "restoreStatus" )) {
+     std::cerr << "  -- Engine state remains unchanged\n";
+     return;
+   }
+
+   if (!inFile.bad() && !inFile.eof()) {
+     inFile >> theSeed;
+     inFile >> key[0] >> key[1];
+     for (int i=0; i<4; ++i) inFile >> counter[i];
+     inFile >> index;
+     regenerateBlock();
+   }
+}
+
+void PhiloxEngine::showStatus() const
+{
+   std::cout << std::endl;
+   std::cout << "--------- Philox engine status ---------" << std::endl;
+   std::cout << " Initial seed  = " << theSeed << std::endl;
+   std::cout << " Key           = " << key[0] << " " << key[1] << std::endl;
+   std::cout << " Stream        = " << counter[2] << " " << counter[3] << std::endl;
+   std::cout << " Next block    = " << counter[0] << " " << counter[1] << std::endl;
+   std::cout << " Current index = " << index << std::endl;
+   std::cout << "----------------------------------------" << std::endl;
+}
+
+PhiloxEngine::operator float() {
+  return (float)(nextWord() * twoToMinus_32());
+}
+
+PhiloxEngine::operator unsigned int() {
+  return nextWord();
+}
+
+std::ostream & PhiloxEngine::put ( std::ostream& os ) const
+{
+   char beginMarker[] = "PhiloxEngine-begin";
+   char endMarker[]   = "PhiloxEngine-end";
+
+   os << " " << beginMarker << " ";
+   os << theSeed << " ";
+   os << key[0] << " " << key[1] << " ";
+   for (int i=0; i<4; ++i) {
+     os << counter[i] << " ";
+   }
+   os << index << " ";
+   os << endMarker << "\n";
+   return os;
+}
+
+std::vector<unsigned long> PhiloxEngine::put () const {
+  std::vector<unsigned long> v;
+  v.push_back (engineIDulong<PhiloxEngine>());
+  v.push_back(static_cast<unsigned long>(key[0]));
+  v.push_back(static_cast<unsigned long>(key[1]));
+  for (int i=0; i<4; ++i) {
+     v.push_back(static_cast<unsigned long>(counter[i]));
+  }
+  v.push_back(static_cast<unsigned long>(index)); 
+  return v;
+}
+
+std::istream &  PhiloxEngine::get ( std::istream& is )
+{
+  char beginMarker [MarkerLen];
+  is >> std::ws;
+  is.width(MarkerLen);  // causes the next read to the char* to be <=
+			// that many bytes, INCLUDING A TERMINATION \0 
+			// (Stroustrup, section 21.3.2)
+  is >> beginMarker;
+  if (strcmp(beginMarker,"PhiloxEngine-begin")) {
+     is.clear(std::ios::badbit | is.rdstate());
+     std::cerr << "\nInput stream mispositioned or"
+	       << "\nPhiloxEngine state description missing or"
+	       << "\nwrong engine type found." << std::endl;
+     return is;
+   }
+  return getState(is);
+}
+
+std::string PhiloxEngine::beginTag ( )  { 
+  return "PhiloxEngine-begin"; 
+}
+
+std::istream &  PhiloxEngine::getState ( std::istream& is )
+{
+  char endMarker   [MarkerLen];
+  is >> theSeed;
+  is >> key[0] >> key[1];
+  for (int i=0; i<4; ++i)  is >> counter[i];
+  is >> index;
+  is >> std::ws;
+  is.width(MarkerLen);  
+  is >> endMarker;
+  if (strcmp(endMarker,"PhiloxEngine-end")) {
+     is.clear(std::ios::badbit | is.rdstate());
+     std::cerr << "\nPhiloxEngine state description incomplete."
+	       << "\nInput stream is probably mispositioned now." << std::endl;
+     return is;
+   }
+   regenerateBlock();
+   return is;
+}
+
+bool PhiloxEngine::get (const std::vector<unsigned long> & v) {
+  if ((v[0] & 0xffffffffUL) != engineIDulong<PhiloxEngine>()) {
+    std::cerr << 
+    	"\nPhiloxEngine get:state vector has wrong ID word - state unchanged\n";
+    return false;
+  }
+  return getState(v);
+}
+
+bool PhiloxEngine::getState (const std::vector<unsigned long> & v) {
+  if (v.size() != VECTOR_STATE_SIZE ) {
+    std::cerr << 
+    	"\nPhiloxEngine get:state vector has wrong length - state unchanged\n";
+    return false;
+  }
+  key[0] = v[1];
+  key[1] = v[2];
+  for (int i=0; i<4; ++i) {
+     counter[i] = v[i+3];
+  }
+  index = v[7];
+  regenerateBlock();
+  return true;
+}
+
+}  // namespace CLHEP
@@ -0,0 +1,61 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+// GEANT 4 class header file
+//
+// G4DaughterExtent
+//
+// Class description:
+//
+// Axis-aligned bounding box of a placed daughter in the frame of its
+// mother, in single precision. The bounds are rounded outwards, so that
+// the box still bounds the solid of the daughter. Used for rejecting
+// daughters in the navigation before their solids are queried, by the
+// topmost smart voxel headers and by G4SmartBVH.
+
+// --------------------------------------------------------------------
+#ifndef G4DAUGHTEREXTENT_HH
+#define G4DAUGHTEREXTENT_HH
+
+#include "G4Types.hh"
+
+class G4VPhysicalVolume;
+
+struct G4DaughterExtent
+{
+  G4float fMin[3];
+  G4float fMax[3];
+    // Bounds along the x, y and z axes
+
+  void Compute(const G4VPhysicalVolume* pDaughter, G4double pMargin);
+    // Set to the extent of the solid of the daughter in the frame of
+    // its mother, enlarged by pMargin. Axes along which the solid has
+    // no extent are left unbounded.
+};
+
+#endif
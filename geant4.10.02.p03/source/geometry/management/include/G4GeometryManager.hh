@@ -39,6 +39,10 @@
 //
 //   static G4GeometryManager* fgInstance
 //     - Ptr to the unique instance of class
+//   G4int fNoVoxelThreads
+//     - Number of threads building the voxels of placement volumes
+//   G4String fVoxelCacheFile
+//     - Name of the file storing voxels between jobs, if any
 
 // Author:
 // 26.07.95 P.Kent Initial version, including optimisation Build
@@ -48,9 +52,11 @@
 
 #include <vector>
 #include "G4Types.hh"
+#include "G4String.hh"
 #include "G4SmartVoxelStat.hh"
 
 class G4VPhysicalVolume;
+class G4LogicalVolume;
 
 class G4GeometryManager
 {
@@ -77,6 +83,23 @@ class G4GeometryManager
     static G4GeometryManager* GetInstance();
       // Return ptr to singleton instance of the class.
 
+    void SetNumberOfVoxelThreads(G4int nThreads);
+    G4int GetNumberOfVoxelThreads() const;
+      // Set/get the number of threads building the voxels of volumes with
+      // placed daughters when the whole geometry is closed. Volumes with
+      // replicated daughters are still voxelised by the calling thread.
+      // The result is identical to a sequential build. Threads are only
+      // used in multi-threaded builds; default is 1 (sequential).
+
+    void SetVoxelCacheFile(const G4String& fileName);
+    const G4String& GetVoxelCacheFile() const;
+      // Set/get the file in which the voxels of volumes with placed
+      // daughters are kept between jobs (see G4SmartVoxelCache). When the
+      // whole geometry is closed, the voxels of unchanged volumes are read
+      // from the file instead of being built, and the file is updated if
+      // any volume had to be built. No file is used if the name is empty
+      // (default).
+
   protected:
 
     G4GeometryManager();
@@ -85,12 +108,17 @@ class G4GeometryManager
 
     void BuildOptimisations(G4bool allOpt, G4bool verbose=false);
     void BuildOptimisations(G4bool allOpt, G4VPhysicalVolume* vol);
+    void BuildVoxelsConcurrently( std::vector<G4LogicalVolume*>& volumes,
+                                  std::vector<G4SmartVoxelStat>& stats,
+                                  G4bool verbose );
     void DeleteOptimisations();
     void DeleteOptimisations(G4VPhysicalVolume* vol);
     static void ReportVoxelStats( std::vector<G4SmartVoxelStat> & stats,
                                   G4double totalCpuTime );
     static G4ThreadLocal G4GeometryManager* fgInstance;
     G4bool fIsClosed;
+    G4int fNoVoxelThreads;
+    G4String fVoxelCacheFile;
 };
 
 #endif
@@ -75,6 +75,11 @@
 //    - Pointer (possibly 0) to optimisation info objects.
 //    G4bool fOptimise
 //    - Flag to identify if optimisation should be applied or not.
+//    G4SmartBVH* fBVH
+//    - Pointer (possibly 0) to bounding volume hierarchy of daughters.
+//    G4bool fBVHOptimise
+//    - Flag to identify if a bounding volume hierarchy should be used
+//      instead of voxels.
 //    G4bool fRootRegion
 //    - Flag to identify if the logical volume is a root region.
 //    G4double fSmartless
@@ -129,6 +134,7 @@ class G4VSensitiveDetector;
 class G4VSolid;
 class G4UserLimits;
 class G4SmartVoxelHeader;
+class G4SmartBVH;
 class G4VisAttributes;
 class G4FastSimulationManager;
 class G4MaterialCutsCouple;
@@ -305,6 +311,17 @@ class G4LogicalVolume
       // volume hierarchy. Note that for parameterised volumes in the
       // hierarchy, optimisation is always applied. 
 
+    inline G4SmartBVH* GetBVH() const;
+    inline void SetBVH(G4SmartBVH *pBVH);
+      // Gets and sets current bounding volume hierarchy of daughters.
+
+    inline G4bool IsBVHOptimised() const;
+    inline void SetBVHOptimisation(G4bool bvh);
+      // Specifies if to optimise navigation among the placed daughters
+      // of this volume with a bounding volume hierarchy instead of
+      // voxels. Suited to many daughters in unstructured arrangements,
+      // e.g. randomly placed or rotated. Off by default.
+
     inline G4bool IsRootRegion() const;
       // Replies if the logical volume represents a root region or not.
     inline void SetRegionRootFlag(G4bool rreg);
@@ -405,6 +422,10 @@ class G4LogicalVolume
       // Pointer (possibly 0) to optimisation info objects.
     G4bool fOptimise;
       // Flag to identify if optimisation should be applied or not.
+    G4SmartBVH* fBVH;
+      // Pointer (possibly 0) to bounding volume hierarchy of daughters.
+    G4bool fBVHOptimise;
+      // Flag to identify if a bounding volume hierarchy should be used.
     G4bool fRootRegion;
       // Flag to identify if the logical volume is a root region.
     G4bool fLock;
@@ -0,0 +1,129 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//
+// --------------------------------------------------------------------
+// GEANT 4 class header file
+//
+// G4SmartBVH
+//
+// Class description:
+//
+// Bounding volume hierarchy over the placed daughters of a logical
+// volume, used for navigation instead of smart voxels when the volume
+// is flagged with G4LogicalVolume::SetBVHOptimisation().
+// Voxels slice the mother along one axis at a time and degrade when the
+// daughters are not aligned with the axes, e.g. randomly rotated fibres
+// or packed pebbles, leaving hundreds of candidates in a node; the boxes
+// of a hierarchy instead follow the daughters wherever they are.
+//
+// Each daughter is bounded by the axis-aligned box of its solid in the
+// mother frame, enlarged by the surface tolerance (G4DaughterExtent, as
+// for the voxel navigation). The tree is built top-down when closing the
+// geometry, splitting each node according to the surface area heuristic
+// evaluated over a fixed number of bins of the box centres.
+// Nodes are stored depth-first: the first child of an inner node follows
+// it, the index of the second child is stored in the node. Leaves refer
+// to a contiguous range of entries, each holding a daughter number and
+// its box.
+
+// --------------------------------------------------------------------
+#ifndef G4SMARTBVH_HH
+#define G4SMARTBVH_HH
+
+#include <vector>
+
+#include "G4Types.hh"
+#include "G4DaughterExtent.hh"
+
+class G4LogicalVolume;
+
+const G4int kMaxBVHLeafSize = 4;
+  // Maximum number of daughters in a leaf, unless more of them cannot
+  // be separated
+const G4int kMaxBVHDepth = 48;
+  // Maximum depth of the tree
+const G4int kNoBVHBins = 16;
+  // Number of bins for evaluating the splits of a node
+
+class G4SmartBVH
+{
+  public:  // with description
+
+    typedef G4DaughterExtent G4BVHBox;
+
+    struct G4BVHNode
+    {
+      G4BVHBox fBox;
+      G4int fFirst;
+        // Inner node: index of the second child.
+        // Leaf: index of the first entry.
+      G4int fCount;
+        // Number of entries of a leaf, 0 for an inner node.
+    };
+
+    G4SmartBVH(G4LogicalVolume* pVolume);
+      // Build the hierarchy over the daughters of the volume.
+
+    ~G4SmartBVH();
+
+    inline const G4BVHNode& GetNode(G4int n) const;
+    inline G4int GetNoNodes() const;
+      // Nodes of the tree, the root being node 0.
+
+    inline G4int GetDaughter(G4int entry) const;
+    inline const G4BVHBox& GetBox(G4int entry) const;
+      // Daughter number and bounding box of a leaf entry.
+
+    inline G4int GetNoEntries() const;
+    inline G4int GetDepth() const;
+
+  private:
+
+    G4int BuildNode(G4int first, G4int count, G4int depth);
+      // Build the subtree over the entries [first, first+count),
+      // reordering them, and return the index of its root node.
+
+    static G4double Area(const G4double bmin[3], const G4double bmax[3]);
+
+    G4SmartBVH(const G4SmartBVH&);
+    G4SmartBVH& operator=(const G4SmartBVH&);
+
+  private:
+
+    std::vector<G4BVHNode> fNodes;
+    std::vector<G4int> fDaughters;
+    std::vector<G4BVHBox> fBoxes;
+      // Entries, in leaf order
+    std::vector<G4double> fCentres;
+      // Box centres of the entries, used while building only
+    G4int fDepth;
+};
+
+#include "G4SmartBVH.icc"
+
+#endif
@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+// GEANT 4 class header file
+//
+// G4SmartVoxelCache
+//
+// Class description:
+//
+// Persistent store of the smart voxels of logical volumes with placed
+// daughters, used when closing the geometry to restore voxels instead
+// of rebuilding them.
+// Each volume is identified by a 64-bit key computed from everything its
+// voxels depend on: its solid and voxel quality (smartless), the solids
+// and placements of its daughters, the surface tolerance and the voxel
+// optimisation constants. Solids enter the key through their StreamInfo()
+// description, which is assumed to describe them completely.
+// Voxels are retrieved from the file by key, so that a modified geometry
+// reuses the voxels of all unchanged volumes. If any requested volume was
+// not found, the file is rewritten with the voxels of all requested
+// volumes once they have been built.
+//
+// File format, in the byte order of the writing machine:
+//   magic "G4VOXCH1", 32-bit version, 32-bit byte order mark (0x01020304),
+//   64-bit number of entries,
+//   for each entry: 64-bit key, 64-bit size in bytes, serialised header.
+// A serialised header holds its equivalent slice numbers, axes, extents
+// and number of slices, then for each slice a tag telling whether it uses
+// the proxy of the previous slice, a new proxy to the node or header of
+// the previous slice, or a new proxy to a new node or header, followed
+// by any new node (equivalent slice numbers and daughter numbers) or
+// header.
+
+// --------------------------------------------------------------------
+#ifndef G4SMARTVOXELCACHE_HH
+#define G4SMARTVOXELCACHE_HH
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+#include "G4Types.hh"
+#include "G4String.hh"
+
+class G4LogicalVolume;
+class G4VSolid;
+class G4SmartVoxelHeader;
+class G4SmartVoxelNode;
+
+class G4SmartVoxelCache
+{
+  public:  // with description
+
+    G4SmartVoxelCache(const G4String& fileName);
+      // Read the entries of the file, if it exists and is valid.
+
+    ~G4SmartVoxelCache();
+
+    G4SmartVoxelHeader* Retrieve(G4LogicalVolume* pVolume);
+      // Return voxels restored from the file for the volume, or null if
+      // there are none for its key. The volume is recorded for Write(),
+      // which expects it to have its voxel header by then.
+
+    G4bool Write();
+      // Rewrite the file with the voxels of all recorded volumes, if any
+      // of them was not found in the file. Return false in case of error.
+
+    inline G4int GetNoRestored() const;
+    inline G4int GetNoMissing() const;
+      // Number of volumes whose voxels were restored / not found.
+
+  private:
+
+    uint64_t VolumeKey(const G4LogicalVolume* pVolume);
+    uint64_t SolidKey(const G4VSolid* pSolid);
+
+    void WriteHeader(std::vector<char>& buffer,
+                     const G4SmartVoxelHeader* pHeader) const;
+    void WriteNode(std::vector<char>& buffer,
+                   const G4SmartVoxelNode* pNode) const;
+    G4SmartVoxelHeader* ReadHeader(const char*& pos, const char* end,
+                                   G4int nDaughters, G4int depth) const;
+    G4SmartVoxelNode* ReadNode(const char*& pos, const char* end,
+                               G4int nDaughters) const;
+
+  private:
+
+    G4String fFileName;
+    std::vector<char> fData;
+      // Contents of the file
+    std::map<uint64_t, std::pair<size_t,size_t> > fEntries;
+      // Offset and size in fData of the voxels of each key
+    std::map<const G4VSolid*, uint64_t> fSolidKeys;
+    std::vector<std::pair<uint64_t,G4LogicalVolume*> > fVolumes;
+      // Recorded volumes and their keys
+    uint64_t fSettingsKey;
+    G4int fNoRestored;
+    G4int fNoMissing;
+};
+
+inline G4int G4SmartVoxelCache::GetNoRestored() const
+{
+  return fNoRestored;
+}
+
+inline G4int G4SmartVoxelCache::GetNoMissing() const
+{
+  return fNoMissing;
+}
+
+#endif
@@ -48,6 +48,10 @@
 // G4int fmaxEquivalent
 //   - Minimum and maximum equivalent slice nos.
 //     [Applies to the level of the header, not its nodes]
+//
+// std::vector<G4DaughterExtent> fdaughterExtents
+//   - Bounding boxes of the daughters in the frame of the mother,
+//     indexed by daughter no. [Topmost header of placed daughters only]
 
 // History:
 // 18.04.01 G.Cosmo Migrated to STL vector
@@ -61,6 +65,7 @@
 
 #include "G4SmartVoxelProxy.hh"
 #include "G4SmartVoxelNode.hh"
+#include "G4DaughterExtent.hh"
 
 #include <vector>
 
@@ -114,6 +119,11 @@ class G4SmartVoxelHeader
     G4bool AllSlicesEqual() const;
       // True if all slices equal (after collection).
 
+    inline const G4DaughterExtent* GetDaughterExtents() const;
+      // Return the bounding boxes of the daughters in the frame of the
+      // mother, indexed by daughter no., or 0 if not available. They are
+      // computed with the topmost header of volumes with placed daughters.
+
   public:  // without description
 
     G4bool operator == (const G4SmartVoxelHeader& pHead) const;
@@ -132,12 +142,21 @@ class G4SmartVoxelHeader
 
   protected:
 
+    friend class G4SmartVoxelCache;
+
+    G4SmartVoxelHeader();
+      // Build an empty header, with no slices, to be filled when voxels
+      // are restored by G4SmartVoxelCache.
+
     //  `Worker' / operation functions:
 
     void BuildVoxels(G4LogicalVolume* pVolume);
       // Build and refine voxels for daughters of specified volume which
       // DOES NOT contain a REPLICATED daughter.
 
+    void BuildDaughterExtents(G4LogicalVolume* pVolume);
+      // Compute the bounding boxes of the daughters of specified volume.
+
     void BuildReplicaVoxels(G4LogicalVolume* pVolume);
       // Build voxels for specified volume containing a single
       // replicated volume.
@@ -197,6 +216,9 @@ class G4SmartVoxelHeader
 
     G4ProxyVector fslices;
       // Slices along axis.
+
+    std::vector<G4DaughterExtent> fdaughterExtents;
+      // Bounding boxes of the daughters, for the topmost header.
 };
 
 #include "G4SmartVoxelHeader.icc"
@@ -37,6 +37,7 @@ GEANT4_DEFINE_MODULE(NAME G4geometrymng
         G4AffineTransform.icc
         G4BlockingList.hh
         G4BlockingList.icc
+        G4DaughterExtent.hh
         G4ErrorCylSurfaceTarget.hh
         G4ErrorPlaneSurfaceTarget.hh
         G4ErrorSurfaceTarget.hh
@@ -55,6 +56,9 @@ GEANT4_DEFINE_MODULE(NAME G4geometrymng
         G4Region.hh
         G4Region.icc
         G4RegionStore.hh
+        G4SmartBVH.hh
+        G4SmartBVH.icc
+        G4SmartVoxelCache.hh
         G4SmartVoxelHeader.hh
         G4SmartVoxelHeader.icc
         G4SmartVoxelNode.hh
@@ -85,6 +89,7 @@ GEANT4_DEFINE_MODULE(NAME G4geometrymng
         voxeldefs.hh
     SOURCES
         G4BlockingList.cc
+        G4DaughterExtent.cc
         G4ErrorCylSurfaceTarget.cc
         G4ErrorPlaneSurfaceTarget.cc
         G4ErrorSurfaceTarget.cc
@@ -99,6 +104,8 @@ GEANT4_DEFINE_MODULE(NAME G4geometrymng
         G4ReflectedSolid.cc
         G4Region.cc
         G4RegionStore.cc
+        G4SmartBVH.cc
+        G4SmartVoxelCache.cc
         G4SmartVoxelHeader.cc
         G4SmartVoxelNode.cc
         G4SmartVoxelProxy.cc
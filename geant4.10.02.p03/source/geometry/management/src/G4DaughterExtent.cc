@@ -0,0 +1,76 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// --------------------------------------------------------------------
+// GEANT 4 class source file
+//
+// G4DaughterExtent implementation
+//
+// --------------------------------------------------------------------
+
+#include <cfloat>
+#include <cmath>
+
+#include "G4DaughterExtent.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4AffineTransform.hh"
+#include "G4VoxelLimits.hh"
+
+// ***************************************************************************
+// Computes the extent of the daughter's solid along each axis, as done for
+// building the voxels, and rounds it outwards to single precision.
+// ***************************************************************************
+//
+void G4DaughterExtent::Compute(const G4VPhysicalVolume* pDaughter,
+                                     G4double pMargin)
+{
+  const G4VSolid* solid = pDaughter->GetLogicalVolume()->GetSolid();
+  const G4AffineTransform transform(pDaughter->GetRotation(),
+                                    pDaughter->GetTranslation());
+  const G4VoxelLimits noLimits;
+  for (G4int axis=0; axis<3; ++axis)
+  {
+    G4double pMin, pMax;
+    if ( solid->CalculateExtent(EAxis(axis), noLimits, transform,
+                                pMin, pMax) )
+    {
+      G4float fmin = G4float(pMin-pMargin), fmax = G4float(pMax+pMargin);
+      if ( fmin > pMin-pMargin ) { fmin = std::nextafter(fmin, -FLT_MAX); }
+      if ( fmax < pMax+pMargin ) { fmax = std::nextafter(fmax,  FLT_MAX); }
+      fMin[axis] = fmin;
+      fMax[axis] = fmax;
+    }
+    else
+    {
+      fMin[axis] = -FLT_MAX;
+      fMax[axis] =  FLT_MAX;
+    }
+  }
+}
@@ -38,6 +38,9 @@
 #include "G4Timer.hh"
 #include "G4GeometryManager.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
 
 #ifdef  G4GEOMETRY_VOXELDEBUG
 #include "G4ios.hh"
@@ -46,8 +49,11 @@
 // Needed for building optimisations
 //
 #include "G4LogicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelCache.hh"
+#include "G4SmartBVH.hh"
 #include "voxeldefs.hh"
 
 // Needed for setting the extent for tolerance value
@@ -67,7 +73,7 @@ G4ThreadLocal G4GeometryManager* G4GeometryManager::fgInstance = 0;
 // ***************************************************************************
 //
 G4GeometryManager::G4GeometryManager() 
-  : fIsClosed(false)
+  : fIsClosed(false), fNoVoxelThreads(1)
 {
 }
 
@@ -156,6 +162,13 @@ void G4GeometryManager::BuildOptimisations(G4bool allOpts, G4bool verbose)
    G4LogicalVolumeStore* Store = G4LogicalVolumeStore::GetInstance();
    G4LogicalVolume* volume;
    G4SmartVoxelHeader* head;
+   std::vector<G4LogicalVolume*> placedVolumes;
+   G4int noBVHs = 0;
+   G4SmartVoxelCache* cache = 0;
+   if (!fVoxelCacheFile.empty())
+   {
+     cache = new G4SmartVoxelCache(fVoxelCacheFile);
+   }
  
    for (size_t n=0; n<Store->size(); n++)
    {
@@ -167,6 +180,8 @@ void G4GeometryManager::BuildOptimisations(G4bool allOpts, G4bool verbose)
      head = volume->GetVoxelHeader();
      delete head;
      volume->SetVoxelHeader(0);
+     delete volume->GetBVH();
+     volume->SetBVH(0);
      if (    ( (volume->IsToOptimise())
             && (volume->GetNoDaughters()>=kMinVoxelVolumesLevel1&&allOpts) )
           || ( (volume->GetNoDaughters()==1)
@@ -178,6 +193,45 @@ void G4GeometryManager::BuildOptimisations(G4bool allOpts, G4bool verbose)
               << "     Examining logical volume name = "
               << volume->GetName() << G4endl;
 #endif
+       G4bool placed = (volume->GetNoDaughters()!=1)
+                    || (!volume->GetDaughter(0)->IsReplicated());
+
+       // Volumes flagged for it are given a bounding volume hierarchy
+       // of their placed daughters instead of voxels
+       //
+       if ( placed && volume->IsBVHOptimised() )
+       {
+         volume->SetBVH(new G4SmartBVH(volume));
+         ++noBVHs;
+         continue;
+       }
+
+       // Voxels of volumes with placed daughters may be restored from
+       // the cache file
+       //
+       if (cache && placed)
+       {
+         head = cache->Retrieve(volume);
+         if (head)
+         {
+           volume->SetVoxelHeader(head);
+           if (verbose)
+           {
+             stats.push_back( G4SmartVoxelStat( volume, head, 0., 0. ) );
+           }
+           continue;
+         }
+       }
+
+       // Volumes with placed daughters are left to BuildVoxelsConcurrently();
+       // the voxelisation of replicated daughters modifies their state and
+       // is kept in this thread
+       //
+       if ( (fNoVoxelThreads>1) && placed )
+       {
+         placedVolumes.push_back(volume);
+         continue;
+       }
        head = new G4SmartVoxelHeader(volume);
        if (head)
        {
@@ -210,6 +264,27 @@ void G4GeometryManager::BuildOptimisations(G4bool allOpts, G4bool verbose)
 #endif
      }
   }
+  if (placedVolumes.size())
+  {
+     BuildVoxelsConcurrently(placedVolumes, stats, verbose);
+  }
+  if (cache)
+  {
+     cache->Write();
+     if (verbose)
+     {
+       G4cout << "G4GeometryManager::BuildOptimisations -- voxels of "
+              << cache->GetNoRestored() << " volumes restored from, and of "
+              << cache->GetNoMissing() << " volumes built for, "
+              << fVoxelCacheFile << G4endl;
+     }
+     delete cache;
+  }
+  if (verbose && noBVHs)
+  {
+     G4cout << "G4GeometryManager::BuildOptimisations -- bounding volume "
+            << "hierarchies built for " << noBVHs << " volumes" << G4endl;
+  }
   if (verbose)
   {
      allTimer.Stop();
@@ -218,6 +293,175 @@ void G4GeometryManager::BuildOptimisations(G4bool allOpts, G4bool verbose)
   }
 }
 
+// ***************************************************************************
+// Helpers for building voxels in several threads: a shared list of volumes
+// is consumed in order by all threads, each header being stored at the
+// index of its volume.
+// ***************************************************************************
+//
+namespace
+{
+  G4Mutex voxelBuildMutex = G4MUTEX_INITIALIZER;
+
+  struct G4VoxelBuildList
+  {
+    std::vector<G4LogicalVolume*>* volumes;
+    std::vector<G4SmartVoxelHeader*> heads;
+    std::vector<G4double> times;
+    size_t next;
+    size_t done;
+
+    G4bool BuildNext()
+    {
+      G4AutoLock l(&voxelBuildMutex);
+      size_t n = next;
+      if (n >= volumes->size())  { return false; }
+      ++next;
+      l.unlock();
+
+      G4Timer timer;
+      timer.Start();
+      G4SmartVoxelHeader* head = new G4SmartVoxelHeader((*volumes)[n]);
+      timer.Stop();
+
+      l.lock();
+      heads[n] = head;
+      times[n] = timer.GetRealElapsed();
+      ++done;
+      return true;
+    }
+  };
+
+#ifdef G4MULTITHREADED
+  G4ThreadFunReturnType G4VoxelBuildThread(G4ThreadFunArgType arg)
+  {
+    G4VoxelBuildList* list = static_cast<G4VoxelBuildList*>(arg);
+
+    // Volumes are accessed through copies of the master thread's data
+    //
+    G4LVManager& lvManager =
+      const_cast<G4LVManager&>(G4LogicalVolume::GetSubInstanceManager());
+    G4PVManager& pvManager =
+      const_cast<G4PVManager&>(G4VPhysicalVolume::GetSubInstanceManager());
+    lvManager.SlaveCopySubInstanceArray();
+    pvManager.SlaveCopySubInstanceArray();
+
+    while (list->BuildNext()) {;}
+
+    lvManager.FreeSlave();
+    pvManager.FreeSlave();
+    return 0;
+  }
+#endif
+}
+
+// ***************************************************************************
+// Builds the voxels of the given volumes, which must have placed daughters,
+// using up to fNoVoxelThreads threads including the calling one.
+// Headers are attached, and statistics collected, in the order of volumes.
+// ***************************************************************************
+//
+void G4GeometryManager::BuildVoxelsConcurrently(
+                                   std::vector<G4LogicalVolume*>& volumes,
+                                   std::vector<G4SmartVoxelStat>& stats,
+                                   G4bool verbose )
+{
+  G4VoxelBuildList list;
+  list.volumes = &volumes;
+  list.heads.resize(volumes.size(), 0);
+  list.times.resize(volumes.size(), 0.);
+  list.next = 0;
+  list.done = 0;
+
+#ifdef G4MULTITHREADED
+  G4int nThreads = fNoVoxelThreads;
+  if (nThreads > G4int(volumes.size()))  { nThreads = volumes.size(); }
+#else
+  G4int nThreads = 1;
+#endif
+
+#ifdef G4MULTITHREADED
+  std::vector<G4Thread> threads(nThreads>1 ? nThreads-1 : 0);
+  for (size_t i=0; i<threads.size(); ++i)
+  {
+#ifdef WIN32
+    G4THREADCREATE(&threads[i], (LPTHREAD_START_ROUTINE)&G4VoxelBuildThread,
+                   &list);
+#else
+    G4THREADCREATE(&threads[i], &G4VoxelBuildThread, &list);
+#endif
+  }
+#endif
+
+  // The calling thread takes its share and reports progress
+  //
+  size_t nReported = 0;
+  while (list.BuildNext())
+  {
+    if (verbose)
+    {
+      G4AutoLock l(&voxelBuildMutex);
+      size_t nDone = list.done;
+      l.unlock();
+      if (nDone*10 >= (nReported+1)*volumes.size())
+      {
+        nReported = nDone*10/volumes.size();
+        G4cout << "G4GeometryManager::BuildOptimisations -- voxelised "
+               << nDone << " of " << volumes.size() << " volumes using "
+               << nThreads << " threads" << G4endl;
+      }
+    }
+  }
+
+#ifdef G4MULTITHREADED
+  for (size_t i=0; i<threads.size(); ++i)
+  {
+    G4THREADJOIN(threads[i]);
+  }
+#endif
+
+  for (size_t n=0; n<volumes.size(); ++n)
+  {
+    volumes[n]->SetVoxelHeader(list.heads[n]);
+    if (verbose)
+    {
+      // Per-volume CPU time is not available from other threads:
+      // the elapsed real time of the build is reported instead
+      //
+      stats.push_back( G4SmartVoxelStat( volumes[n], list.heads[n],
+                                         0., list.times[n] ) );
+    }
+  }
+}
+
+// ***************************************************************************
+// Sets the number of threads used for building voxels.
+// ***************************************************************************
+//
+void G4GeometryManager::SetNumberOfVoxelThreads(G4int nThreads)
+{
+  fNoVoxelThreads = (nThreads > 1) ? nThreads : 1;
+}
+
+G4int G4GeometryManager::GetNumberOfVoxelThreads() const
+{
+  return fNoVoxelThreads;
+}
+
+// ***************************************************************************
+// Sets the file used for keeping voxels between jobs.
+// ***************************************************************************
+//
+void G4GeometryManager::SetVoxelCacheFile(const G4String& fileName)
+{
+  fVoxelCacheFile = fileName;
+}
+
+const G4String& G4GeometryManager::GetVoxelCacheFile() const
+{
+  return fVoxelCacheFile;
+}
+
 // ***************************************************************************
 // Creates optimisation info for the specified volumes subtree.
 // ***************************************************************************
@@ -236,24 +480,35 @@ void G4GeometryManager::BuildOptimisations(G4bool allOpts,
    G4SmartVoxelHeader* head = tVolume->GetVoxelHeader();
    delete head;
    tVolume->SetVoxelHeader(0);
+   delete tVolume->GetBVH();
+   tVolume->SetBVH(0);
    if (    ( (tVolume->IsToOptimise())
           && (tVolume->GetNoDaughters()>=kMinVoxelVolumesLevel1&&allOpts) )
         || ( (tVolume->GetNoDaughters()==1)
           && (tVolume->GetDaughter(0)->IsReplicated()==true) ) ) 
    {
-     head = new G4SmartVoxelHeader(tVolume);
-     if (head)
+     if ( tVolume->IsBVHOptimised()
+       && ( (tVolume->GetNoDaughters()!=1)
+         || (!tVolume->GetDaughter(0)->IsReplicated()) ) )
      {
-       tVolume->SetVoxelHeader(head);
+       tVolume->SetBVH(new G4SmartBVH(tVolume));
      }
      else
      {
-       std::ostringstream message;
-       message << "VoxelHeader allocation error." << G4endl
-               << "Allocation of new VoxelHeader" << G4endl
-               << "        for volume " << tVolume->GetName() << " failed.";
-       G4Exception("G4GeometryManager::BuildOptimisations()", "GeomMgt0003",
-                   FatalException, message);
+       head = new G4SmartVoxelHeader(tVolume);
+       if (head)
+       {
+         tVolume->SetVoxelHeader(head);
+       }
+       else
+       {
+         std::ostringstream message;
+         message << "VoxelHeader allocation error." << G4endl
+                 << "Allocation of new VoxelHeader" << G4endl
+                 << "        for volume " << tVolume->GetName() << " failed.";
+         G4Exception("G4GeometryManager::BuildOptimisations()",
+                     "GeomMgt0003", FatalException, message);
+       }
      }
    }
    else
@@ -289,6 +544,8 @@ void G4GeometryManager::DeleteOptimisations()
     tVolume=(*Store)[n];
     delete tVolume->GetVoxelHeader();
     tVolume->SetVoxelHeader(0);
+    delete tVolume->GetBVH();
+    tVolume->SetBVH(0);
   }
 }
 
@@ -308,6 +565,8 @@ void G4GeometryManager::DeleteOptimisations(G4VPhysicalVolume* pVolume)
   if (!tVolume) { return DeleteOptimisations(); }
   delete tVolume->GetVoxelHeader();
   tVolume->SetVoxelHeader(0);
+  delete tVolume->GetBVH();
+  tVolume->SetBVH(0);
 
   // Scan recursively the associated logical volume tree
   //
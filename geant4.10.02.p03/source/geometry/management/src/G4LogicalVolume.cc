@@ -82,7 +82,8 @@ G4LogicalVolume::G4LogicalVolume( G4VSolid* pSolid,
                                   G4UserLimits* pULimits,
                                   G4bool optimise )
  : fDaughters(0,(G4VPhysicalVolume*)0), 
-   fVoxel(0), fOptimise(optimise), fRootRegion(false), fLock(false),
+   fVoxel(0), fOptimise(optimise), fBVH(0), fBVHOptimise(false),
+   fRootRegion(false), fLock(false),
    fSmartless(2.), fVisAttributes(0), fRegion(0), fBiasWeight(1.)
 {
   // Initialize 'Shadow'/master pointers - for use in copying to workers
@@ -122,7 +123,8 @@ G4LogicalVolume::G4LogicalVolume( G4VSolid* pSolid,
 G4LogicalVolume::G4LogicalVolume( __void__& )
  : fDaughters(0,(G4VPhysicalVolume*)0),
    fName(""), fUserLimits(0),
-   fVoxel(0), fOptimise(true), fRootRegion(false), fLock(false),
+   fVoxel(0), fOptimise(true), fBVH(0), fBVHOptimise(false),
+   fRootRegion(false), fLock(false),
    fSmartless(2.), fVisAttributes(0), fRegion(0), fBiasWeight(1.),
    fSolid(0), fSensitiveDetector(0), fFieldManager(0), lvdata(0)
 {
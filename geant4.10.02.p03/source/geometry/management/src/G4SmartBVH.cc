@@ -0,0 +1,264 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//
+// class G4SmartBVH implementation
+//
+// --------------------------------------------------------------------
+
+#include <cfloat>
+#include <algorithm>
+#include <utility>
+
+#include "G4SmartBVH.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4GeometryTolerance.hh"
+
+// ***************************************************************************
+// Constructor: computes the bounding boxes of the daughters and builds the
+// tree over them.
+// ***************************************************************************
+//
+G4SmartBVH::G4SmartBVH(G4LogicalVolume* pVolume)
+  : fDepth(0)
+{
+  const G4int nDaughters = pVolume->GetNoDaughters();
+  fDaughters.resize(nDaughters);
+  fBoxes.resize(nDaughters);
+  fCentres.resize(3*nDaughters);
+
+  const G4double margin =
+    G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  for (G4int i=0; i<nDaughters; ++i)
+  {
+    // Daughters with no extent along an axis are unbounded along it,
+    // and are always candidates
+    //
+    fDaughters[i] = i;
+    G4BVHBox& box = fBoxes[i];
+    box.Compute(pVolume->GetDaughter(i), margin);
+    for (G4int axis=0; axis<3; ++axis)
+    {
+      fCentres[3*i+axis] = 0.5*(G4double(box.fMin[axis])+box.fMax[axis]);
+    }
+  }
+
+  fNodes.reserve(2*nDaughters);
+  if (nDaughters)  { BuildNode(0, nDaughters, 1); }
+
+  std::vector<G4double>().swap(fCentres);
+}
+
+// ***************************************************************************
+// Destructor
+// ***************************************************************************
+//
+G4SmartBVH::~G4SmartBVH()
+{
+}
+
+// ***************************************************************************
+// Builds a node over the entries [first, first+count). The node becomes a
+// leaf when it holds few enough entries and no split lowers the surface
+// area cost, otherwise the entries are partitioned at the best bin boundary
+// and both children are built.
+// ***************************************************************************
+//
+G4int G4SmartBVH::BuildNode(G4int first, G4int count, G4int depth)
+{
+  const G4int index = G4int(fNodes.size());
+  fNodes.push_back(G4BVHNode());
+  if (depth > fDepth)  { fDepth = depth; }
+
+  // Bounds of the boxes and of their centres
+  //
+  G4double bmin[3], bmax[3], cmin[3], cmax[3];
+  for (G4int axis=0; axis<3; ++axis)
+  {
+    bmin[axis] = cmin[axis] =  DBL_MAX;
+    bmax[axis] = cmax[axis] = -DBL_MAX;
+  }
+  for (G4int i=first; i<first+count; ++i)
+  {
+    for (G4int axis=0; axis<3; ++axis)
+    {
+      bmin[axis] = std::min(bmin[axis], G4double(fBoxes[i].fMin[axis]));
+      bmax[axis] = std::max(bmax[axis], G4double(fBoxes[i].fMax[axis]));
+      cmin[axis] = std::min(cmin[axis], fCentres[3*i+axis]);
+      cmax[axis] = std::max(cmax[axis], fCentres[3*i+axis]);
+    }
+  }
+  for (G4int axis=0; axis<3; ++axis)
+  {
+    fNodes[index].fBox.fMin[axis] = G4float(bmin[axis]);
+    fNodes[index].fBox.fMax[axis] = G4float(bmax[axis]);
+  }
+
+  // Find the split of lowest cost: sum over both sides of the area of
+  // their bounds times their number of entries
+  //
+  G4int bestAxis = -1, bestBin = 0;
+  G4double bestCost = DBL_MAX;
+  if ( (count > 1) && (depth < kMaxBVHDepth) )
+  {
+    for (G4int axis=0; axis<3; ++axis)
+    {
+      const G4double width = cmax[axis]-cmin[axis];
+      if ( !(width > 0.) )  { continue; }
+      const G4double scale = kNoBVHBins/width;
+
+      G4int binCount[kNoBVHBins];
+      G4double binMin[kNoBVHBins][3], binMax[kNoBVHBins][3];
+      for (G4int b=0; b<kNoBVHBins; ++b)
+      {
+        binCount[b] = 0;
+        for (G4int k=0; k<3; ++k)
+        {
+          binMin[b][k] =  DBL_MAX;
+          binMax[b][k] = -DBL_MAX;
+        }
+      }
+      for (G4int i=first; i<first+count; ++i)
+      {
+        G4int b = G4int((fCentres[3*i+axis]-cmin[axis])*scale);
+        if (b >= kNoBVHBins)  { b = kNoBVHBins-1; }
+        ++binCount[b];
+        for (G4int k=0; k<3; ++k)
+        {
+          binMin[b][k] = std::min(binMin[b][k], G4double(fBoxes[i].fMin[k]));
+          binMax[b][k] = std::max(binMax[b][k], G4double(fBoxes[i].fMax[k]));
+        }
+      }
+
+      // Sweep from the right to get the cost of the right sides, then
+      // from the left evaluating each boundary
+      //
+      G4double rightCost[kNoBVHBins];
+      G4double rmin[3], rmax[3];
+      G4int rightCount = 0;
+      for (G4int k=0; k<3; ++k)  { rmin[k] = DBL_MAX; rmax[k] = -DBL_MAX; }
+      for (G4int b=kNoBVHBins-1; b>0; --b)
+      {
+        rightCount += binCount[b];
+        for (G4int k=0; k<3; ++k)
+        {
+          rmin[k] = std::min(rmin[k], binMin[b][k]);
+          rmax[k] = std::max(rmax[k], binMax[b][k]);
+        }
+        rightCost[b] = rightCount ? rightCount*Area(rmin, rmax) : 0.;
+      }
+      G4double lmin[3], lmax[3];
+      G4int leftCount = 0;
+      for (G4int k=0; k<3; ++k)  { lmin[k] = DBL_MAX; lmax[k] = -DBL_MAX; }
+      for (G4int b=1; b<kNoBVHBins; ++b)
+      {
+        leftCount += binCount[b-1];
+        for (G4int k=0; k<3; ++k)
+        {
+          lmin[k] = std::min(lmin[k], binMin[b-1][k]);
+          lmax[k] = std::max(lmax[k], binMax[b-1][k]);
+        }
+        if ( (leftCount == 0) || (leftCount == count) )  { continue; }
+        const G4double cost = leftCount*Area(lmin, lmax) + rightCost[b];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestAxis = axis;
+          bestBin  = b;
+        }
+      }
+    }
+  }
+
+  // A leaf costs the area of the node for each of its entries
+  //
+  if ( (count <= kMaxBVHLeafSize) && !(bestCost < count*Area(bmin, bmax)) )
+  {
+    bestAxis = -1;
+  }
+
+  G4int half;
+  if (bestAxis >= 0)
+  {
+    // Partition the entries at the boundary of the chosen bin
+    //
+    const G4double scale = kNoBVHBins/(cmax[bestAxis]-cmin[bestAxis]);
+    G4int i = first, j = first+count-1;
+    while (i <= j)
+    {
+      G4int b = G4int((fCentres[3*i+bestAxis]-cmin[bestAxis])*scale);
+      if (b >= kNoBVHBins)  { b = kNoBVHBins-1; }
+      if (b < bestBin)
+      {
+        ++i;
+      }
+      else
+      {
+        std::swap(fDaughters[i], fDaughters[j]);
+        std::swap(fBoxes[i], fBoxes[j]);
+        for (G4int k=0; k<3; ++k)
+        {
+          std::swap(fCentres[3*i+k], fCentres[3*j+k]);
+        }
+        --j;
+      }
+    }
+    half = i-first;
+  }
+  else if ( (count > kMaxBVHLeafSize) && (depth < kMaxBVHDepth) )
+  {
+    // The centres of too many entries for a leaf coincide:
+    // split them in halves
+    //
+    half = count/2;
+  }
+  else
+  {
+    fNodes[index].fFirst = first;
+    fNodes[index].fCount = count;
+    return index;
+  }
+
+  BuildNode(first, half, depth+1);
+  const G4int second = BuildNode(first+half, count-half, depth+1);
+  fNodes[index].fFirst = second;
+  fNodes[index].fCount = 0;
+  return index;
+}
+
+// ***************************************************************************
+// Surface area of a box, the cost weight of a node in the heuristic.
+// ***************************************************************************
+//
+G4double G4SmartBVH::Area(const G4double bmin[3], const G4double bmax[3])
+{
+  const G4double dx = bmax[0]-bmin[0];
+  const G4double dy = bmax[1]-bmin[1];
+  const G4double dz = bmax[2]-bmin[2];
+  return 2.*(dx*dy+dy*dz+dz*dx);
+}
@@ -0,0 +1,493 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// class G4SmartVoxelCache implementation
+//
+// --------------------------------------------------------------------
+
+#include "G4SmartVoxelCache.hh"
+
+#include "G4SmartVoxelHeader.hh"
+#include "G4SmartVoxelNode.hh"
+#include "G4SmartVoxelProxy.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4GeometryTolerance.hh"
+#include "voxeldefs.hh"
+#include "G4ios.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#ifndef WIN32
+#include <unistd.h>
+#else
+#include <process.h>
+#endif
+
+namespace
+{
+  const char     kCacheMagic[8]  = { 'G','4','V','O','X','C','H','1' };
+  const uint32_t kCacheVersion   = 1;
+  const uint32_t kCacheByteOrder = 0x01020304;
+
+  const G4int kMaxCachedSlices = 1000000;  // Sanity limits on restoring
+  const G4int kMaxCachedDepth  = 16;
+
+  // Slice tags
+  //
+  const char kSameProxy  = 0;  // Proxy of the previous slice
+  const char kSameTarget = 1;  // New proxy, node/header of previous slice
+  const char kNewNode    = 2;  // New proxy and node
+  const char kNewHeader  = 3;  // New proxy and header
+
+  // FNV-1a hash of a sequence of bytes
+  //
+  inline uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+  {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i=0; i<size; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+    return hash;
+  }
+
+  template <class T> inline uint64_t Hash(uint64_t hash, const T& value)
+  {
+    return HashBytes(hash, &value, sizeof(T));
+  }
+
+  template <class T> inline void Put(std::vector<char>& buffer, const T& value)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes+sizeof(T));
+  }
+
+  template <class T> inline G4bool Get(const char*& pos, const char* end,
+                                       T& value)
+  {
+    if (end-pos < G4long(sizeof(T)))  { return false; }
+    std::memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+}
+
+// ***************************************************************************
+// Constructor: reads the file, if it exists, and indexes its entries.
+// Files which are not valid are ignored, and will be overwritten.
+// ***************************************************************************
+//
+G4SmartVoxelCache::G4SmartVoxelCache(const G4String& fileName)
+  : fFileName(fileName), fNoRestored(0), fNoMissing(0)
+{
+  fSettingsKey = 14695981039346656037ULL;
+  fSettingsKey = Hash(fSettingsKey, kCacheVersion);
+  fSettingsKey = Hash(fSettingsKey,
+    G4GeometryTolerance::GetInstance()->GetSurfaceTolerance());
+  fSettingsKey = Hash(fSettingsKey, kMaxVoxelNodes);
+  fSettingsKey = Hash(fSettingsKey, kMinVoxelVolumesLevel1);
+  fSettingsKey = Hash(fSettingsKey, kMinVoxelVolumesLevel2);
+  fSettingsKey = Hash(fSettingsKey, kMinVoxelVolumesLevel3);
+
+  std::ifstream in(fFileName.c_str(), std::ios::in|std::ios::binary);
+  if (!in)  { return; }
+  in.seekg(0, std::ios::end);
+  std::streamoff size = in.tellg();
+  in.seekg(0, std::ios::beg);
+  if (size <= 0)  { return; }
+  fData.resize(size);
+  in.read(&fData[0], size);
+  if (!in)  { fData.clear(); return; }
+
+  const char* pos = &fData[0];
+  const char* end = pos + fData.size();
+  char magic[8];
+  uint32_t version = 0, byteOrder = 0;
+  uint64_t nEntries = 0;
+  G4bool valid = (end-pos >= 8);
+  if (valid)
+  {
+    std::memcpy(magic, pos, 8);
+    pos += 8;
+    valid = (std::memcmp(magic, kCacheMagic, 8) == 0)
+         && Get(pos, end, version) && (version == kCacheVersion)
+         && Get(pos, end, byteOrder) && (byteOrder == kCacheByteOrder)
+         && Get(pos, end, nEntries);
+  }
+  for (uint64_t i=0; valid && i<nEntries; ++i)
+  {
+    uint64_t key = 0, entrySize = 0;
+    valid = Get(pos, end, key) && Get(pos, end, entrySize)
+         && (uint64_t(end-pos) >= entrySize);
+    if (valid)
+    {
+      fEntries[key] = std::make_pair(size_t(pos-&fData[0]), size_t(entrySize));
+      pos += entrySize;
+    }
+  }
+  if (!valid)
+  {
+    std::ostringstream message;
+    message << "Voxel cache file " << fFileName << " is not valid." << G4endl
+            << "        Its contents are ignored; it will be rewritten.";
+    G4Exception("G4SmartVoxelCache::G4SmartVoxelCache()", "GeomMgt1003",
+                JustWarning, message);
+    fEntries.clear();
+    fData.clear();
+  }
+}
+
+// ***************************************************************************
+// Destructor
+// ***************************************************************************
+//
+G4SmartVoxelCache::~G4SmartVoxelCache()
+{
+}
+
+// ***************************************************************************
+// Restores the voxels of the volume from the file, if present.
+// ***************************************************************************
+//
+G4SmartVoxelHeader* G4SmartVoxelCache::Retrieve(G4LogicalVolume* pVolume)
+{
+  uint64_t key = VolumeKey(pVolume);
+  fVolumes.push_back(std::make_pair(key, pVolume));
+
+  G4SmartVoxelHeader* head = 0;
+  std::map<uint64_t, std::pair<size_t,size_t> >::const_iterator
+    pos = fEntries.find(key);
+  if (pos != fEntries.end())
+  {
+    const char* begin = &fData[0] + pos->second.first;
+    const char* end = begin + pos->second.second;
+    head = ReadHeader(begin, end, pVolume->GetNoDaughters(), 0);
+    if (head && (begin != end))
+    {
+      delete head;
+      head = 0;
+    }
+    if (head && ( (pVolume->GetNoDaughters()!=1)
+               || (!pVolume->GetDaughter(0)->IsReplicated()) ))
+    {
+      head->BuildDaughterExtents(pVolume);
+    }
+  }
+  if (head)  { ++fNoRestored; }
+  else       { ++fNoMissing; }
+  return head;
+}
+
+// ***************************************************************************
+// Rewrites the file with the voxels of all the recorded volumes.
+// The file is first written under a temporary name, then renamed, so that
+// concurrent jobs never read a partially written file.
+// ***************************************************************************
+//
+G4bool G4SmartVoxelCache::Write()
+{
+  if (!fNoMissing)  { return true; }
+
+  std::vector<char> buffer;
+  buffer.insert(buffer.end(), kCacheMagic, kCacheMagic+8);
+  Put(buffer, kCacheVersion);
+  Put(buffer, kCacheByteOrder);
+  size_t nEntriesPos = buffer.size();
+  Put(buffer, uint64_t(0));
+
+  uint64_t nEntries = 0;
+  std::map<uint64_t, G4bool> written;
+  for (size_t i=0; i<fVolumes.size(); ++i)
+  {
+    const G4SmartVoxelHeader* head = fVolumes[i].second->GetVoxelHeader();
+    if (!head || written[fVolumes[i].first])  { continue; }
+    written[fVolumes[i].first] = true;
+    Put(buffer, fVolumes[i].first);
+    size_t sizePos = buffer.size();
+    Put(buffer, uint64_t(0));
+    WriteHeader(buffer, head);
+    uint64_t entrySize = buffer.size() - sizePos - sizeof(uint64_t);
+    std::memcpy(&buffer[sizePos], &entrySize, sizeof(uint64_t));
+    ++nEntries;
+  }
+  std::memcpy(&buffer[nEntriesPos], &nEntries, sizeof(uint64_t));
+
+  std::ostringstream tmpName;
+#ifndef WIN32
+  tmpName << fFileName << ".tmp" << getpid();
+#else
+  tmpName << fFileName << ".tmp" << _getpid();
+#endif
+  std::ofstream out(tmpName.str().c_str(),
+                    std::ios::out|std::ios::binary|std::ios::trunc);
+  if (out)
+  {
+    out.write(&buffer[0], buffer.size());
+    out.close();
+  }
+  G4bool ok = !out.fail();
+#ifdef WIN32
+  if (ok)  { std::remove(fFileName.c_str()); }
+#endif
+  if (ok)  { ok = (std::rename(tmpName.str().c_str(), fFileName.c_str())==0); }
+  if (!ok)
+  {
+    std::remove(tmpName.str().c_str());
+    std::ostringstream message;
+    message << "Cannot write voxel cache file " << fFileName << " !";
+    G4Exception("G4SmartVoxelCache::Write()", "GeomMgt1003",
+                JustWarning, message);
+  }
+  return ok;
+}
+
+// ***************************************************************************
+// Computes the key of the voxels of a volume.
+// ***************************************************************************
+//
+uint64_t G4SmartVoxelCache::VolumeKey(const G4LogicalVolume* pVolume)
+{
+  uint64_t key = fSettingsKey;
+  key = Hash(key, SolidKey(pVolume->GetSolid()));
+  key = Hash(key, pVolume->GetSmartless());
+  G4int nDaughters = pVolume->GetNoDaughters();
+  key = Hash(key, nDaughters);
+  for (G4int i=0; i<nDaughters; ++i)
+  {
+    const G4VPhysicalVolume* daughter = pVolume->GetDaughter(i);
+    key = Hash(key, SolidKey(daughter->GetLogicalVolume()->GetSolid()));
+    G4int replicated = daughter->IsReplicated() ? 1 : 0;
+    key = Hash(key, replicated);
+    const G4ThreeVector& tlate = daughter->GetTranslation();
+    key = Hash(key, tlate.x());
+    key = Hash(key, tlate.y());
+    key = Hash(key, tlate.z());
+    const G4RotationMatrix* rot = daughter->GetRotation();
+    if (rot)
+    {
+      G4double elements[9] = { rot->xx(), rot->xy(), rot->xz(),
+                               rot->yx(), rot->yy(), rot->yz(),
+                               rot->zx(), rot->zy(), rot->zz() };
+      key = HashBytes(key, elements, sizeof(elements));
+    }
+    else
+    {
+      key = Hash(key, G4int(-1));
+    }
+  }
+  return key;
+}
+
+// ***************************************************************************
+// Computes the key of a solid from its description. Keys are kept, as
+// solids are usually shared by many placements.
+// ***************************************************************************
+//
+uint64_t G4SmartVoxelCache::SolidKey(const G4VSolid* pSolid)
+{
+  std::map<const G4VSolid*, uint64_t>::const_iterator pos =
+    fSolidKeys.find(pSolid);
+  if (pos != fSolidKeys.end())  { return pos->second; }
+
+  std::ostringstream description;
+  description << std::setprecision(17);
+  pSolid->StreamInfo(description);
+  const std::string& info = description.str();
+  uint64_t key = HashBytes(14695981039346656037ULL, info.data(), info.size());
+  fSolidKeys[pSolid] = key;
+  return key;
+}
+
+// ***************************************************************************
+// Serialises a header and, recursively, its slices.
+// ***************************************************************************
+//
+void G4SmartVoxelCache::WriteHeader(std::vector<char>& buffer,
+                                    const G4SmartVoxelHeader* pHeader) const
+{
+  Put(buffer, int32_t(pHeader->GetMinEquivalentSliceNo()));
+  Put(buffer, int32_t(pHeader->GetMaxEquivalentSliceNo()));
+  Put(buffer, int32_t(pHeader->GetAxis()));
+  Put(buffer, int32_t(pHeader->GetParamAxis()));
+  Put(buffer, pHeader->GetMinExtent());
+  Put(buffer, pHeader->GetMaxExtent());
+  G4int nSlices = pHeader->GetNoSlices();
+  Put(buffer, int32_t(nSlices));
+
+  const G4SmartVoxelProxy* lastProxy = 0;
+  for (G4int i=0; i<nSlices; ++i)
+  {
+    const G4SmartVoxelProxy* proxy = pHeader->GetSlice(i);
+    if (proxy == lastProxy)
+    {
+      Put(buffer, kSameProxy);
+    }
+    else if (lastProxy && (proxy->IsNode() == lastProxy->IsNode())
+          && ( proxy->IsNode() ? (proxy->GetNode() == lastProxy->GetNode())
+                               : (proxy->GetHeader() == lastProxy->GetHeader()) ))
+    {
+      Put(buffer, kSameTarget);
+    }
+    else if (proxy->IsNode())
+    {
+      Put(buffer, kNewNode);
+      WriteNode(buffer, proxy->GetNode());
+    }
+    else
+    {
+      Put(buffer, kNewHeader);
+      WriteHeader(buffer, proxy->GetHeader());
+    }
+    lastProxy = proxy;
+  }
+}
+
+// ***************************************************************************
+// Serialises a node.
+// ***************************************************************************
+//
+void G4SmartVoxelCache::WriteNode(std::vector<char>& buffer,
+                                  const G4SmartVoxelNode* pNode) const
+{
+  Put(buffer, int32_t(pNode->GetMinEquivalentSliceNo()));
+  Put(buffer, int32_t(pNode->GetMaxEquivalentSliceNo()));
+  G4int nContained = pNode->GetNoContained();
+  Put(buffer, int32_t(nContained));
+  for (G4int i=0; i<nContained; ++i)
+  {
+    Put(buffer, int32_t(pNode->GetVolume(i)));
+  }
+}
+
+// ***************************************************************************
+// Restores a header and its slices. Returns null if the data are not
+// consistent with a volume of nDaughters daughters.
+// ***************************************************************************
+//
+G4SmartVoxelHeader*
+G4SmartVoxelCache::ReadHeader(const char*& pos, const char* end,
+                              G4int nDaughters, G4int depth) const
+{
+  int32_t minEquivalent, maxEquivalent, axis, paramAxis, nSlices;
+  G4double minExtent, maxExtent;
+  if ( (depth > kMaxCachedDepth)
+    || !Get(pos, end, minEquivalent) || !Get(pos, end, maxEquivalent)
+    || !Get(pos, end, axis) || !Get(pos, end, paramAxis)
+    || !Get(pos, end, minExtent) || !Get(pos, end, maxExtent)
+    || !Get(pos, end, nSlices)
+    || (axis < kXAxis) || (axis > kUndefined)
+    || (paramAxis < kXAxis) || (paramAxis > kUndefined)
+    || (nSlices <= 0) || (nSlices > kMaxCachedSlices) )
+  {
+    return 0;
+  }
+
+  G4SmartVoxelHeader* head = new G4SmartVoxelHeader();
+  head->fminEquivalent = minEquivalent;
+  head->fmaxEquivalent = maxEquivalent;
+  head->faxis = EAxis(axis);
+  head->fparamAxis = EAxis(paramAxis);
+  head->fminExtent = minExtent;
+  head->fmaxExtent = maxExtent;
+  head->fslices.reserve(nSlices);
+
+  G4SmartVoxelProxy* lastProxy = 0;
+  for (G4int i=0; i<nSlices; ++i)
+  {
+    char tag;
+    G4SmartVoxelProxy* proxy = 0;
+    if (!Get(pos, end, tag))  { break; }
+    if (tag == kSameProxy)
+    {
+      proxy = lastProxy;
+    }
+    else if ((tag == kSameTarget) && lastProxy)
+    {
+      if (lastProxy->IsNode())
+        { proxy = new G4SmartVoxelProxy(lastProxy->GetNode()); }
+      else
+        { proxy = new G4SmartVoxelProxy(lastProxy->GetHeader()); }
+    }
+    else if (tag == kNewNode)
+    {
+      G4SmartVoxelNode* node = ReadNode(pos, end, nDaughters);
+      if (node)  { proxy = new G4SmartVoxelProxy(node); }
+    }
+    else if (tag == kNewHeader)
+    {
+      G4SmartVoxelHeader* subHead = ReadHeader(pos, end, nDaughters, depth+1);
+      if (subHead)  { proxy = new G4SmartVoxelProxy(subHead); }
+    }
+    if (!proxy)  { break; }
+    head->fslices.push_back(proxy);
+    lastProxy = proxy;
+  }
+  if (G4int(head->fslices.size()) != nSlices)
+  {
+    delete head;
+    return 0;
+  }
+  return head;
+}
+
+// ***************************************************************************
+// Restores a node. Returns null if its daughter numbers are not valid.
+// ***************************************************************************
+//
+G4SmartVoxelNode*
+G4SmartVoxelCache::ReadNode(const char*& pos, const char* end,
+                            G4int nDaughters) const
+{
+  int32_t minEquivalent, maxEquivalent, nContained;
+  if ( !Get(pos, end, minEquivalent) || !Get(pos, end, maxEquivalent)
+    || !Get(pos, end, nContained)
+    || (nContained < 0) || (nContained > nDaughters) )
+  {
+    return 0;
+  }
+  G4SmartVoxelNode* node = new G4SmartVoxelNode(minEquivalent);
+  node->SetMaxEquivalentSliceNo(maxEquivalent);
+  node->Reserve(nContained);
+  for (G4int i=0; i<nContained; ++i)
+  {
+    int32_t volumeNo;
+    if ( !Get(pos, end, volumeNo) || (volumeNo < 0) || (volumeNo >= nDaughters) )
+    {
+      delete node;
+      return 0;
+    }
+    node->Insert(volumeNo);
+  }
+  return node;
+}
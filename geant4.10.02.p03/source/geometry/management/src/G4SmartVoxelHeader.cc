@@ -49,6 +49,7 @@
 #include "G4LogicalVolume.hh"
 #include "G4VPhysicalVolume.hh"
 #include "G4VoxelLimits.hh"
+#include "G4GeometryTolerance.hh"
 
 #include "voxeldefs.hh"
 #include "G4AffineTransform.hh"
@@ -89,6 +90,21 @@ G4SmartVoxelHeader::G4SmartVoxelHeader(G4LogicalVolume* pVolume,
   }
 }
 
+// ***************************************************************************
+// Protected constructor:
+// builds an empty header, with no slices, to be filled by G4SmartVoxelCache.
+// ***************************************************************************
+//
+G4SmartVoxelHeader::G4SmartVoxelHeader()
+  : fminEquivalent(0),
+    fmaxEquivalent(0),
+    faxis(kUndefined),
+    fparamAxis(kUndefined),
+    fmaxExtent(0.),
+    fminExtent(0.)
+{
+}
+
 // ***************************************************************************
 // Protected constructor:
 // builds and refines voxels between specified limits, considering only
@@ -256,6 +272,25 @@ void G4SmartVoxelHeader::BuildVoxels(G4LogicalVolume* pVolume)
     targetList.push_back(i);
   }
   BuildVoxelsWithinLimits(pVolume, limits, &targetList);
+  BuildDaughterExtents(pVolume);
+}
+
+// ***************************************************************************
+// Computes the bounding boxes of the daughters of the specified volume,
+// used by the navigation for rejecting candidate daughters of a voxel before
+// their solids are queried. The boxes are enlarged by the surface tolerance.
+// ***************************************************************************
+//
+void G4SmartVoxelHeader::BuildDaughterExtents(G4LogicalVolume* pVolume)
+{
+  const G4int nDaughters = pVolume->GetNoDaughters();
+  const G4double margin =
+    G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+  fdaughterExtents.resize(nDaughters);
+  for (G4int i=0; i<nDaughters; i++)
+  {
+    fdaughterExtents[i].Compute(pVolume->GetDaughter(i), margin);
+  }
 }
 
 // ***************************************************************************
@@ -50,6 +50,7 @@ class G4UIcommand;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithABool;
 class G4UIcmdWithAnInteger;
+class G4UIcmdWithAString;
 class G4UIcmdWithADoubleAndUnit;
 class G4TransportationManager;
 class G4GeomTestVolume;
@@ -75,11 +76,13 @@ class G4GeometryMessenger : public G4UImessenger
     void SetPushFlag(G4String newValue);
     void RecursiveOverlapTest();
 
-    G4UIdirectory             *geodir, *navdir, *testdir;
+    G4UIdirectory             *geodir, *navdir, *testdir, *voxdir;
     G4UIcmdWithABool          *chkCmd, *pchkCmd, *verCmd;
     G4UIcmdWithoutParameter   *recCmd, *resCmd;
     G4UIcmdWithADoubleAndUnit *tolCmd;
     G4UIcmdWithAnInteger      *verbCmd, *rslCmd, *rcsCmd, *rcdCmd, *errCmd;
+    G4UIcmdWithAnInteger      *vthCmd;
+    G4UIcmdWithAString        *vcaCmd;
 
     G4double      tol;
     G4int         recLevel, recDepth;
@@ -62,6 +62,7 @@
 #include "G4NavigationHistory.hh"
 #include "G4NormalNavigation.hh"
 #include "G4VoxelNavigation.hh"
+#include "G4BVHNavigation.hh"
 #include "G4ParameterisedNavigation.hh"
 #include "G4ReplicaNavigation.hh"
 #include "G4RegularNavigation.hh"
@@ -305,6 +306,10 @@ class G4Navigator
   inline void EnableBestSafety( G4bool value= false );
     // Enable best-possible evaluation of isotropic safety
 
+  inline void EnableDaughterExtents( G4bool value= true );
+    // Enable rejection of daughters by their bounding boxes in voxelised
+    // volumes, before their solids are queried (enabled by default)
+
  protected:  // with description
 
   void SetSavedState();
@@ -499,6 +504,7 @@ class G4Navigator
   //
   G4NormalNavigation  fnormalNav;
   G4VoxelNavigation fvoxelNav;
+  G4BVHNavigation   fbvhNav;
   G4ParameterisedNavigation fparamNav;
   G4ReplicaNavigation freplicaNav;
   G4RegularNavigation fregularNav;
@@ -111,8 +111,18 @@ class G4VoxelNavigation
     inline void  EnableBestSafety( G4bool flag= false );
       // Enable best-possible evaluation of isotropic safety
 
+    inline void  EnableDaughterExtents( G4bool flag= true );
+      // Enable rejection of candidate daughters by means of their bounding
+      // boxes in the mother frame, before their solids are queried.
+      // Enabled by default; not applied in "check-mode".
+
   protected:
 
+    inline G4double ExtentSafety( const G4DaughterExtent& extent,
+                                  const G4ThreeVector& localPoint ) const;
+      // Lower limit of the isotropic distance from the point to the
+      // daughter bounded by extent. Negative if the point is inside it.
+
     G4double ComputeVoxelSafety( const G4ThreeVector& localPoint ) const;
     G4bool LocateNextVoxel( const G4ThreeVector& localPoint,
                             const G4ThreeVector& localDirection,
@@ -188,6 +198,7 @@ class G4VoxelNavigation
 
     G4bool fCheck;
     G4bool fBestSafety; 
+    G4bool fUseExtents;
 
     G4NavigationLogger* fLogger;
       // Verbosity logger
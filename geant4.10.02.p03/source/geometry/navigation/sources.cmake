@@ -37,6 +37,8 @@ GEANT4_DEFINE_MODULE(NAME G4navigation
     HEADERS
         G4AuxiliaryNavServices.hh
         G4AuxiliaryNavServices.icc
+        G4BVHNavigation.hh
+        G4BVHNavigation.icc
         G4BrentLocator.hh
         G4DrawVoxels.hh
         G4ErrorPropagationNavigator.hh
@@ -73,6 +75,7 @@ GEANT4_DEFINE_MODULE(NAME G4navigation
         G4VoxelSafety.hh
     SOURCES
         G4AuxiliaryNavServices.cc
+        G4BVHNavigation.cc
         G4BrentLocator.cc
         G4DrawVoxels.cc
         G4ErrorPropagationNavigator.cc
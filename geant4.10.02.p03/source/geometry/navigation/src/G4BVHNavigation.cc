@@ -0,0 +1,573 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//
+// class G4BVHNavigation Implementation
+//
+// --------------------------------------------------------------------
+
+#include <functional>
+
+#include "G4BVHNavigation.hh"
+#include "G4NavigationLogger.hh"
+#include "G4AffineTransform.hh"
+#include "G4AuxiliaryNavServices.hh"
+
+// ********************************************************************
+// Constructor
+// ********************************************************************
+//
+G4BVHNavigation::G4BVHNavigation()
+   : fCheck(false)
+{
+  fLogger = new G4NavigationLogger("G4BVHNavigation");
+}
+
+// ********************************************************************
+// Destructor
+// ********************************************************************
+//
+G4BVHNavigation::~G4BVHNavigation()
+{
+  delete fLogger;
+}
+
+// ********************************************************************
+// LevelLocate
+// ********************************************************************
+//
+G4bool
+G4BVHNavigation::LevelLocate( G4NavigationHistory& history,
+                        const G4VPhysicalVolume* blockedVol,
+                        const G4int,
+                        const G4ThreeVector& globalPoint,
+                        const G4ThreeVector* globalDirection,
+                        const G4bool  pLocatedOnEdge, 
+                              G4ThreeVector &localPoint )
+{
+  G4VPhysicalVolume *targetPhysical, *samplePhysical;
+  G4LogicalVolume *targetLogical;
+  G4VSolid *sampleSolid;
+  G4ThreeVector samplePoint;
+
+  targetPhysical = history.GetTopVolume();
+  targetLogical = targetPhysical->GetLogicalVolume();
+  const G4SmartBVH* bvh = targetLogical->GetBVH();
+  if ( bvh->GetNoNodes()==0 )  { return false; }
+
+  // Collect the daughters whose box contains the point
+  //
+  const G4double point[3] = { localPoint.x(), localPoint.y(), localPoint.z() };
+  G4int nodeStack[kMaxBVHDepth+1];
+  G4int stackSize = 0;
+  nodeStack[stackSize++] = 0;
+  fCandidates.clear();
+  while ( stackSize )
+  {
+    const G4int nodeNo = nodeStack[--stackSize];
+    const G4SmartBVH::G4BVHNode& node = bvh->GetNode(nodeNo);
+    if ( BoxSafety(node.fBox, point)>0. )  { continue; }
+    if ( node.fCount==0 )
+    {
+      nodeStack[stackSize++] = node.fFirst;
+      nodeStack[stackSize++] = nodeNo+1;
+    }
+    else
+    {
+      for ( G4int entry=node.fFirst; entry<node.fFirst+node.fCount; ++entry )
+      {
+        if ( BoxSafety(bvh->GetBox(entry), point)<=0. )
+        {
+          fCandidates.push_back(bvh->GetDaughter(entry));
+        }
+      }
+    }
+  }
+
+  // Search candidates in the order of G4NormalNavigation
+  //
+  std::sort(fCandidates.begin(), fCandidates.end(), std::greater<G4int>());
+  for ( size_t i=0; i<fCandidates.size(); ++i )
+  {
+    samplePhysical = targetLogical->GetDaughter(fCandidates[i]);
+    if ( samplePhysical!=blockedVol )
+    {
+      // Setup history
+      //
+      history.NewLevel(samplePhysical, kNormal, samplePhysical->GetCopyNo());
+      sampleSolid = samplePhysical->GetLogicalVolume()->GetSolid();
+      samplePoint = history.GetTopTransform().TransformPoint(globalPoint);
+      if( G4AuxiliaryNavServices::
+          CheckPointOnSurface(sampleSolid, samplePoint, globalDirection, 
+                              history.GetTopTransform(), pLocatedOnEdge) )
+      {
+        // Enter this daughter
+        //
+        localPoint = samplePoint;
+        return true;
+      }
+      else
+      {
+        history.BackLevel();
+      }
+    }
+  }
+  return false;
+}
+
+// ********************************************************************
+// ComputeStep
+// ********************************************************************
+//
+//  On entry
+//    exitNormal, validExitNormal:  for previous exited volume (daughter)
+// 
+//  On exit
+//    exitNormal, validExitNormal:  for mother, if exiting it (else unchanged)
+G4double
+G4BVHNavigation::ComputeStep(const G4ThreeVector &localPoint,
+                             const G4ThreeVector &localDirection,
+                             const G4double currentProposedStepLength,
+                                   G4double &newSafety,
+                                   G4NavigationHistory &history,
+                                   G4bool &validExitNormal,
+                                   G4ThreeVector &exitNormal,
+                                   G4bool &exiting,
+                                   G4bool &entering,
+                                   G4VPhysicalVolume *(*pBlockedPhysical),
+                                   G4int &blockedReplicaNo)
+{
+  G4VPhysicalVolume *motherPhysical, *samplePhysical, *blockedExitedVol=0;
+  G4LogicalVolume *motherLogical;
+  G4VSolid *motherSolid;
+  G4ThreeVector sampleDirection;
+  G4double ourStep=currentProposedStepLength, ourSafety;
+  G4double motherSafety, motherStep=DBL_MAX;
+  G4int localNoDaughters, sampleNo, enteredNo;
+  G4bool motherValidExitNormal=false;
+  G4ThreeVector motherExitNormal; 
+
+  motherPhysical = history.GetTopVolume();
+  motherLogical  = motherPhysical->GetLogicalVolume();
+  motherSolid    = motherLogical->GetSolid();
+  const G4SmartBVH* bvh = motherLogical->GetBVH();
+
+  // Compute mother safety
+  //
+  motherSafety = motherSolid->DistanceToOut(localPoint);
+  ourSafety = motherSafety; // Working isotropic safety
+
+  localNoDaughters = motherLogical->GetNoDaughters();
+  enteredNo = localNoDaughters;
+  
+#ifdef G4VERBOSE
+  if ( fCheck && ( (localNoDaughters>0) || (ourStep < motherSafety) )  )
+  {
+    fLogger->PreComputeStepLog(motherPhysical, motherSafety, localPoint);
+  }
+#endif
+  // Compute daughter safeties & intersections
+  //
+
+  // Exiting normal optimisation
+  //
+  if ( exiting&&validExitNormal )
+  {
+    if ( localDirection.dot(exitNormal)>=kMinExitingNormalCosine )
+    {
+      // Block exited daughter volume
+      //
+      blockedExitedVol = (*pBlockedPhysical);
+      ourSafety = 0;
+    }
+  }
+  exiting  = false;
+  entering = false;
+
+#ifdef G4VERBOSE
+  if ( fCheck )
+  {
+    // Compute early:
+    //  a) to check whether point is (wrongly) outside
+    //               (signaled if step < 0 or step == kInfinity )
+    //  b) to check value against answer of daughters!
+
+    motherStep = motherSolid->DistanceToOut(localPoint,
+                                            localDirection,
+                                            true,
+                                           &motherValidExitNormal,
+                                           &motherExitNormal);
+
+    if( (motherStep >= kInfinity) || (motherStep < 0.0) )
+    {
+      // Error - indication of being outside solid !!
+      fLogger->ReportOutsideMother(localPoint, localDirection, motherPhysical);
+    
+      ourStep = motherStep = 0.0;
+   
+      exiting= true;
+      entering= false;
+    
+      // If we are outside the solid does the normal make sense?
+      validExitNormal= motherValidExitNormal;
+      exitNormal= motherExitNormal;
+    
+      *pBlockedPhysical= 0; // or motherPhysical ?
+      blockedReplicaNo= 0;  // or motherReplicaNumber ?
+    
+      newSafety= 0.0;
+      return ourStep;
+    }
+  }
+#endif
+
+  // Traverse the hierarchy, nearest node first, skipping nodes and
+  // daughters whose box can neither limit the safety nor be crossed
+  // within the current step. Among daughters at the same distance the
+  // one of lowest number is entered, as in G4NormalNavigation.
+  //
+  const G4double point[3] = { localPoint.x(), localPoint.y(), localPoint.z() };
+  const G4double direction[3] = { localDirection.x(), localDirection.y(),
+                                  localDirection.z() };
+  G4double invDirection[3];
+  for ( G4int axis=0; axis<3; ++axis )
+  {
+    invDirection[axis] = (direction[axis]!=0.) ? 1./direction[axis] : 0.;
+  }
+  G4int nodeStack[kMaxBVHDepth+1];
+  G4int stackSize = 0;
+  if ( bvh->GetNoNodes() )  { nodeStack[stackSize++] = 0; }
+
+  while ( stackSize )
+  {
+    const G4int nodeNo = nodeStack[--stackSize];
+    const G4SmartBVH::G4BVHNode& node = bvh->GetNode(nodeNo);
+    if ( !fCheck && (BoxSafety(node.fBox, point)>=ourSafety)
+      && !BoxOnPath(node.fBox, point, direction, invDirection, ourStep) )
+    {
+      continue;
+    }
+    if ( node.fCount==0 )
+    {
+      const G4int firstChild = nodeNo+1, secondChild = node.fFirst;
+      if ( BoxSafety(bvh->GetNode(firstChild).fBox, point)
+         > BoxSafety(bvh->GetNode(secondChild).fBox, point) )
+      {
+        nodeStack[stackSize++] = firstChild;
+        nodeStack[stackSize++] = secondChild;
+      }
+      else
+      {
+        nodeStack[stackSize++] = secondChild;
+        nodeStack[stackSize++] = firstChild;
+      }
+      continue;
+    }
+
+    for ( G4int entry=node.fFirst; entry<node.fFirst+node.fCount; ++entry )
+    {
+      const G4SmartBVH::G4BVHBox& box = bvh->GetBox(entry);
+      if ( !fCheck && (BoxSafety(box, point)>=ourSafety)
+        && !BoxOnPath(box, point, direction, invDirection, ourStep) )
+      {
+        continue;
+      }
+      sampleNo = bvh->GetDaughter(entry);
+      samplePhysical = motherLogical->GetDaughter(sampleNo);
+      if ( samplePhysical==blockedExitedVol )  { continue; }
+
+      G4AffineTransform sampleTf(samplePhysical->GetRotation(),
+                                 samplePhysical->GetTranslation());
+      sampleTf.Invert();
+      const G4ThreeVector samplePoint = sampleTf.TransformPoint(localPoint);
+      const G4VSolid *sampleSolid =
+              samplePhysical->GetLogicalVolume()->GetSolid();
+      const G4double sampleSafety =
+              sampleSolid->DistanceToIn(samplePoint);
+
+      if ( sampleSafety<ourSafety )
+      {
+        ourSafety=sampleSafety;
+      }
+    
+      if ( sampleSafety<=ourStep )
+      {
+        sampleDirection = sampleTf.TransformAxis(localDirection);
+        const G4double sampleStep =
+                sampleSolid->DistanceToIn(samplePoint,sampleDirection);
+#ifdef G4VERBOSE        
+        if( fCheck )
+        {
+          fLogger->PrintDaughterLog(sampleSolid, samplePoint,
+                                    sampleSafety, true,
+                                    sampleDirection, sampleStep);          
+        }
+#endif
+        if ( (sampleStep<ourStep)
+          || ((sampleStep==ourStep) && (sampleNo<enteredNo)) )
+        {
+          ourStep  = sampleStep;
+          enteredNo = sampleNo;
+          entering = true;
+          exiting  = false;
+          *pBlockedPhysical = samplePhysical;
+          blockedReplicaNo  = -1;
+#ifdef G4VERBOSE
+          if( fCheck )
+          {
+            fLogger->AlongComputeStepLog(sampleSolid, samplePoint,
+              sampleDirection, localDirection, sampleSafety, sampleStep);
+          }
+#endif          
+        }
+
+#ifdef G4VERBOSE
+        if( fCheck && (sampleStep < kInfinity) && (sampleStep >= motherStep) )
+        {
+           // The intersection point with the daughter is at or after the exit
+           // point from the mother volume.  Double check!
+           fLogger->CheckDaughterEntryPoint(sampleSolid,
+                                            samplePoint, sampleDirection,
+                                            motherSolid,
+                                            localPoint,  localDirection,
+                                            motherStep,  sampleStep);
+        }
+#endif
+      } // end of if ( sampleSafety <= ourStep ) 
+#ifdef G4VERBOSE
+      else if( fCheck )
+      {
+         fLogger->PrintDaughterLog(sampleSolid,  samplePoint,
+                                   sampleSafety, false,
+                                   G4ThreeVector(0.,0.,0.), -1.0 );
+      }
+#endif          
+    }
+  }
+  if ( currentProposedStepLength<ourSafety )
+  {
+    // Guaranteed physics limited
+    //
+    entering = false;
+    exiting  = false;
+    *pBlockedPhysical = 0;
+    ourStep = kInfinity;
+  }
+  else
+  {
+    // Consider intersection with mother solid
+    //
+    if ( motherSafety<=ourStep )
+    {
+      if ( !fCheck )  // The call is moved above when running in check_mode
+      {
+        motherStep = motherSolid->DistanceToOut(localPoint,
+                                                localDirection,
+                                                true,
+                                               &motherValidExitNormal,
+                                               &motherExitNormal);
+      }
+#ifdef G4VERBOSE
+      else  // check_mode
+      {
+        fLogger->PostComputeStepLog(motherSolid, localPoint, localDirection,
+                                    motherStep, motherSafety);
+        if( motherValidExitNormal )
+        {
+          fLogger->CheckAndReportBadNormal(motherExitNormal,
+                                           localPoint,
+                                           localDirection,
+                                           motherStep,
+                                           motherSolid,
+                                           "From motherSolid::DistanceToOut" );
+        }
+      }
+#endif
+
+      if( (motherStep >= kInfinity) || (motherStep < 0.0) )
+      {
+#ifdef G4VERBOSE
+        if( fCheck )  // Clearly outside the mother solid!
+        {
+          fLogger->ReportOutsideMother(localPoint, localDirection,
+                                       motherPhysical);
+        }
+#endif
+        ourStep = motherStep = 0.0;
+        exiting = true;
+        entering = false;
+        validExitNormal = false;
+        *pBlockedPhysical= 0; // or motherPhysical ?
+        blockedReplicaNo= 0;  // or motherReplicaNumber ?
+        newSafety= 0.0;
+        return ourStep;
+      }
+
+      if ( motherStep<=ourStep )
+      {
+        ourStep  = motherStep;
+        exiting  = true;
+        entering = false;
+        validExitNormal= motherValidExitNormal;
+        exitNormal= motherExitNormal;
+        
+        if ( motherValidExitNormal )
+        {
+          const G4RotationMatrix *rot = motherPhysical->GetRotation();
+          if (rot)
+          {
+            exitNormal *= rot->inverse();
+#ifdef G4VERBOSE
+            if( fCheck )
+               fLogger->CheckAndReportBadNormal(exitNormal,        // rotated
+                                                motherExitNormal,  // original 
+                                                *rot,
+                                                "From RotationMatrix" );
+#endif            
+          }
+        }
+      }
+      else
+      {
+        validExitNormal = false;
+      }
+    }
+  }
+  newSafety = ourSafety;
+  return ourStep;
+}
+
+// ********************************************************************
+// ComputeSafety
+// ********************************************************************
+//
+G4double G4BVHNavigation::ComputeSafety(const G4ThreeVector &localPoint,
+                                        const G4NavigationHistory &history,
+                                        const G4double)
+{
+  G4VPhysicalVolume *motherPhysical, *samplePhysical;
+  G4LogicalVolume *motherLogical;
+  G4VSolid *motherSolid;
+  G4double motherSafety, ourSafety;
+
+  motherPhysical = history.GetTopVolume();
+  motherLogical  = motherPhysical->GetLogicalVolume();
+  motherSolid    = motherLogical->GetSolid();
+  const G4SmartBVH* bvh = motherLogical->GetBVH();
+
+  // Compute mother safety
+  //
+  motherSafety = motherSolid->DistanceToOut(localPoint);
+  ourSafety = motherSafety; // Working isotropic safety
+
+#ifdef G4VERBOSE
+  if( fCheck )
+  {
+    fLogger->ComputeSafetyLog(motherSolid,localPoint,motherSafety,true,true);
+  }
+#endif
+
+  // Compute safeties of the daughters whose box is smaller than
+  // the current safety, nearest node first
+  //
+  const G4double point[3] = { localPoint.x(), localPoint.y(), localPoint.z() };
+  G4int nodeStack[kMaxBVHDepth+1];
+  G4int stackSize = 0;
+  if ( bvh->GetNoNodes() )  { nodeStack[stackSize++] = 0; }
+
+  while ( stackSize )
+  {
+    const G4int nodeNo = nodeStack[--stackSize];
+    const G4SmartBVH::G4BVHNode& node = bvh->GetNode(nodeNo);
+    if ( !fCheck && (BoxSafety(node.fBox, point)>=ourSafety) )  { continue; }
+    if ( node.fCount==0 )
+    {
+      const G4int firstChild = nodeNo+1, secondChild = node.fFirst;
+      if ( BoxSafety(bvh->GetNode(firstChild).fBox, point)
+         > BoxSafety(bvh->GetNode(secondChild).fBox, point) )
+      {
+        nodeStack[stackSize++] = firstChild;
+        nodeStack[stackSize++] = secondChild;
+      }
+      else
+      {
+        nodeStack[stackSize++] = secondChild;
+        nodeStack[stackSize++] = firstChild;
+      }
+      continue;
+    }
+
+    for ( G4int entry=node.fFirst; entry<node.fFirst+node.fCount; ++entry )
+    {
+      if ( !fCheck && (BoxSafety(bvh->GetBox(entry), point)>=ourSafety) )
+      {
+        continue;
+      }
+      samplePhysical = motherLogical->GetDaughter(bvh->GetDaughter(entry));
+      G4AffineTransform sampleTf(samplePhysical->GetRotation(),
+                                 samplePhysical->GetTranslation());
+      sampleTf.Invert();
+      const G4ThreeVector samplePoint =
+              sampleTf.TransformPoint(localPoint);
+      const G4VSolid *sampleSolid =
+              samplePhysical->GetLogicalVolume()->GetSolid();
+      const G4double sampleSafety =
+              sampleSolid->DistanceToIn(samplePoint);
+      if ( sampleSafety<ourSafety )
+      {
+        ourSafety = sampleSafety;
+      }
+#ifdef G4VERBOSE
+      if(fCheck)
+      {
+        fLogger->ComputeSafetyLog(sampleSolid,samplePoint,
+                                  sampleSafety,false,false);
+          // Not mother, no banner
+      }
+#endif
+    }
+  }
+  return ourSafety;
+}
+
+// ********************************************************************
+// GetVerboseLevel
+// ********************************************************************
+//
+G4int G4BVHNavigation::GetVerboseLevel() const
+{
+  return fLogger->GetVerboseLevel();
+}
+
+// ********************************************************************
+// SetVerboseLevel
+// ********************************************************************
+//
+void G4BVHNavigation::SetVerboseLevel(G4int level)
+{
+  fLogger->SetVerboseLevel(level);
+}
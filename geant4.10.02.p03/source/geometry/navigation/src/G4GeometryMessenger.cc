@@ -49,6 +49,7 @@
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithABool.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithADoubleAndUnit.hh"
 
 #include "G4GeomTestVolume.hh"
@@ -111,6 +112,37 @@ G4GeometryMessenger::G4GeometryMessenger(G4TransportationManager* tman)
   pchkCmd->SetDefaultValue(true);
   pchkCmd->AvailableForStates(G4State_Idle);
 
+  //
+  // Geometry optimisation commands
+  //
+  voxdir = new G4UIdirectory( "/geometry/voxels/" );
+  voxdir->SetGuidance( "Control of the building of geometry optimisations." );
+
+  vthCmd = new G4UIcmdWithAnInteger( "/geometry/voxels/threads", this );
+  vthCmd->SetGuidance( "Set the number of threads building the voxels of" );
+  vthCmd->SetGuidance( "volumes with placed daughters when closing the" );
+  vthCmd->SetGuidance( "geometry. The resulting optimisations are identical" );
+  vthCmd->SetGuidance( "to those of a sequential build." );
+  vthCmd->SetGuidance( "NOTE: threads are only used if Geant4 has been" );
+  vthCmd->SetGuidance( "      installed with multi-threading enabled!" );
+  vthCmd->SetParameterName("threads",true);
+  vthCmd->SetDefaultValue(1);
+  vthCmd->SetRange("threads >= 1");
+  vthCmd->SetToBeBroadcasted(false);
+  vthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  vcaCmd = new G4UIcmdWithAString( "/geometry/voxels/cache", this );
+  vcaCmd->SetGuidance( "Set the file in which voxels are kept between jobs." );
+  vcaCmd->SetGuidance( "When closing the geometry, the voxels of volumes with" );
+  vcaCmd->SetGuidance( "placed daughters which are unchanged since the file" );
+  vcaCmd->SetGuidance( "was written are read from it instead of being built;" );
+  vcaCmd->SetGuidance( "the file is then updated if any volume was built." );
+  vcaCmd->SetGuidance( "An empty name (default) disables the cache." );
+  vcaCmd->SetParameterName("fileName",true);
+  vcaCmd->SetDefaultValue("");
+  vcaCmd->SetToBeBroadcasted(false);
+  vcaCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
   //
   // Geometry verification test commands
   //
@@ -181,8 +213,8 @@ G4GeometryMessenger::~G4GeometryMessenger()
   delete verCmd; delete recCmd; delete rslCmd;
   delete resCmd; delete rcsCmd; delete rcdCmd; delete errCmd;
   delete tolCmd;
-  delete verbCmd; delete pchkCmd; delete chkCmd;
-  delete geodir; delete navdir; delete testdir;
+  delete verbCmd; delete pchkCmd; delete chkCmd; delete vthCmd; delete vcaCmd;
+  delete geodir; delete navdir; delete testdir; delete voxdir;
   delete tvolume;
 }
 
@@ -222,6 +254,13 @@ G4GeometryMessenger::SetNewValue( G4UIcommand* command, G4String newValues )
   else if (command == chkCmd) {
     SetCheckMode( newValues );
   }
+  else if (command == vthCmd) {
+    G4GeometryManager::GetInstance()
+      ->SetNumberOfVoxelThreads(vthCmd->GetNewIntValue( newValues ));
+  }
+  else if (command == vcaCmd) {
+    G4GeometryManager::GetInstance()->SetVoxelCacheFile( newValues );
+  }
   else if (command == tolCmd) {
     Init();
     tol = tolCmd->GetNewDoubleValue( newValues )
@@ -264,6 +303,13 @@ G4GeometryMessenger::GetCurrentValue(G4UIcommand* command )
   if (command == tolCmd) {
     cv = tolCmd->ConvertToString( tol, "mm" );
   }
+  else if (command == vthCmd) {
+    cv = vthCmd->ConvertToString(
+           G4GeometryManager::GetInstance()->GetNumberOfVoxelThreads() );
+  }
+  else if (command == vcaCmd) {
+    cv = G4GeometryManager::GetInstance()->GetVoxelCacheFile();
+  }
   return cv;
 }
 
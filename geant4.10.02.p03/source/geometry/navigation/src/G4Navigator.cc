@@ -440,7 +440,17 @@ G4Navigator::LocateGlobalPointAndSetup( const G4ThreeVector& globalPoint,
     switch( CharacteriseDaughters(targetLogical) )
     {
       case kNormal:
-        if ( targetLogical->GetVoxelHeader() )  // use optimised navigation
+        if ( targetLogical->GetBVH() )  // use bounding volume hierarchy
+        {
+          noResult = fbvhNav.LevelLocate(fHistory,
+                                         fBlockedPhysicalVolume,
+                                         fBlockedReplicaNo,
+                                         globalPoint,
+                                         pGlobalDirection,
+                                         considerDirection,
+                                         localPoint);
+        }
+        else if ( targetLogical->GetVoxelHeader() )  // use optimised navigation
         {
           noResult = fvoxelNav.LevelLocate(fHistory,
                                            fBlockedPhysicalVolume,
@@ -816,7 +826,21 @@ G4double G4Navigator::ComputeStep( const G4ThreeVector &pGlobalpoint,
     switch( CharacteriseDaughters(motherLogical) )
     {
       case kNormal:
-        if ( motherLogical->GetVoxelHeader() )
+        if ( motherLogical->GetBVH() )
+        {
+          Step = fbvhNav.ComputeStep(fLastLocatedPointLocal,
+                                     localDirection,
+                                     pCurrentProposedStepLength,
+                                     pNewSafety,
+                                     fHistory,
+                                     fValidExitNormal,
+                                     fExitNormal,
+                                     fExiting,
+                                     fEntering,
+                                     &fBlockedPhysicalVolume,
+                                     fBlockedReplicaNo);
+        }
+        else if ( motherLogical->GetVoxelHeader() )
         {
           Step = fvoxelNav.ComputeStep(fLastLocatedPointLocal,
                                        localDirection,
@@ -1822,7 +1846,11 @@ G4double G4Navigator::ComputeSafety( const G4ThreeVector &pGlobalpoint,
       switch(CharacteriseDaughters(motherLogical))
       {
         case kNormal:
-          if ( pVoxelHeader )
+          if ( motherLogical->GetBVH() )
+          {
+            newSafety=fbvhNav.ComputeSafety(localPoint,fHistory,pMaxLength);
+          }
+          else if ( pVoxelHeader )
           {
 #ifdef G4NEW_SAFETY
             G4double safetyTwo = fpVoxelSafety->ComputeSafety(localPoint,
@@ -51,7 +51,8 @@ G4VoxelNavigation::G4VoxelNavigation()
     fVoxelSliceWidthStack(kNavigatorVoxelStackMax,0.),
     fVoxelNodeNoStack(kNavigatorVoxelStackMax,0),
     fVoxelHeaderStack(kNavigatorVoxelStackMax,(G4SmartVoxelHeader*)0),
-    fVoxelNode(0), fpVoxelSafety(0), fCheck(false), fBestSafety(false)
+    fVoxelNode(0), fpVoxelSafety(0), fCheck(false), fBestSafety(false),
+    fUseExtents(true)
 {
   fLogger= new G4NavigationLogger("G4VoxelNavigation");
   fpVoxelSafety= new G4VoxelSafety();
@@ -189,6 +190,15 @@ G4VoxelNavigation::ComputeStep( const G4ThreeVector& localPoint,
   fBList.Enlarge(localNoDaughters);
   fBList.Reset();
 
+  // Bounding boxes of the daughters, used to skip candidates which can
+  // neither limit the step nor reduce the safety
+  //
+  const G4DaughterExtent* extents = 0;
+  if ( fUseExtents && !fCheck )
+  {
+    extents = motherLogical->GetVoxelHeader()->GetDaughterExtents();
+  }
+
   initialNode = true;
   noStep = true;
 
@@ -205,6 +215,15 @@ G4VoxelNavigation::ComputeStep( const G4ThreeVector& localPoint,
         samplePhysical = motherLogical->GetDaughter(sampleNo);
         if ( samplePhysical!=blockedExitedVol )
         {
+          if ( extents )
+          {
+            const G4double extentSafety =
+                     ExtentSafety(extents[sampleNo], localPoint);
+            if ( (extentSafety>ourSafety) && (extentSafety>ourStep) )
+            {
+              continue;
+            }
+          }
           G4AffineTransform sampleTf(samplePhysical->GetRotation(),
                                      samplePhysical->GetTranslation());
           sampleTf.Invert();
@@ -756,9 +775,19 @@ G4VoxelNavigation::ComputeSafety(const G4ThreeVector& localPoint,
   curVoxelNode = fVoxelNode;
   curNoVolumes = curVoxelNode->GetNoContained();
 
+  const G4DaughterExtent* extents = 0;
+  if ( fUseExtents && !fCheck )
+  {
+    extents = motherLogical->GetVoxelHeader()->GetDaughterExtents();
+  }
+
   for ( contentNo=curNoVolumes-1; contentNo>=0; contentNo-- )
   {
     sampleNo = curVoxelNode->GetVolume(contentNo);
+    if ( extents && ExtentSafety(extents[sampleNo], localPoint)>ourSafety )
+    {
+      continue;
+    }
     samplePhysical = motherLogical->GetDaughter(sampleNo);
 
     G4AffineTransform sampleTf(samplePhysical->GetRotation(),
@@ -298,8 +298,9 @@ inline void G4PrimaryParticle::SetG4code(const G4ParticleDefinition* Gcode)
 
 inline void G4PrimaryParticle::SetNext(G4PrimaryParticle * np)
 { 
-  if   (nextParticle == 0) { nextParticle = np; }
-  else                     { nextParticle->SetNext(np); }
+  G4PrimaryParticle* last = this;
+  while(last->nextParticle) { last = last->nextParticle; }
+  last->nextParticle = np;
 }
 
 inline void G4PrimaryParticle::ClearNext()
@@ -189,9 +189,16 @@ G4int G4PrimaryParticle::operator!=(const G4PrimaryParticle &right) const
 
 G4PrimaryParticle::~G4PrimaryParticle()
 {
-  if(nextParticle != 0){ 
-    delete nextParticle;
-    nextParticle = 0;
+  // Siblings are deleted in a loop rather than recursively, so that
+  // long lists do not exhaust the stack
+  G4PrimaryParticle* theNext = nextParticle;
+  nextParticle = 0;
+  while(theNext) // Loop checking
+  {
+    G4PrimaryParticle* thisPrimary = theNext;
+    theNext = thisPrimary->nextParticle;
+    thisPrimary->nextParticle = 0;
+    delete thisPrimary;
   }
   if(daughterParticle != 0){
     delete daughterParticle; 
@@ -78,8 +78,16 @@ G4PrimaryVertex::~G4PrimaryVertex()
     theParticle = 0;
   }
   if(nextVertex != 0) { 
-    delete nextVertex; 
+    G4PrimaryVertex* theNextVertex = nextVertex;
+    while(theNextVertex)
+    {
+      G4PrimaryVertex* thisVertex = theNextVertex;
+      theNextVertex = thisVertex->GetNext();
+      thisVertex->ClearNext();
+      delete thisVertex;
+    }
     nextVertex =0;
+    tailVertex =0;
   }
   if(userInfo != 0) { 
     delete userInfo; 
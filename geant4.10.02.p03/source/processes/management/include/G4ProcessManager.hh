@@ -292,6 +292,12 @@ class G4ProcessManager
       // in order to inform Start/End of tracking for each track
       // to the process manager and all physics processes 
 
+      G4int GetProcessVectorRevision() const;
+      // get the revision number of the process vectors. It changes
+      // whenever a process is added, removed, re-ordered, activated or
+      // inactivated. Used by G4SteppingManager to validate its cached
+      // dispatch tables.
+
 
   public:
       enum {SizeOfProcVectorArray = 6};
@@ -346,6 +352,9 @@ class G4ProcessManager
       G4bool  isSetOrderingFirstInvoked[NDoit];
       G4bool  isSetOrderingLastInvoked[NDoit];
 
+      G4int   processVectorRevision;
+      void    NewProcessVectorRevision();
+
  public: // with description
    void  DumpInfo();
 
@@ -362,6 +371,7 @@ class G4ProcessManager
  private:
    static G4ThreadLocal G4ProcessManagerMessenger* fProcessManagerMessenger;
    static G4ThreadLocal G4int                      counterOfObjects;
+   static G4ThreadLocal G4int                      counterOfRevisions;
 };
 #include "G4ProcessManager.icc"
 
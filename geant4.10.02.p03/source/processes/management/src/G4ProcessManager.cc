@@ -55,6 +55,7 @@
 // ---------------------------------
 G4ThreadLocal G4ProcessManagerMessenger* G4ProcessManager::fProcessManagerMessenger = 0;
 G4ThreadLocal G4int  G4ProcessManager::counterOfObjects = 0;
+G4ThreadLocal G4int  G4ProcessManager::counterOfRevisions = 0;
 
 // ///////////////////////////////////////
 G4ProcessManager::G4ProcessManager(const G4ParticleDefinition* aParticleType):
@@ -92,6 +93,8 @@ G4ProcessManager::G4ProcessManager(const G4ParticleDefinition* aParticleType):
     isSetOrderingLastInvoked[i]=false;
   }
 
+  NewProcessVectorRevision();
+
   // Increment counter of G4ProcessManager objects
   counterOfObjects+=1; 
 }
@@ -155,6 +158,8 @@ G4ProcessManager::G4ProcessManager(G4ProcessManager &right)
     isSetOrderingLastInvoked[i] = right.isSetOrderingLastInvoked[i];
   }
 
+  NewProcessVectorRevision();
+
   // Increment counter of G4ProcessManager objects
   counterOfObjects+=1; 
 }
@@ -182,6 +187,7 @@ G4ProcessManager::G4ProcessManager():
     isSetOrderingFirstInvoked[i]=false;
     isSetOrderingLastInvoked[i]=false;
   }
+  NewProcessVectorRevision();
 }
 
 // ///////////////////////////////////////
@@ -337,6 +343,7 @@ G4int G4ProcessManager::InsertAt(G4int ip, G4VProcess* process, G4int ivec)
   
   // insert in pVector
   pVector->insertAt(ip, process);
+  NewProcessVectorRevision();
 
   //correct index in ProcessAttributes of processes
   for (G4int iproc=0; iproc<numberOfProcesses; iproc++) {
@@ -365,6 +372,7 @@ G4int G4ProcessManager::RemoveAt(G4int ip, G4VProcess* , G4int ivec)
 
   // remove process
   pVector->removeAt(ip);
+  NewProcessVectorRevision();
 
   // correct index
   for(G4int iproc=0; iproc<numberOfProcesses; iproc++) {
@@ -925,6 +933,7 @@ G4VProcess* G4ProcessManager::InActivateProcess(G4int index)
       }
     } 
     pAttr->isActive = false;
+    NewProcessVectorRevision();
   }
   return pProcess;
 } 
@@ -987,6 +996,7 @@ G4VProcess* G4ProcessManager::ActivateProcess(G4int index)
       }
     } 
     pAttr->isActive = true;
+    NewProcessVectorRevision();
   }
   return pProcess;
 } 
@@ -1076,6 +1086,7 @@ void G4ProcessManager::CreateGPILvectors()
       GetAttribute(aProc)->idxProcVector[i] = procGPIL->entries()-1;
     }
   }
+  NewProcessVectorRevision();
 
 }
 
@@ -0,0 +1,148 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------------------
+//
+// ClassName:   G4RangeRejection
+//
+// Description: The process to kill charged particles which cannot reach
+//              a sensitive volume
+//
+//----------------------------------------------------------------------------
+//
+// Class description:
+//
+// G4RangeRejection stops charged particles whose remaining range is
+// smaller than the isotropic distance to the nearest volume which may
+// be sensitive, and deposits their kinetic energy locally. It is applied
+// only in the regions selected by the user, below a kinetic energy limit
+// given per region:
+//   /physics_engine/rangeRejection/region <region> <Emax> <unit>
+//   /physics_engine/rangeRejection/clear
+//
+// A track is rejected if the logical volume it is in has no sensitive
+// detector and if its range (G4LossTableManager::GetRange(), which is
+// not smaller than the CSDA range) is smaller than
+//   - the distance to the surface of the current solid, if no daughter
+//     volume contains (at any depth) a sensitive detector,
+//   - the isotropic safety given by G4SafetyHelper otherwise.
+//
+// A rejected particle which has AtRest processes (e.g. e+, mu-, pi-, ions)
+// is stopped but kept alive, so that it still annihilates, decays or is
+// captured at rest; other particles are killed.
+// Secondaries which the track would have produced in flight (e.g.
+// bremsstrahlung photons, delta rays) are lost, hence the energy limits
+// should be chosen such that their contribution to the sensitive volumes
+// is negligible.
+//
+// The settings are common to all instances, and one instance may be
+// registered to several particles, e.g. e- and e+.
+//
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifndef G4RangeRejection_h
+#define G4RangeRejection_h 1
+
+#include "globals.hh"
+#include "G4VDiscreteProcess.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include <map>
+
+class G4RangeRejectionMessenger;
+class G4LossTableManager;
+class G4SafetyHelper;
+class G4LogicalVolume;
+class G4Region;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class G4RangeRejection : public G4VDiscreteProcess
+{
+public:
+
+  G4RangeRejection(const G4String& processName = "rangeRejection",
+                   G4ProcessType   aType =  fGeneral );
+
+  virtual ~G4RangeRejection();
+
+  G4bool IsApplicable(const G4ParticleDefinition&);
+
+  void BuildPhysicsTable(const G4ParticleDefinition&);
+
+  static void SetRegion(const G4String& regionName, G4double maxKinEnergy);
+  // Rejection in the given region below maxKinEnergy
+
+  static void ClearRegions();
+
+  static void ListRegions();
+
+  G4double PostStepGetPhysicalInteractionLength( const G4Track& track,
+                                                 G4double previousStepSize,
+                                                 G4ForceCondition* condition);
+
+  G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+  G4double GetMeanFreePath(const G4Track&, G4double,G4ForceCondition*);
+
+private:
+
+  G4bool HasSensitiveDaughters(const G4LogicalVolume*);
+
+  void ResolveRegions();
+
+  // hide assignment operator as private
+  G4RangeRejection(const G4RangeRejection&);
+  G4RangeRejection& operator = (const G4RangeRejection &right);
+
+  G4LossTableManager* lossTableManager;
+  G4SafetyHelper* safetyHelper;
+
+  std::map<const G4Region*,G4double> regionLimits;
+  G4int resolvedRevision;
+  std::map<const G4LogicalVolume*,G4bool> sensitiveDaughters;
+
+  static std::map<G4String,G4double> regionSettings;
+  static G4int settingsRevision;
+  static G4ThreadLocal G4RangeRejectionMessenger* pMess;
+  static G4ThreadLocal G4int nInstances;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double G4RangeRejection::GetMeanFreePath(const G4Track&,G4double,
+                                                  G4ForceCondition*)
+{
+  return DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
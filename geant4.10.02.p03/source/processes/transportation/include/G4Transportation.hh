@@ -127,6 +127,12 @@ class G4Transportation : public G4VProcess
      static G4bool EnableUseMagneticMoment(G4bool useMoment=true); 
      // Whether to deflect particles with force due to magnetic moment
 
+     static G4bool EnableNeutralFastPath(G4bool useFastPath=true); 
+     // Whether neutral particles in volumes without field use the fast
+     // path (default): the Navigator is not called when the step proposed
+     // by the physics processes is shorter than the safety, and massless
+     // particles skip the field manager lookup. Returns the previous value.
+
   public:  // without description
 
      G4double AtRestGetPhysicalInteractionLength(
@@ -218,6 +224,7 @@ class G4Transportation : public G4VProcess
   private:
      friend class G4CoupledTransportation;
      static G4bool fUseMagneticMoment; 
+     static G4bool fUseNeutralFastPath; 
 
 };
 
@@ -47,6 +47,7 @@ enum G4TransportationProcessType
   // follwoing processes belong to 'General' type
   STEP_LIMITER = 401,
   USER_SPECIAL_CUTS = 402,
-  NEUTRON_KILLER = 403
+  NEUTRON_KILLER = 403,
+  RANGE_REJECTION = 404
 };
 #endif
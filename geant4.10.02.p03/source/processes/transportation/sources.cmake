@@ -45,6 +45,8 @@ GEANT4_DEFINE_MODULE(NAME G4transportation
         G4CoupledTransportation.icc
         G4NeutronKiller.hh
         G4NeutronKillerMessenger.hh
+        G4RangeRejection.hh
+        G4RangeRejectionMessenger.hh
         G4StepLimiter.hh
         G4TrackTerminator.hh
         G4Transportation.hh
@@ -56,6 +58,8 @@ GEANT4_DEFINE_MODULE(NAME G4transportation
         G4CoupledTransportation.cc
         G4NeutronKiller.cc
         G4NeutronKillerMessenger.cc
+        G4RangeRejection.cc
+        G4RangeRejectionMessenger.cc
         G4StepLimiter.cc
         G4Transportation.cc
         G4UserSpecialCuts.cc
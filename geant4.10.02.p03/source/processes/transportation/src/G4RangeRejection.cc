@@ -0,0 +1,248 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------------------
+//
+// ClassName:   G4RangeRejection
+//
+// Description: The process to kill charged particles which cannot reach
+//              a sensitive volume
+//
+//----------------------------------------------------------------------------
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "G4RangeRejection.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4RangeRejectionMessenger.hh"
+#include "G4TransportationProcessType.hh"
+#include "G4TransportationManager.hh"
+#include "G4SafetyHelper.hh"
+#include "G4LossTableManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4NavigationHistory.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+
+std::map<G4String,G4double> G4RangeRejection::regionSettings;
+G4int G4RangeRejection::settingsRevision = 0;
+G4ThreadLocal G4RangeRejectionMessenger* G4RangeRejection::pMess = 0;
+G4ThreadLocal G4int G4RangeRejection::nInstances = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RangeRejection::G4RangeRejection(const G4String& processName,
+                                   G4ProcessType aType)
+ : G4VDiscreteProcess(processName, aType), safetyHelper(0),
+   resolvedRevision(-1)
+{
+  // set Process Sub Type
+  SetProcessSubType(static_cast<int>(RANGE_REJECTION));
+
+  lossTableManager = G4LossTableManager::Instance();
+  if(nInstances++ == 0) pMess = new G4RangeRejectionMessenger();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RangeRejection::~G4RangeRejection()
+{
+  if(--nInstances == 0)
+  {
+    delete pMess;
+    pMess = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4RangeRejection::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return (particle.GetPDGCharge() != 0.0 && particle.GetPDGMass() > 0.0
+          && !particle.IsShortLived());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4RangeRejection::SetRegion(const G4String& regionName,
+                                 G4double maxKinEnergy)
+{
+  regionSettings[regionName] = maxKinEnergy;
+  ++settingsRevision;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4RangeRejection::ClearRegions()
+{
+  regionSettings.clear();
+  ++settingsRevision;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4RangeRejection::ListRegions()
+{
+  G4cout << "### G4RangeRejection: " << regionSettings.size()
+         << " region(s)" << G4endl;
+  std::map<G4String,G4double>::const_iterator itr;
+  for(itr = regionSettings.begin(); itr != regionSettings.end(); ++itr)
+  {
+    G4cout << "    " << itr->first << "  Emax(MeV) = "
+           << itr->second/MeV << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4RangeRejection::BuildPhysicsTable(const G4ParticleDefinition&)
+{
+  // Regions and sensitive detectors may change between runs
+  safetyHelper =
+    G4TransportationManager::GetTransportationManager()->GetSafetyHelper();
+  sensitiveDaughters.clear();
+  resolvedRevision = -1;
+  if(verboseLevel > 0) ListRegions();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4RangeRejection::ResolveRegions()
+{
+  // The settings are changed by the master thread in Idle state only
+  regionLimits.clear();
+  std::map<G4String,G4double>::const_iterator itr;
+  for(itr = regionSettings.begin(); itr != regionSettings.end(); ++itr)
+  {
+    const G4Region* region =
+      G4RegionStore::GetInstance()->GetRegion(itr->first,false);
+    if(region)
+    {
+      regionLimits[region] = itr->second;
+    }
+    else
+    {
+      G4ExceptionDescription ed;
+      ed << "Region <" << itr->first << "> is not found.";
+      G4Exception("G4RangeRejection::ResolveRegions()","Transport0101",
+                  JustWarning,ed);
+    }
+  }
+  resolvedRevision = settingsRevision;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool G4RangeRejection::HasSensitiveDaughters(const G4LogicalVolume* lv)
+{
+  std::map<const G4LogicalVolume*,G4bool>::const_iterator itr =
+    sensitiveDaughters.find(lv);
+  if(itr != sensitiveDaughters.end()) return itr->second;
+
+  // Marked first to stop at recursive structures
+  sensitiveDaughters[lv] = false;
+  G4bool found = false;
+  G4int nDaughters = lv->GetNoDaughters();
+  for(G4int i=0; i<nDaughters && !found; ++i)
+  {
+    const G4LogicalVolume* daughter = lv->GetDaughter(i)->GetLogicalVolume();
+    found = (daughter->GetSensitiveDetector() != 0)
+            || HasSensitiveDaughters(daughter);
+  }
+  sensitiveDaughters[lv] = found;
+  return found;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double G4RangeRejection::PostStepGetPhysicalInteractionLength(
+                                 const G4Track& aTrack,
+                                 G4double, G4ForceCondition* condition)
+{
+  // condition is set to "Not Forced"
+  *condition = NotForced;
+
+  if(resolvedRevision != settingsRevision) ResolveRegions();
+  if(regionLimits.empty()) return DBL_MAX;
+
+  const G4LogicalVolume* lv = aTrack.GetVolume()->GetLogicalVolume();
+  std::map<const G4Region*,G4double>::const_iterator itr =
+    regionLimits.find(lv->GetRegion());
+  if(itr == regionLimits.end()) return DBL_MAX;
+
+  G4double ekin = aTrack.GetKineticEnergy();
+  if(ekin > itr->second || lv->GetSensitiveDetector()) return DBL_MAX;
+
+  G4double range = lossTableManager->GetRange(aTrack.GetDefinition(), ekin,
+                                              aTrack.GetMaterialCutsCouple());
+  const G4ThreeVector& position = aTrack.GetPosition();
+  G4double distance = 0.0;
+  const G4VTouchable* touchable = aTrack.GetTouchable();
+  const G4NavigationHistory* history = touchable->GetHistory();
+  if(history && !HasSensitiveDaughters(lv))
+  {
+    G4ThreeVector localPoint =
+      history->GetTopTransform().TransformPoint(position);
+    distance = touchable->GetSolid()->DistanceToOut(localPoint);
+  }
+  else
+  {
+    distance = safetyHelper->ComputeSafety(position, range);
+  }
+  return (range < distance) ? 0.0 : DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* G4RangeRejection::PostStepDoIt(const G4Track& aTrack,
+                                                  const G4Step&)
+{
+  aParticleChange.Initialize(aTrack);
+  aParticleChange.ProposeEnergy(0.);
+  aParticleChange.ProposeLocalEnergyDeposit(aTrack.GetKineticEnergy());
+
+  // Annihilation, decay and capture at rest are still simulated
+  G4ProcessManager* pm = aTrack.GetDefinition()->GetProcessManager();
+  G4ProcessVector* atRest = pm ? pm->GetAtRestProcessVector() : 0;
+  if(atRest && atRest->entries() > 0)
+  {
+    aParticleChange.ProposeTrackStatus(fStopButAlive);
+  }
+  else
+  {
+    aParticleChange.ProposeTrackStatus(fStopAndKill);
+  }
+  return &aParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
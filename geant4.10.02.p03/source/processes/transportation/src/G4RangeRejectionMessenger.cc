@@ -0,0 +1,111 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------------------
+//
+// ClassName:   G4RangeRejectionMessenger
+//
+// Description: Messenger class of G4RangeRejection
+//
+//----------------------------------------------------------------------------
+//
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#include "G4RangeRejectionMessenger.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIdirectory.hh"
+#include "G4Tokenizer.hh"
+#include "G4RangeRejection.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RangeRejectionMessenger::G4RangeRejectionMessenger()
+{
+  dir = new G4UIdirectory("/physics_engine/rangeRejection/");
+  dir->SetGuidance("control on the range rejection of charged particles");
+
+  regionCmd = new G4UIcommand("/physics_engine/rangeRejection/region",this);
+  regionCmd->SetGuidance("Enable range rejection in a region below a kinetic energy.");
+  regionCmd->SetGuidance("Charged particles which cannot reach a sensitive volume");
+  regionCmd->SetGuidance("within their range are stopped and deposit their energy.");
+  G4UIparameter* param = new G4UIparameter("region",'s',false);
+  regionCmd->SetParameter(param);
+  param = new G4UIparameter("energyLimit",'d',false);
+  param->SetParameterRange("energyLimit>0.");
+  regionCmd->SetParameter(param);
+  param = new G4UIparameter("unit",'s',true);
+  param->SetDefaultValue("MeV");
+  param->SetParameterCandidates(G4UIcommand::UnitsList("Energy"));
+  regionCmd->SetParameter(param);
+  regionCmd->SetToBeBroadcasted(false);
+  regionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  clearCmd = new G4UIcmdWithoutParameter("/physics_engine/rangeRejection/clear",this);
+  clearCmd->SetGuidance("Disable range rejection in all regions.");
+  clearCmd->SetToBeBroadcasted(false);
+  clearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  listCmd = new G4UIcmdWithoutParameter("/physics_engine/rangeRejection/list",this);
+  listCmd->SetGuidance("List the regions with range rejection.");
+  listCmd->SetToBeBroadcasted(false);
+  listCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4RangeRejectionMessenger::~G4RangeRejectionMessenger()
+{
+  delete regionCmd;
+  delete clearCmd;
+  delete listCmd;
+  delete dir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void G4RangeRejectionMessenger::SetNewValue(G4UIcommand* command, G4String val)
+{
+  if (command == regionCmd) {
+    G4Tokenizer next(val);
+    G4String regionName = next();
+    G4String energy = next();
+    G4String unit = next();
+    G4RangeRejection::SetRegion(regionName,
+      G4UIcommand::ConvertToDouble(energy)*G4UIcommand::ValueOf(unit));
+  }
+
+  if (command == clearCmd)
+    G4RangeRejection::ClearRegions();
+
+  if (command == listCmd)
+    G4RangeRejection::ListRegions();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
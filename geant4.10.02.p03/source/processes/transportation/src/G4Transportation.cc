@@ -73,6 +73,7 @@
 class G4VSensitiveDetector;
 
 G4bool G4Transportation::fUseMagneticMoment=false;
+G4bool G4Transportation::fUseNeutralFastPath=true;
 
 // #define  G4DEBUG_TRANSPORT 1
 
@@ -233,7 +234,16 @@ AlongStepGetPhysicalInteractionLength( const G4Track&  track,
   G4bool gravityOn = false;
   G4bool fieldExists= false;  // Field is not 0 (null pointer)
 
-  fieldMgr = fFieldPropagator->FindAndSetFieldManager( track.GetVolume() );
+  // Neutral particles are transported on straight lines unless gravity
+  // acts on them. Massless ones do not need the field manager at all.
+  //
+  G4bool neutralFastPath = fUseNeutralFastPath && (particleCharge == 0.0)
+                && !( fUseMagneticMoment && (magneticMoment != 0.0) );
+
+  if( !( neutralFastPath && (restMass == 0.0) ) )
+  {
+    fieldMgr = fFieldPropagator->FindAndSetFieldManager( track.GetVolume() );
+  }
   if( fieldMgr != 0 )
   {
      // Message the field Manager, to configure it for this track
@@ -265,9 +275,13 @@ AlongStepGetPhysicalInteractionLength( const G4Track&  track,
   if( !fieldExertsForce ) 
   {
      G4double linearStepLength ;
-     if( fShortStepOptimisation && (currentMinimumStep <= currentSafety) )
+     if( (fShortStepOptimisation || neutralFastPath)
+         && (currentMinimumStep <= currentSafety) )
      {
-       // The Step is guaranteed to be taken
+       // The Step is guaranteed to be taken.
+       // For neutral particles the interaction point proposed by the
+       // physics processes is within the safety sphere: no boundary can
+       // be crossed, the Navigator is only called again at the boundary.
        //
        geometryStepLength   = currentMinimumStep ;
        fGeometryLimitedStep = false ;
@@ -825,3 +839,10 @@ G4bool G4Transportation::EnableUseMagneticMoment(G4bool useMoment)
   G4CoupledTransportation::fUseMagneticMoment= useMoment;
   return lastValue;
 }
+
+G4bool G4Transportation::EnableNeutralFastPath(G4bool useFastPath)
+{
+  G4bool lastValue= fUseNeutralFastPath;
+  fUseNeutralFastPath= useFastPath;
+  return lastValue;
+}
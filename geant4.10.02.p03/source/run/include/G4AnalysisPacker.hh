@@ -0,0 +1,96 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+// class description:
+//
+// Transfer of the histograms and profiles of the analysis manager
+// (G4VAnalysisManager) between processes through binary streams, e.g.
+// from the worker processes of G4ForkRunManager to the master process,
+// or into a checkpoint and back. The class implements the message
+// passing interface tools::histo::hmpi used by G4VAnalysisManager::Merge()
+// with in-memory buffers: Write() lets the analysis manager "send" its
+// histograms as the only source rank and writes the messages to a stream,
+// Read() collects the messages of one source from a stream, and Merge()
+// lets the analysis manager "receive" them, i.e. add the histograms of
+// all sources to its own ones.
+// Ntuples are not transferred.
+
+#ifndef G4AnalysisPacker_hh
+#define G4AnalysisPacker_hh 1
+
+#include "globals.hh"
+#include "tools/histo/hmpi"
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class G4AnalysisPacker : public tools::histo::hmpi
+{
+  public: // with description
+    G4AnalysisPacker();
+    virtual ~G4AnalysisPacker();
+
+    static G4bool Write(std::ostream& out);
+      // Writes the histograms and profiles of the analysis manager of
+      // the current thread to out. An empty record is written if there
+      // is no analysis manager.
+    G4bool Read(std::istream& in);
+      // Reads a record written by Write() as a new source.
+    G4bool Merge();
+      // Adds the histograms and profiles of all sources read so far to
+      // those of the analysis manager of the current thread.
+
+  public:
+    // tools::histo::hmpi interface
+    virtual bool pack(const tools::histo::h1d& h);
+    virtual bool pack(const tools::histo::h2d& h);
+    virtual bool pack(const tools::histo::h3d& h);
+    virtual bool pack(const tools::histo::p1d& h);
+    virtual bool pack(const tools::histo::p2d& h);
+    virtual bool beg_send(unsigned int nhist);
+    virtual bool send(int dest);
+    virtual bool wait_histos(int src,
+                             std::vector< std::pair<std::string,void*> >& hists);
+    virtual int rank() const;
+    virtual bool comm_rank(int& r) const;
+    virtual bool comm_size(int& s) const;
+
+  private:
+    G4AnalysisPacker(const G4AnalysisPacker&) = delete;
+    G4AnalysisPacker& operator=(const G4AnalysisPacker&) = delete;
+    void DeleteHistos();
+
+    G4bool sending;
+    std::string buffer;
+    std::vector<std::string> sent;
+    std::vector< std::deque<std::string> > sources;
+    std::vector< std::pair<std::string,void*> > received;
+};
+
+#endif
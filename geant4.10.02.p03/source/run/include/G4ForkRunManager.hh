@@ -0,0 +1,94 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+// class description:
+//
+//  G4ForkRunManager is a G4RunManager which processes the events of a run
+// with several worker processes instead of worker threads.
+//  Geometry, physics tables and all other run-level objects are built once
+// in the master process by the usual initialization and RunInitialization().
+// At the beginning of the event loop the master process forks the given
+// number of worker processes, which inherit all these objects copy-on-write
+// from the master. Thus the memory of the tables is shared among the worker
+// processes, and user code which is not thread-safe can be used as it is.
+//  Each worker process handles a contiguous range of event IDs. As for the
+// multi-threaded mode, the master generates the seeds of every event
+// beforehand, so that the results do not depend on the number of processes.
+//  At the end of its events, a worker process sends its G4Run object, the
+// command-based scores and the histograms and profiles of the analysis
+// manager to the master through a pipe. The G4Run objects are transferred
+// with G4Run::Pack() and G4Run::UnPack(), for which the user's run class
+// has to implement G4Run::PackData() and G4Run::UnPackData(), and merged to
+// the master run with G4Run::Merge(). Histograms are added to those of the
+// master (see G4AnalysisPacker); ntuples are not transferred. The user's
+// EndOfRunAction is invoked only in the master process, with the merged
+// run. BeginOfEventAction, EndOfEventAction, the user's stacking and
+// tracking actions and the macro given to BeamOn() for the first n_select
+// events run in the worker processes.
+//  Events stored with /event/keepCurrentEvent and the events kept for
+// visualization stay in the worker processes.
+//  This run manager is available only on POSIX systems. On Windows the
+// events are processed sequentially.
+
+#ifndef G4ForkRunManager_hh
+#define G4ForkRunManager_hh 1
+
+#include "G4RunManager.hh"
+#include <iosfwd>
+#include <vector>
+
+class G4ForkRunManager : public G4RunManager
+{
+  public: // with description
+    G4ForkRunManager();
+    virtual ~G4ForkRunManager();
+
+    void SetNumberOfProcesses(G4int n);
+    inline G4int GetNumberOfProcesses() const
+    { return nProcesses; }
+    //  Number of worker processes, by default the number of cores.
+    //  With one process, the events are processed by the master process.
+
+  public:
+    static G4ForkRunManager* GetForkRunManager();
+    //  Returns null if the run manager is not a G4ForkRunManager.
+
+  protected:
+    virtual void DoEventLoop(G4int n_event,const char* macroFile=0,G4int n_select=-1);
+    virtual void ProcessEventsInWorker(G4int firstEvent,G4int lastEvent);
+    //  Event loop of a worker process over event IDs [firstEvent,lastEvent).
+    virtual void PackResults(std::ostream& out);
+    virtual G4bool MergeResults(std::istream& in);
+    //  Write the results of a worker process, and merge them in the master.
+
+  private:
+    G4int nProcesses;
+    std::vector<long> eventSeeds;
+};
+
+#endif
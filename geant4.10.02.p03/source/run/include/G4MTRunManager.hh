@@ -42,6 +42,7 @@
 
 class G4MTRunManagerKernel;
 class G4ScoringManager;
+class G4WorkStealingEventQueue;
 class G4UserWorkerInitialization;
 class G4UserWorkerThreadInitialization;
 
@@ -56,6 +57,24 @@ public:
     G4int GetNumberOfThreads() const { return nworkers; }
     void SetPinAffinity(G4int n=1);
     G4int GetPinAffinity() const { return pinAffinity; }
+    // Placement policy of worker threads on logical CPUs. When a policy other
+    // than noAffinityPolicy is set it takes precedence over SetPinAffinity().
+    //  compactAffinity  : fill the CPUs of one socket (and SMT siblings of
+    //                     one core) before moving to the next one
+    //  scatterAffinity  : distribute workers round-robin over the sockets,
+    //                     using distinct physical cores first
+    //  explicitAffinity : worker i is pinned to cpus[i % cpus.size()]
+    // Workers are pinned before any of their thread-local data (workspaces,
+    // allocator pools, random engine) is created, such that these pages are
+    // first-touched on the NUMA node of the owning thread.
+    enum AffinityPolicy { noAffinityPolicy, compactAffinity,
+                          scatterAffinity, explicitAffinity };
+    void SetAffinityPolicy(AffinityPolicy policy,
+                           const std::vector<G4int>& cpus = std::vector<G4int>());
+    AffinityPolicy GetAffinityPolicy() const { return affinityPolicy; }
+    // Returns the logical CPU assigned to the given worker, -1 if no
+    // affinity policy is in use.
+    G4int GetAffinityCPU(G4int threadId) const;
 public:
 
     //Inherited methods to re-implement for MT case
@@ -83,6 +102,11 @@ public:
     // If zero is returned no more event needs to be processed, and worker thread 
     // must delete that G4Event.
     virtual G4int SetUpNEvents(G4Event*, G4SeedsQueue* seedsQueue, G4bool reseedRequired=true);
+    // Used instead of the two methods above when work-stealing scheduling is
+    // enabled. The next event is taken from the queue of the calling worker
+    // (or stolen from another worker) and its pre-assigned seeds are returned.
+    // No global lock is involved. False is returned if no more event is left.
+    virtual G4bool SetUpAnEventFromQueue(G4Event*, G4int workerId, long& s1, long& s2, long& s3);
     
     //Method called by Initialize() method
 protected:
@@ -95,6 +119,10 @@ protected:
     virtual void StoreRNGStatus(const G4String& filenamePrefix );
     virtual void CreateAndStartWorkers();
     //Creates worker threads and signal to start
+    virtual void BuildAffinityCPUList();
+    //Orders the logical CPUs of the machine according to the affinity
+    //policy. Invoked before the worker threads are created. On Linux the
+    //socket and core topology is read from /sys/devices/system/cpu.
 public:
     std::vector<G4String> GetCommandStack();
     //This method is invoked just before spawning the threads to
@@ -107,6 +135,9 @@ private:
     G4int forcedNwokers;
     // Pin Affinity parameter
     G4int pinAffinity;
+    // Affinity policy and the corresponding ordered list of logical CPUs
+    AffinityPolicy affinityPolicy;
+    std::vector<G4int> affinityCPUs;
 
     //List of workers (i.e. thread)
     typedef std::list<G4Thread*> G4ThreadsList;
@@ -216,9 +247,26 @@ protected:
 
     void RefillSeeds();
 
+    // Work-stealing scheduling: per-worker event queues, refilled with
+    // chunks of at most nSeedsMax events together with their seeds.
+    G4bool workStealing;
+    G4WorkStealingEventQueue* eventQueue;
+    std::vector<G4long> eventSeeds;
+    G4int nEventsQueued;
+    G4bool userEventSeeds;
+    void FillEventQueue();
+    G4bool RefillEventQueue();
+
 public:
     inline void SetEventModulo(G4int i=1) { eventModuloDef = i; }
     inline G4int GetEventModulo() const { return eventModuloDef; }
+    // If work-stealing is set, each event is dispatched individually from
+    // per-worker queues instead of in bunches of eventModulo events through
+    // SetUpNEvents(). Seeds are assigned to every event when it is queued,
+    // in the same order as with seedOncePerCommunication=0, so results do
+    // not depend on which thread processes an event.
+    inline void SetWorkStealing(G4bool val=true) { workStealing = val; }
+    inline G4bool IsWorkStealing() const { return workStealing; }
 
 public:
     virtual void AbortRun(G4bool softAbort=false);
@@ -32,9 +32,11 @@
 
 #include "globals.hh"
 #include <vector>
+#include <iosfwd>
 class G4Event;
 class G4HCtable;
 class G4DCtable;
+template <typename T> class G4THitsMap;
 
 // class description:
 //
@@ -71,6 +73,30 @@ class G4Run
     virtual void Merge(const G4Run*);
     //  Method to be overwritten by the user for merging local G4Run object to 
     //  the global G4Run object.
+    void Pack(std::ostream& out) const;
+    void UnPack(std::istream& in);
+    //  Methods writing the content of this run to a binary stream and reading
+    //  it back into another G4Run object, which is then merged by Merge().
+    //  They are used by G4ForkRunManager to collect the runs of the worker
+    //  processes and by the checkpoints of G4RunManager. The number of events
+    //  is transferred by these methods, the data of the user's run class by
+    //  PackData() and UnPackData().
+
+  protected: // with description
+    virtual void PackData(std::ostream& out) const;
+    virtual void UnPackData(std::istream& in);
+    //  Methods to be overwritten by the user's run class for the transfer of
+    //  its data. They may be empty if the class has nothing to be merged.
+    //  For a class derived from G4Run which does not overwrite them, a fatal
+    //  exception is raised, since the data of this class would be lost.
+
+  public: // with description
+    static void PackHitsMap(std::ostream& out, const G4THitsMap<G4double>* map);
+    static G4bool UnPackHitsMap(std::istream& in, const G4THitsMap<G4double>* map);
+    //  Binary transfer of a map of scores, e.g. the scores of the primitive
+    //  scorers of a G4MultiFunctionalDetector accumulated by the user's run,
+    //  to be used in PackData() and UnPackData(). The scores read are added
+    //  to the given map.
 
   public: // with description
     inline G4int GetRunID() const
@@ -123,6 +123,11 @@ class G4VPhysicalVolume;
 class G4LogicalVolume;
 class G4Region;
 class G4Timer;
+namespace CLHEP
+{
+  class HepRandomEngine;
+  class PhiloxEngine;
+}
 class G4RunMessenger;
 class G4DCtable;
 class G4Run;
@@ -134,6 +139,8 @@ class G4PrimaryTransformer;
 #include "globals.hh"
 #include <list>
 #include <algorithm>
+#include <iosfwd>
+#include <vector>
 
 class G4RunManager
 {
@@ -583,6 +590,97 @@ public: // with description
     //that are event specific. Not implemented for sequential since run seed
     //defines event seeds
     virtual void RestoreRndmEachEvent(G4bool) { /*No effect in SEQ */ }
+
+  public: // with description
+    void SetEventRandomStreams(G4bool flag, G4long seed=0);
+    //  If flag is true, every event uses its own stream of a counter-based
+    // random engine (CLHEP::PhiloxEngine), which is derived only from the
+    // given seed, the run ID and the event ID. No seed is generated by the
+    // master, and the random numbers of an event do not depend on the
+    // number of threads nor on the thread processing the event. The engine
+    // of the thread is replaced by the counter-based engine during the
+    // event loop. If seed is 0, a seed is drawn from the current engine at
+    // the next run.
+    inline G4bool UseEventRandomStreams() const
+    { return eventRandomStreams; }
+    inline G4long GetEventRandomStreamSeed() const
+    { return eventStreamSeed; }
+    void ReplayEventRandomStream(G4int runID, G4int eventID);
+    //  The next run uses the random stream of the given run ID and event ID
+    // for its first event, the stream of the following event ID for its
+    // second event, etc., so that these events can be reproduced in
+    // isolation.
+
+  protected:
+    void PrepareEventRandomStreams();
+    //  Invoked by the thread which creates the run (sequential or master)
+    void CopyEventRandomStreams(const G4RunManager* masterRunManager);
+    //  Invoked by worker threads at the beginning of a run
+    void StartEventRandomStreams();
+    void SetUpEventRandomStream(G4int eventID);
+    void EndEventRandomStreams();
+    //  Invoked by the threads processing events
+
+    G4bool eventRandomStreams;
+    G4long eventStreamSeed;
+    G4int streamRunID;
+    G4int streamEventOffset;
+    G4int replayRunID;
+    G4int replayEventID;
+    CLHEP::PhiloxEngine* streamEngine;
+    CLHEP::HepRandomEngine* engineBeforeStreams;
+
+  public: // with description
+    void SetCheckpoint(const G4String& fileName, G4int interval=100);
+    //  Every "interval" events, the state of the current run is written to
+    // the given file: the IDs of the completed events, the G4Run object
+    // (with G4Run::Pack(), for which the user's run class has to implement
+    // G4Run::PackData() and G4Run::UnPackData(), see G4Run::PackHitsMap()
+    // for the scores of G4MultiFunctionalDetector), the command-based
+    // scores, the histograms and profiles of the analysis manager (but not
+    // its ntuples) and the status of the random number engine. A run class
+    // which cannot be transferred stops the run with a fatal exception at
+    // the first checkpoint, written at the beginning of the run by the
+    // master or sequential run manager. In multi-threaded mode each worker thread
+    // writes its own file, named <fileName>.t<threadID>, and the master
+    // writes <fileName> at the beginning of the run. Files are replaced
+    // atomically. An interval of 0 disables checkpointing.
+    void ResumeFromCheckpoint(const G4String& fileName);
+    //  The next run starts from the checkpoint written to the given file by
+    // a previous job with the same number of events. The saved results are
+    // merged to the new run and the completed events are not simulated
+    // again. The remaining events are reproduced exactly in sequential
+    // mode, and in multi-threaded mode if the seeds are set for each event
+    // (default of /run/eventModulo) or event random streams are used with
+    // an explicit seed.
+    inline const G4String& GetCheckpointFile() const
+    { return checkpointFile; }
+    inline G4int GetCheckpointInterval() const
+    { return checkpointInterval; }
+
+  protected:
+    virtual void WriteCheckpoint();
+    virtual void ReadCheckpoint();
+    //  Write the checkpoint of this thread or process, and read the
+    // checkpoint(s) of a previous job (sequential or master).
+    void CopyCheckpointSettings(const G4RunManager* masterRunManager);
+    //  Invoked by worker threads at the beginning of a run
+    void RecordCompletedEvent(G4int eventID);
+    G4bool IsEventCompleted(G4int eventID) const;
+    //  IsEventCompleted() returns true for the events completed before
+    // the restart, which have to be skipped.
+    void PackScoringMeshes(std::ostream& out) const;
+    G4bool MergeScoringMeshes(std::istream& in);
+    //  Binary transfer of the scores of the command-based scoring meshes
+
+    typedef std::vector<std::pair<G4int,G4int> > G4EventIDRanges;
+    G4String checkpointFile;
+    G4int checkpointInterval;
+    G4String resumeFile;
+    G4int checkpointGeneration;
+    G4int eventsSinceCheckpoint;
+    G4EventIDRanges completedEvents;
+    G4EventIDRanges resumedEvents;
 };
 
 #endif
@@ -88,7 +88,12 @@ class G4RunMessenger: public G4UImessenger
     G4UIcmdWithAnInteger *      nThreadsCmd;
     G4UIcmdWithoutParameter *   maxThreadsCmd;
     G4UIcmdWithAnInteger *      pinAffinityCmd;
+    G4UIcommand *               affinityPolicyCmd;
     G4UIcommand *               evModCmd;
+    G4UIcmdWithABool *          workStealCmd;
+    G4UIcmdWithAnInteger *      nProcessesCmd;
+    G4UIcommand *               checkpointCmd;
+    G4UIcmdWithAString *        resumeCmd;
     G4UIcmdWithAString *        dumpRegCmd;
     G4UIcmdWithoutParameter *   dumpCoupleCmd;
     G4UIcmdWithABool *          optCmd;
@@ -110,6 +115,8 @@ class G4RunMessenger: public G4UImessenger
     G4UIcmdWithoutParameter *   saveThisEventCmd;
     G4UIcmdWithAString *        restoreRandCmd;
     G4UIcmdWithABool *          saveEachEventCmd;
+    G4UIcommand *               evtStreamCmd;
+    G4UIcommand *               replayStreamCmd;
     G4UIcmdWithABool *	 	    restoreRandCmdMT;
     
     G4UIcmdWithoutParameter *   constScoreCmd;
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+// class description:
+//
+// Per-thread event queues with work stealing, used by G4MTRunManager
+// when the work-stealing event scheduling is enabled (/run/workStealing).
+// The event IDs of the run, together with their pre-assigned seeds, are
+// distributed in chunks of at most G4MTRunManager::nSeedsMax events, each
+// chunk in contiguous blocks over one queue per worker.
+// Each worker takes events from the front of its own queue; a worker
+// whose queue is empty steals half of the remaining events from the back
+// of the queue of another worker. Every queue is protected by its own
+// mutex, so there is no global lock on the event dispatching path and a
+// few expensive events cannot leave the other threads idle at the end
+// of the run.
+
+#ifndef G4WorkStealingEventQueue_hh
+#define G4WorkStealingEventQueue_hh 1
+
+#include "G4Types.hh"
+#include "G4Threading.hh"
+#include <deque>
+#include <vector>
+
+class G4WorkStealingEventQueue
+{
+  public:
+    G4WorkStealingEventQueue();
+    ~G4WorkStealingEventQueue();
+
+    void Reset(G4int nQueues);
+      // Sets the number of queues, empties them and resets the
+      // statistics. To be invoked at the beginning of the event loop.
+    void Fill(G4int firstEvent, G4int nEvents,
+              const G4long* seeds=0, G4int nSeedsPerEvent=2);
+      // Distributes event IDs [firstEvent,firstEvent+nEvents) over the
+      // queues. If given, seeds holds nSeedsPerEvent seeds per event,
+      // which are kept with the event until it is dispatched.
+    G4bool NextEvent(G4int queueId, G4int& eventID, long seeds[3]);
+      // Returns the next event to be processed by the owner of the
+      // queue queueId and its seeds, stealing from other queues if
+      // necessary. False is returned if no event is left in any queue.
+    void Clear();
+      // Empties all queues, e.g. when the run is aborted.
+
+    G4int GetNumberOfDispatchedEvents() const;
+    G4int GetNumberOfSteals() const;
+      // Statistics for the current event loop, to be used only
+      // once the workers have left the event loop.
+
+  private:
+    struct QueuedEvent
+    {
+      G4int eventID;
+      G4long seeds[3];
+    };
+    struct EventQueue
+    {
+      EventQueue();
+      ~EventQueue();
+      G4Mutex mutex;
+      std::deque<QueuedEvent> events;
+      G4int nDispatched;
+      G4int nSteals;
+      char pad[64];  // keep queues of different threads on separate cache lines
+    };
+
+    G4bool Steal(G4int thiefId);
+
+    G4WorkStealingEventQueue(const G4WorkStealingEventQueue&);
+    G4WorkStealingEventQueue& operator=(const G4WorkStealingEventQueue&);
+
+  private:
+    std::vector<EventQueue*> queues;
+};
+
+#endif
@@ -54,6 +54,8 @@ public:
 
     //Setting Pin Affinity
     void SetPinAffinity(G4int aff) const;
+    //Pin this thread to the given logical CPU
+    void PinToCPU(G4int cpu) const;
 
 private:
     G4int threadId;
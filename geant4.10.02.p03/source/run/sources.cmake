@@ -19,6 +19,8 @@
 include_directories(${CLHEP_INCLUDE_DIRS})
 
 # List internal includes needed.
+include_directories(${CMAKE_SOURCE_DIR}/source/analysis/g4tools/include)
+include_directories(${CMAKE_SOURCE_DIR}/source/analysis/management/include)
 include_directories(${CMAKE_SOURCE_DIR}/source/digits_hits/detector/include)
 include_directories(${CMAKE_SOURCE_DIR}/source/digits_hits/digits/include)
 include_directories(${CMAKE_SOURCE_DIR}/source/digits_hits/hits/include)
@@ -71,7 +73,9 @@ GEANT4_DEFINE_MODULE(NAME G4run
         G4AdjointPrimaryGeneratorAction.hh
         G4AdjointSimManager.hh
         G4AdjointSimMessenger.hh
+        G4AnalysisPacker.hh
         G4ExceptionHandler.hh
+        G4ForkRunManager.hh
         G4MSSteppingAction.hh
         G4MatScanMessenger.hh
         G4MaterialScanner.hh
@@ -100,13 +104,16 @@ GEANT4_DEFINE_MODULE(NAME G4run
         G4VUserPrimaryGeneratorAction.hh
 	G4WorkerThread.hh
         G4VUPLSplitter.hh
+        G4WorkStealingEventQueue.hh
         rundefs.hh
         G4RNGHelper.hh 
    SOURCES
         G4AdjointPrimaryGeneratorAction.cc
         G4AdjointSimManager.cc
         G4AdjointSimMessenger.cc
+        G4AnalysisPacker.cc
         G4ExceptionHandler.cc
+        G4ForkRunManager.cc
         G4MSSteppingAction.cc
         G4MatScanMessenger.cc
         G4MaterialScanner.cc
@@ -134,8 +141,10 @@ GEANT4_DEFINE_MODULE(NAME G4run
         G4VUserPhysicsList.cc
         G4VUserPrimaryGeneratorAction.cc
 	G4WorkerThread.cc
+        G4WorkStealingEventQueue.cc
         G4RNGHelper.cc
     GRANULAR_DEPENDENCIES
+        G4analysismng
         G4cuts
         G4decay
         G4detector
@@ -161,6 +170,7 @@ GEANT4_DEFINE_MODULE(NAME G4run
         G4volumes
 	G4specsolids
     GLOBAL_DEPENDENCIES
+        G4analysis
         G4digits_hits
         G4event
         G4geometry
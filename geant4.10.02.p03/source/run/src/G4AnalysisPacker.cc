@@ -0,0 +1,352 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//
+
+#include "G4AnalysisPacker.hh"
+#include "G4VAnalysisManager.hh"
+
+#include "tools/impi"
+#include "tools/histo/hd2mpi"
+#include "tools/histo/h1d"
+#include "tools/histo/h2d"
+#include "tools/histo/h3d"
+#include "tools/histo/p1d"
+#include "tools/histo/p2d"
+
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+  // tools::impi over a byte string. The values are stored in their native
+  // representation, as G4Run::Pack() does, since the data is read back by
+  // the same executable.
+  class G4AnalysisBuffer : public tools::impi
+  {
+    public:
+      G4AnalysisBuffer(std::string& buf) : data(buf), pos(0) {}
+
+      virtual bool pack(unsigned int v) { return Put(&v,sizeof(v)); }
+      virtual bool pack(double v) { return Put(&v,sizeof(v)); }
+      virtual bool bpack(bool v)
+      { char c = v ? 1 : 0; return Put(&c,1); }
+      virtual bool spack(const std::string& s)
+      {
+        unsigned int n = s.size();
+        return pack(n) && Put(s.data(),n);
+      }
+      virtual bool vpack(const std::vector<unsigned int>& v)
+      {
+        unsigned int n = v.size();
+        return pack(n) && (n==0 || Put(&v[0],n*sizeof(unsigned int)));
+      }
+      virtual bool vpack(const std::vector<double>& v)
+      {
+        unsigned int n = v.size();
+        return pack(n) && (n==0 || Put(&v[0],n*sizeof(double)));
+      }
+
+      virtual bool unpack(unsigned int& v) { return Get(&v,sizeof(v)); }
+      virtual bool unpack(double& v) { return Get(&v,sizeof(v)); }
+      virtual bool bunpack(bool& v)
+      {
+        char c = 0;
+        if(!Get(&c,1)) return false;
+        v = (c!=0);
+        return true;
+      }
+      virtual bool sunpack(std::string& s)
+      {
+        unsigned int n = 0;
+        if(!unpack(n) || pos+n>data.size()) return false;
+        s.assign(data,pos,n);
+        pos += n;
+        return true;
+      }
+      virtual bool vunpack(std::vector<unsigned int>& v)
+      {
+        unsigned int n = 0;
+        if(!unpack(n)) return false;
+        v.resize(n);
+        return n==0 || Get(&v[0],n*sizeof(unsigned int));
+      }
+      virtual bool vunpack(std::vector<double>& v)
+      {
+        unsigned int n = 0;
+        if(!unpack(n)) return false;
+        v.resize(n);
+        return n==0 || Get(&v[0],n*sizeof(double));
+      }
+
+    private:
+      bool Put(const void* p, size_t n)
+      {
+        data.append((const char*)p,n);
+        return true;
+      }
+      bool Get(void* p, size_t n)
+      {
+        if(pos+n>data.size()) return false;
+        std::memcpy(p,data.data()+pos,n);
+        pos += n;
+        return true;
+      }
+
+      std::string& data;
+      size_t pos;
+  };
+}
+
+G4AnalysisPacker::G4AnalysisPacker()
+  : sending(false)
+{
+}
+
+G4AnalysisPacker::~G4AnalysisPacker()
+{
+  DeleteHistos();
+}
+
+G4bool G4AnalysisPacker::Write(std::ostream& out)
+{
+  G4AnalysisPacker packer;
+  packer.sending = true;
+  G4bool result = true;
+  G4VAnalysisManager* analysisManager = G4VAnalysisManager::GetInstanceIfExist();
+  if(analysisManager) result = analysisManager->Merge(&packer);
+
+  unsigned int nMessages = packer.sent.size();
+  out.write((const char*)&nMessages,sizeof(unsigned int));
+  for(unsigned int i=0;i<nMessages;i++)
+  {
+    unsigned int size = packer.sent[i].size();
+    out.write((const char*)&size,sizeof(unsigned int));
+    out.write(packer.sent[i].data(),size);
+  }
+  return result && out.good();
+}
+
+G4bool G4AnalysisPacker::Read(std::istream& in)
+{
+  unsigned int nMessages = 0;
+  in.read((char*)&nMessages,sizeof(unsigned int));
+  std::deque<std::string> messages;
+  for(unsigned int i=0;i<nMessages && in.good();i++)
+  {
+    unsigned int size = 0;
+    in.read((char*)&size,sizeof(unsigned int));
+    std::string message(size,'\0');
+    if(size>0) in.read(&message[0],size);
+    messages.push_back(message);
+  }
+  if(!in.good()) return false;
+  sources.push_back(messages);
+  return true;
+}
+
+G4bool G4AnalysisPacker::Merge()
+{
+  if(sources.empty()) return true;
+  G4bool result = false;
+  G4VAnalysisManager* analysisManager = G4VAnalysisManager::GetInstanceIfExist();
+  if(analysisManager)
+  {
+    sending = false;
+    result = analysisManager->Merge(this);
+  }
+  else
+  {
+    result = true;
+    for(size_t i=0;i<sources.size();i++)
+    { if(!sources[i].empty()) result = false; }
+  }
+  sources.clear();
+  DeleteHistos();
+  return result;
+}
+
+bool G4AnalysisPacker::pack(const tools::histo::h1d& h)
+{
+  G4AnalysisBuffer packer(buffer);
+  return packer.spack(h.s_cls())
+      && tools::histo::histo_data_duiuid_pack(packer,h.dac());
+}
+
+bool G4AnalysisPacker::pack(const tools::histo::h2d& h)
+{
+  G4AnalysisBuffer packer(buffer);
+  return packer.spack(h.s_cls())
+      && tools::histo::histo_data_duiuid_pack(packer,h.dac());
+}
+
+bool G4AnalysisPacker::pack(const tools::histo::h3d& h)
+{
+  G4AnalysisBuffer packer(buffer);
+  return packer.spack(h.s_cls())
+      && tools::histo::histo_data_duiuid_pack(packer,h.dac());
+}
+
+bool G4AnalysisPacker::pack(const tools::histo::p1d& h)
+{
+  G4AnalysisBuffer packer(buffer);
+  return packer.spack(h.s_cls())
+      && tools::histo::profile_data_duiuidd_pack(packer,h.get_histo_data());
+}
+
+bool G4AnalysisPacker::pack(const tools::histo::p2d& h)
+{
+  G4AnalysisBuffer packer(buffer);
+  return packer.spack(h.s_cls())
+      && tools::histo::profile_data_duiuidd_pack(packer,h.get_histo_data());
+}
+
+bool G4AnalysisPacker::beg_send(unsigned int nhist)
+{
+  buffer.clear();
+  G4AnalysisBuffer packer(buffer);
+  return packer.pack(nhist);
+}
+
+bool G4AnalysisPacker::send(int)
+{
+  sent.push_back(buffer);
+  buffer.clear();
+  return true;
+}
+
+bool G4AnalysisPacker::wait_histos(int src,
+                       std::vector< std::pair<std::string,void*> >& hists)
+{
+  // Sources are numbered from 1, rank 0 being the receiver
+  hists.clear();
+  if(src<1 || src>G4int(sources.size()) || sources[src-1].empty())
+  { return false; }
+  std::string message;
+  message.swap(sources[src-1].front());
+  sources[src-1].pop_front();
+
+  typedef tools::histo::histo_data<double,unsigned int,unsigned int,double>
+    histo_data_t;
+  typedef tools::histo::profile_data<double,unsigned int,unsigned int,
+                                     double,double> profile_data_t;
+
+  G4AnalysisBuffer unpacker(message);
+  unsigned int nhist = 0;
+  if(!unpacker.unpack(nhist)) return false;
+  for(unsigned int ihist=0;ihist<nhist;ihist++)
+  {
+    std::string cls;
+    if(!unpacker.sunpack(cls)) return false;
+    void* h = 0;
+    if(cls==tools::histo::h1d::s_class())
+    {
+      histo_data_t data;
+      if(!tools::histo::histo_data_duiuid_unpack(unpacker,data)) return false;
+      tools::histo::h1d* h1 = new tools::histo::h1d("",10,0,1);
+      h1->copy_from_data(data);
+      h = h1;
+    }
+    else if(cls==tools::histo::h2d::s_class())
+    {
+      histo_data_t data;
+      if(!tools::histo::histo_data_duiuid_unpack(unpacker,data)) return false;
+      tools::histo::h2d* h2 = new tools::histo::h2d("",10,0,1,10,0,1);
+      h2->copy_from_data(data);
+      h = h2;
+    }
+    else if(cls==tools::histo::h3d::s_class())
+    {
+      histo_data_t data;
+      if(!tools::histo::histo_data_duiuid_unpack(unpacker,data)) return false;
+      tools::histo::h3d* h3 = new tools::histo::h3d("",10,0,1,10,0,1,10,0,1);
+      h3->copy_from_data(data);
+      h = h3;
+    }
+    else if(cls==tools::histo::p1d::s_class())
+    {
+      profile_data_t data;
+      if(!tools::histo::profile_data_duiuidd_unpack(unpacker,data))
+      { return false; }
+      tools::histo::p1d* p1 = new tools::histo::p1d("",10,0,1);
+      p1->copy_from_data(data);
+      h = p1;
+    }
+    else if(cls==tools::histo::p2d::s_class())
+    {
+      profile_data_t data;
+      if(!tools::histo::profile_data_duiuidd_unpack(unpacker,data))
+      { return false; }
+      tools::histo::p2d* p2 = new tools::histo::p2d("",10,0,1,10,0,1);
+      p2->copy_from_data(data);
+      h = p2;
+    }
+    else
+    { return false; }
+    // Ownership is kept, the histograms are deleted by DeleteHistos()
+    received.push_back(std::make_pair(cls,h));
+    hists.push_back(received.back());
+  }
+  return true;
+}
+
+int G4AnalysisPacker::rank() const
+{
+  return 0;
+}
+
+bool G4AnalysisPacker::comm_rank(int& r) const
+{
+  r = sending ? 1 : 0;
+  return true;
+}
+
+bool G4AnalysisPacker::comm_size(int& s) const
+{
+  s = sending ? 2 : 1+G4int(sources.size());
+  return true;
+}
+
+void G4AnalysisPacker::DeleteHistos()
+{
+  for(size_t i=0;i<received.size();i++)
+  {
+    const std::string& cls = received[i].first;
+    void* h = received[i].second;
+    if(cls==tools::histo::h1d::s_class())
+    { delete static_cast<tools::histo::h1d*>(h); }
+    else if(cls==tools::histo::h2d::s_class())
+    { delete static_cast<tools::histo::h2d*>(h); }
+    else if(cls==tools::histo::h3d::s_class())
+    { delete static_cast<tools::histo::h3d*>(h); }
+    else if(cls==tools::histo::p1d::s_class())
+    { delete static_cast<tools::histo::p1d*>(h); }
+    else if(cls==tools::histo::p2d::s_class())
+    { delete static_cast<tools::histo::p2d*>(h); }
+  }
+  received.clear();
+}
@@ -0,0 +1,313 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#include "G4ForkRunManager.hh"
+#include "G4AnalysisPacker.hh"
+#include "G4VAnalysisManager.hh"
+#include "G4Run.hh"
+#include "G4UserRunAction.hh"
+#include "G4ScoringManager.hh"
+#include "G4VScoringMesh.hh"
+#include "G4SDManager.hh"
+#include "G4Threading.hh"
+#include "Randomize.hh"
+#include <iostream>
+#include <sstream>
+
+#ifndef WIN32
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+namespace
+{
+  G4bool WriteAll(int fd, const std::string& buf)
+  {
+    const char* p = buf.data();
+    size_t n = buf.size();
+    while(n>0) // Loop checking 17.10.2026
+    {
+      ssize_t w = write(fd,p,n);
+      if(w<0)
+      {
+        if(errno==EINTR) continue;
+        return false;
+      }
+      p += w;
+      n -= w;
+    }
+    return true;
+  }
+
+  G4bool ReadAll(int fd, std::string& buf)
+  {
+    char chunk[65536];
+    for(;;) // Loop checking 17.10.2026
+    {
+      ssize_t r = read(fd,chunk,sizeof(chunk));
+      if(r==0) return true;
+      if(r<0)
+      {
+        if(errno==EINTR) continue;
+        return false;
+      }
+      buf.append(chunk,r);
+    }
+  }
+}
+#endif
+
+G4ForkRunManager* G4ForkRunManager::GetForkRunManager()
+{ return dynamic_cast<G4ForkRunManager*>(G4RunManager::GetRunManager()); }
+
+G4ForkRunManager::G4ForkRunManager()
+:G4RunManager(),nProcesses(G4Threading::G4GetNumberOfCores())
+{
+#ifdef WIN32
+  G4Exception("G4ForkRunManager::G4ForkRunManager","Run0301",JustWarning,
+              "Worker processes are not supported on this platform. Events are processed sequentially.");
+  nProcesses = 1;
+#endif
+}
+
+G4ForkRunManager::~G4ForkRunManager()
+{;}
+
+void G4ForkRunManager::SetNumberOfProcesses(G4int n)
+{
+#ifdef WIN32
+  n = 1;
+#endif
+  nProcesses = (n>0) ? n : 1;
+}
+
+void G4ForkRunManager::DoEventLoop(G4int n_event,const char* macroFile,G4int n_select)
+{
+  G4int nWorkers = (nProcesses<n_event) ? nProcesses : n_event;
+  if(nWorkers<=1)
+  {
+    G4RunManager::DoEventLoop(n_event,macroFile,n_select);
+    return;
+  }
+
+#ifndef WIN32
+  // The run of the user must be transferable. Raise the exception of
+  // G4Run::Pack() now rather than in every worker process.
+  {
+    std::ostringstream probe(std::ios::out|std::ios::binary);
+    currentRun->Pack(probe);
+  }
+  G4VAnalysisManager* analysisManager = G4VAnalysisManager::GetInstanceIfExist();
+  if(analysisManager && analysisManager->GetNofNtuples()>0)
+  {
+    G4Exception("G4ForkRunManager::DoEventLoop","Run0305",JustWarning,
+                "Ntuples filled in the worker processes are not transferred to the master process.");
+  }
+
+  InitializeEventLoop(n_event,macroFile,n_select);
+
+  // Seeds of all events are generated by the master as in the MT mode,
+  // so that the results do not depend on the number of processes.
+  // With event random streams, seeds are given by the event IDs.
+  if(!eventRandomStreams)
+  {
+    eventSeeds.resize(2*n_event);
+    for(auto& seed : eventSeeds)
+    { seed = (long)(100000000L*G4UniformRand()); }
+  }
+
+  // Buffered output would be written by every process otherwise
+  G4cout << std::flush;
+  std::cout.flush();
+  std::cerr.flush();
+
+  std::vector<pid_t> pids(nWorkers,0);
+  std::vector<int> fds(nWorkers,-1);
+  for(G4int i=0;i<nWorkers;i++)
+  {
+    G4int firstEvent = G4int((G4long)n_event*i/nWorkers);
+    G4int lastEvent = G4int((G4long)n_event*(i+1)/nWorkers);
+    int fd[2];
+    if(pipe(fd)!=0)
+    {
+      G4Exception("G4ForkRunManager::DoEventLoop","Run0302",FatalException,
+                  "pipe() failed.");
+    }
+    pid_t pid = fork();
+    if(pid<0)
+    {
+      G4Exception("G4ForkRunManager::DoEventLoop","Run0302",FatalException,
+                  "fork() failed.");
+    }
+    if(pid==0)
+    {
+      // Worker process
+      close(fd[0]);
+      ProcessEventsInWorker(firstEvent,lastEvent);
+      std::ostringstream out(std::ios::out|std::ios::binary);
+      PackResults(out);
+      G4bool ok = WriteAll(fd[1],out.str());
+      close(fd[1]);
+      G4cout << std::flush;
+      std::cout.flush();
+      std::cerr.flush();
+      // Static objects and files of the user belong to the master process
+      _exit(ok ? 0 : 1);
+    }
+    close(fd[1]);
+    pids[i] = pid;
+    fds[i] = fd[0];
+  }
+
+  for(G4int i=0;i<nWorkers;i++)
+  {
+    std::string buf;
+    G4bool ok = ReadAll(fds[i],buf);
+    close(fds[i]);
+    int status = 0;
+    while(waitpid(pids[i],&status,0)<0 && errno==EINTR) {;} // Loop checking 17.10.2026
+    ok = ok && WIFEXITED(status) && WEXITSTATUS(status)==0;
+    if(ok)
+    {
+      std::istringstream in(buf,std::ios::in|std::ios::binary);
+      ok = MergeResults(in);
+    }
+    if(ok && checkpointInterval>0 && !runAborted)
+    {
+      completedEvents.push_back(std::make_pair(G4int((G4long)n_event*i/nWorkers),
+                                               G4int((G4long)n_event*(i+1)/nWorkers)-1));
+      WriteCheckpoint();
+    }
+    if(!ok)
+    {
+      G4ExceptionDescription ED;
+      ED << "Worker process " << i << " (events "
+         << G4int((G4long)n_event*i/nWorkers) << " to "
+         << G4int((G4long)n_event*(i+1)/nWorkers)-1
+         << ") did not terminate properly. These events are not included in the run.";
+      G4Exception("G4ForkRunManager::DoEventLoop","Run0303",JustWarning,ED);
+    }
+  }
+  eventSeeds.clear();
+
+  TerminateEventLoop();
+#endif
+}
+
+void G4ForkRunManager::ProcessEventsInWorker(G4int firstEvent,G4int lastEvent)
+{
+  // Scores of the previous runs are already known by the master process
+  G4ScoringManager* ScM = G4ScoringManager::GetScoringManagerIfExist();
+  if(ScM)
+  {
+    for(size_t iw=0;iw<ScM->GetNumberOfMesh();iw++)
+    { ScM->GetMesh(iw)->ResetScore(); }
+  }
+  // and so are the histograms filled by the master process
+  G4VAnalysisManager* analysisManager = G4VAnalysisManager::GetInstanceIfExist();
+  if(analysisManager && !analysisManager->Reset())
+  {
+    G4Exception("G4ForkRunManager::ProcessEventsInWorker","Run0305",JustWarning,
+                "The histograms of the analysis manager cannot be reset. Their content in the master process is counted again.");
+  }
+
+  // Only the master process writes checkpoints. The results restored from
+  // a checkpoint are already in the run of the master.
+  checkpointInterval = 0;
+  if(!resumedEvents.empty())
+  {
+    G4Run* aRun = 0;
+    if(userRunAction) aRun = userRunAction->GenerateRun();
+    if(!aRun) aRun = new G4Run();
+    aRun->SetRunID(currentRun->GetRunID());
+    aRun->SetNumberOfEventToBeProcessed(numberOfEventToBeProcessed);
+    aRun->SetDCtable(DCtable);
+    G4SDManager* fSDM = G4SDManager::GetSDMpointerIfExist();
+    if(fSDM) aRun->SetHCtable(fSDM->GetHCtable());
+    delete currentRun;
+    currentRun = aRun;
+  }
+
+  numberOfEventProcessed = 0;
+  for(G4int i_event=firstEvent; i_event<lastEvent; i_event++ )
+  {
+    if(IsEventCompleted(i_event)) continue;
+    if(!eventRandomStreams)
+    {
+      long seeds[3] = { eventSeeds[2*i_event], eventSeeds[2*i_event+1], 0 };
+      G4Random::setTheSeeds(seeds,-1);
+    }
+    ProcessOneEvent(i_event);
+    TerminateOneEvent();
+    if(runAborted) break;
+  }
+}
+
+void G4ForkRunManager::PackResults(std::ostream& out)
+{
+  G4int nEvents = numberOfEventProcessed;
+  G4int aborted = runAborted ? 1 : 0;
+  out.write((const char*)&nEvents,sizeof(G4int));
+  out.write((const char*)&aborted,sizeof(G4int));
+  currentRun->Pack(out);
+  PackScoringMeshes(out);
+  G4AnalysisPacker::Write(out);
+}
+
+G4bool G4ForkRunManager::MergeResults(std::istream& in)
+{
+  G4int nEvents = 0;
+  G4int aborted = 0;
+  in.read((char*)&nEvents,sizeof(G4int));
+  in.read((char*)&aborted,sizeof(G4int));
+  if(!in) return false;
+
+  G4Run* aRun = nullptr;
+  if(userRunAction) aRun = userRunAction->GenerateRun();
+  if(!aRun) aRun = new G4Run();
+  aRun->UnPack(in);
+  if(!in)
+  {
+    delete aRun;
+    return false;
+  }
+  currentRun->Merge(aRun);
+  delete aRun;
+  numberOfEventProcessed += nEvents;
+  if(aborted) runAborted = true;
+
+  if(!MergeScoringMeshes(in)) return false;
+  G4AnalysisPacker analysisPacker;
+  if(!analysisPacker.Read(in) || !analysisPacker.Merge())
+  {
+    G4Exception("G4ForkRunManager::MergeResults","Run0305",JustWarning,
+                "The histograms of a worker process could not be merged.");
+  }
+  return true;
+}
@@ -42,6 +42,12 @@
 #include "G4UserRunAction.hh"
 #include "G4ProductionCutsTable.hh"
 #include "G4Timer.hh"
+#include "G4WorkStealingEventQueue.hh"
+#include "G4SubEventQueue.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 G4ScoringManager* G4MTRunManager::masterScM = 0;
 G4MTRunManager::masterWorlds_t G4MTRunManager::masterWorlds = G4MTRunManager::masterWorlds_t();
@@ -83,11 +89,14 @@ G4MTRunManagerKernel* G4MTRunManager::GetMTMasterRunManagerKernel()
 
 G4MTRunManager::G4MTRunManager() : G4RunManager(masterRM),
     nworkers(2),forcedNwokers(-1),pinAffinity(0),
+    affinityPolicy(noAffinityPolicy),
     masterRNGEngine(0),
     nextActionRequest(UNDEFINED),
     eventModuloDef(0),eventModulo(1),
     nSeedsUsed(0),nSeedsFilled(0),
-    nSeedsMax(10000),nSeedsPerEvent(2)
+    nSeedsMax(10000),nSeedsPerEvent(2),
+    workStealing(false),eventQueue(0),
+    nEventsQueued(0),userEventSeeds(false)
 {
     if ( fMasterRM )
     {
@@ -168,6 +177,7 @@ G4MTRunManager::~G4MTRunManager()
     //G4cout<<"Destroy MTRunManager"<<G4endl;//ANDREA
     TerminateWorkers();
     delete [] randDbl;
+    delete eventQueue;
 }
 
 void G4MTRunManager::StoreRNGStatus(const G4String& fn )
@@ -249,6 +259,7 @@ void G4MTRunManager::CreateAndStartWorkers()
     //Currently we do not allow to change the
     //number of threads: threads area created once
     if ( threads.size() == 0 ) {
+        BuildAffinityCPUList();
         for ( G4int nw = 0 ; nw<nworkers; ++nw) {
             //Create a new worker and remember it
             G4WorkerThread* context = new G4WorkerThread;
@@ -313,7 +324,15 @@ void G4MTRunManager::InitializeEventLoop(G4int n_event, const char* macroFile, G
       eventModulo = int(std::sqrt(double(numberOfEventToBeProcessed/nworkers)));
       if(eventModulo<1) eventModulo =1;
     }
-    if ( InitializeSeeds(n_event) == false && n_event>0 )
+    if ( workStealing )
+    {
+      if ( n_event>0 ) FillEventQueue();
+    }
+    else if ( eventRandomStreams )
+    {
+      // Workers derive the random stream of each event from its ID
+    }
+    else if ( InitializeSeeds(n_event) == false && n_event>0 )
     {
         G4RNGHelper* helper = G4RNGHelper::GetInstance();
         switch(seedOncePerCommunication)
@@ -351,6 +370,11 @@ void G4MTRunManager::InitializeEventLoop(G4int n_event, const char* macroFile, G
   //Prepare UI commands for threads
   PrepareCommandsStack();
 
+  //Workers which have finished their event loop may transport tracks of
+  //the events of other workers until the last one has finished
+  G4SubEventQueue::GetInstance()
+    ->BeginRun( threads.empty() ? nworkers : G4int(threads.size()) );
+
   //Start worker threads
   CreateAndStartWorkers();
     
@@ -382,6 +406,52 @@ void G4MTRunManager::RefillSeeds()
   nSeedsFilled += nFill;
 //G4cout<<"helper->Refill() for "<<nFill<<" events."<<G4endl;
 }
+
+void G4MTRunManager::FillEventQueue()
+{
+  if(!eventQueue) eventQueue = new G4WorkStealingEventQueue;
+  eventQueue->Reset(nworkers);
+  nEventsQueued = 0;
+  // With counter-based streams workers derive the random stream of each
+  // event from its ID, no seed is needed.
+  userEventSeeds = !eventRandomStreams && InitializeSeeds(numberOfEventToBeProcessed);
+  RefillEventQueue();
+}
+
+G4bool G4MTRunManager::RefillEventQueue()
+{
+  // Queues the next chunk of events. The seeds are generated in the same
+  // sequence as for seedOncePerCommunication=0, so that a given event gets
+  // the same seeds whichever worker eventually processes it. Invoked by
+  // the master at the beginning of the event loop and then by workers,
+  // under setUpEventMutex, once all queued events have been dispatched.
+  G4int nFill = numberOfEventToBeProcessed - nEventsQueued;
+  if(nFill<=0) return false;
+  if(nFill>nSeedsMax) nFill=nSeedsMax;
+  if ( eventRandomStreams )
+  {
+    eventQueue->Fill(nEventsQueued,nFill);
+  }
+  else
+  {
+    eventSeeds.resize(nSeedsPerEvent*nFill);
+    if ( userEventSeeds )
+    {
+      G4RNGHelper* helper = G4RNGHelper::GetInstance();
+      for(G4int i=0;i<nSeedsPerEvent*nFill;i++)
+      { eventSeeds[i] = helper->GetSeed(nSeedsPerEvent*nEventsQueued+i); }
+    }
+    else
+    {
+      masterRNGEngine->flatArray(nSeedsPerEvent*nFill,randDbl);
+      for(G4int i=0;i<nSeedsPerEvent*nFill;i++)
+      { eventSeeds[i] = (G4long)(100000000L*randDbl[i]); }
+    }
+    eventQueue->Fill(nEventsQueued,nFill,&(eventSeeds[0]),nSeedsPerEvent);
+  }
+  nEventsQueued += nFill;
+  return true;
+}
     
 void G4MTRunManager::RunTermination()
 {
@@ -391,6 +461,16 @@ void G4MTRunManager::RunTermination()
 
   // Wait now for all threads to finish event-loop
   WaitForEndEventLoopWorkers();
+  if(workStealing && eventQueue && !fakeRun)
+  {
+    numberOfEventProcessed = eventQueue->GetNumberOfDispatchedEvents();
+    if(verboseLevel>1)
+    {
+      G4cout << "G4MTRunManager: " << numberOfEventProcessed
+             << " events dispatched with " << eventQueue->GetNumberOfSteals()
+             << " steals between worker threads." << G4endl;
+    }
+  }
   //Now call base-class methof
   G4RunManager::TerminateEventLoop();
   G4RunManager::RunTermination();
@@ -540,6 +620,29 @@ G4int G4MTRunManager::SetUpNEvents(G4Event* evt, G4SeedsQueue* seedsQueue,G4bool
   return 0;
 }
 
+G4bool G4MTRunManager::SetUpAnEventFromQueue(G4Event* evt, G4int workerId,
+                                              long& s1, long& s2, long& s3)
+{
+  if( runAborted || !eventQueue ) return false;
+  G4int evID = -1;
+  long seeds[3];
+  if( !eventQueue->NextEvent(workerId,evID,seeds) )
+  {
+    // All queued events are dispatched: the first worker to get here
+    // queues the next chunk, the others find it when retrying.
+    G4AutoLock l(&setUpEventMutex);
+    while( !eventQueue->NextEvent(workerId,evID,seeds) )
+    {
+      if( runAborted || !RefillEventQueue() ) return false;
+    }
+  }
+  evt->SetEventID(evID);
+  s1 = seeds[0];
+  s2 = seeds[1];
+  if(nSeedsPerEvent==3) s3 = seeds[2];
+  return true;
+}
+
 void G4MTRunManager::TerminateWorkers()
 {
     NewActionRequest( ENDWORKER );
@@ -565,6 +668,7 @@ void G4MTRunManager::AbortRun(G4bool softAbort)
   if(currentState==G4State_GeomClosed || currentState==G4State_EventProc)
   {
     runAborted = true;
+    if(workStealing && eventQueue) eventQueue->Clear();
     MTkernel->BroadcastAbortRun(softAbort);
   }
   else
@@ -905,3 +1009,133 @@ void G4MTRunManager::SetPinAffinity(G4int n)
 	pinAffinity = n;
 	return;
 }
+
+void G4MTRunManager::SetAffinityPolicy(AffinityPolicy policy,
+                                       const std::vector<G4int>& cpus)
+{
+  if ( policy == explicitAffinity && cpus.empty() )
+  {
+    G4Exception("G4MTRunManager::SetAffinityPolicy","Run0035",JustWarning,
+                "Explicit affinity policy requires a non-empty list of CPUs. Ignored.");
+    return;
+  }
+  if ( threads.size() > 0 )
+  {
+    G4Exception("G4MTRunManager::SetAffinityPolicy","Run0035",JustWarning,
+                "Worker threads are already started. Affinity policy is not changed.");
+    return;
+  }
+  affinityPolicy = policy;
+  affinityCPUs.clear();
+  if ( policy == explicitAffinity ) affinityCPUs = cpus;
+}
+
+G4int G4MTRunManager::GetAffinityCPU(G4int threadId) const
+{
+  if ( affinityPolicy == noAffinityPolicy || affinityCPUs.empty() ) return -1;
+  return affinityCPUs[threadId % affinityCPUs.size()];
+}
+
+namespace {
+  // Topology of one logical CPU as seen by the kernel
+  struct G4CPUTopology
+  {
+    G4int cpu;
+    G4int socket;
+    G4int core;
+    G4int smt; // index among the hardware threads of the same core
+  };
+
+  G4int ReadTopologyValue(G4int cpu, const char* item)
+  {
+    std::ostringstream fname;
+    fname << "/sys/devices/system/cpu/cpu" << cpu << "/topology/" << item;
+    std::ifstream in(fname.str().c_str());
+    G4int val = -1;
+    if ( !(in >> val) ) val = -1;
+    return val;
+  }
+
+  G4bool CompactOrder(const G4CPUTopology& a, const G4CPUTopology& b)
+  {
+    if ( a.socket != b.socket ) return a.socket < b.socket;
+    if ( a.core != b.core ) return a.core < b.core;
+    return a.cpu < b.cpu;
+  }
+
+  G4bool CoresFirstOrder(const G4CPUTopology& a, const G4CPUTopology& b)
+  {
+    if ( a.socket != b.socket ) return a.socket < b.socket;
+    if ( a.smt != b.smt ) return a.smt < b.smt;
+    if ( a.core != b.core ) return a.core < b.core;
+    return a.cpu < b.cpu;
+  }
+}
+
+void G4MTRunManager::BuildAffinityCPUList()
+{
+  if ( affinityPolicy == noAffinityPolicy || affinityPolicy == explicitAffinity )
+  { return; }
+
+  G4int ncpu = G4Threading::G4GetNumberOfCores();
+  std::vector<G4CPUTopology> topo;
+  for ( G4int i = 0; i < ncpu; ++i )
+  {
+    G4CPUTopology t;
+    t.cpu = i;
+    t.socket = ReadTopologyValue(i,"physical_package_id");
+    t.core = ReadTopologyValue(i,"core_id");
+    // Topology not available (not Linux, or offline CPU): one socket,
+    // one hardware thread per core
+    if ( t.socket < 0 ) t.socket = 0;
+    if ( t.core < 0 ) t.core = i;
+    t.smt = 0;
+    for ( size_t j = 0; j < topo.size(); ++j )
+    {
+      if ( topo[j].socket == t.socket && topo[j].core == t.core ) ++(t.smt);
+    }
+    topo.push_back(t);
+  }
+
+  affinityCPUs.clear();
+  if ( affinityPolicy == compactAffinity )
+  {
+    std::sort(topo.begin(),topo.end(),CompactOrder);
+    for ( size_t i = 0; i < topo.size(); ++i ) affinityCPUs.push_back(topo[i].cpu);
+  }
+  else
+  {
+    // Per socket, physical cores first then their SMT siblings. Workers are
+    // then dealt round-robin over the sockets.
+    std::sort(topo.begin(),topo.end(),CoresFirstOrder);
+    std::vector<std::vector<G4int> > sockets;
+    G4int lastSocket = -1;
+    for ( size_t i = 0; i < topo.size(); ++i )
+    {
+      if ( sockets.empty() || topo[i].socket != lastSocket )
+      {
+        sockets.push_back(std::vector<G4int>());
+        lastSocket = topo[i].socket;
+      }
+      sockets.back().push_back(topo[i].cpu);
+    }
+    size_t maxPerSocket = 0;
+    for ( size_t s = 0; s < sockets.size(); ++s )
+    { maxPerSocket = std::max(maxPerSocket,sockets[s].size()); }
+    for ( size_t k = 0; k < maxPerSocket; ++k )
+    {
+      for ( size_t s = 0; s < sockets.size(); ++s )
+      { if ( k < sockets[s].size() ) affinityCPUs.push_back(sockets[s][k]); }
+    }
+  }
+
+  if ( verboseLevel > 0 )
+  {
+    G4cout << "G4MTRunManager: worker affinity ("
+           << (affinityPolicy==compactAffinity ? "compact" : "scatter")
+           << ") :";
+    for ( G4int nw = 0; nw < nworkers && nw < G4int(affinityCPUs.size()); ++nw )
+    { G4cout << " " << affinityCPUs[nw]; }
+    G4cout << G4endl;
+  }
+}
@@ -135,8 +135,15 @@ void* G4MTRunManagerKernel::StartThread(void* context)
   //============================
   //Optimization: optional
   //============================
-  //Enforce thread affinity if requested
-  wThreadContext->SetPinAffinity(masterRM->GetPinAffinity());
+  //Enforce thread affinity if requested. This must be done before any
+  //thread-local data (random engine, workspaces, allocator pools) is
+  //created, such that with the default first-touch policy of the operating
+  //system their memory is placed on the NUMA node of this thread.
+  G4int affinityCPU = masterRM->GetAffinityCPU(thisID);
+  if ( affinityCPU >= 0 )
+  { wThreadContext->PinToCPU(affinityCPU); }
+  else
+  { wThreadContext->SetPinAffinity(masterRM->GetPinAffinity()); }
 
   //============================
   //Step-1: Random number engine
@@ -30,6 +30,9 @@
 #include "G4Run.hh"
 #include "G4Event.hh"
 #include "G4RunManager.hh"
+#include "G4THitsMap.hh"
+#include <iostream>
+#include <typeinfo>
 
 G4Run::G4Run()
 :runID(0),numberOfEvent(0),numberOfEventToBeProcessed(0),HCtable(0),DCtable(0)
@@ -59,6 +62,64 @@ void G4Run::Merge(const G4Run* right)
   { eventVector->push_back(*itr); }
 }
 
+void G4Run::Pack(std::ostream& out) const
+{
+  out.write((const char*)&numberOfEvent,sizeof(G4int));
+  PackData(out);
+}
+
+void G4Run::UnPack(std::istream& in)
+{
+  in.read((char*)&numberOfEvent,sizeof(G4int));
+  UnPackData(in);
+}
+
+void G4Run::PackHitsMap(std::ostream& out, const G4THitsMap<G4double>* map)
+{
+  std::map<G4int,G4double*>* hitsMap = map->GetMap();
+  G4int nEntries = hitsMap->size();
+  out.write((const char*)&nEntries,sizeof(G4int));
+  for(auto& hit : *hitsMap)
+  {
+    out.write((const char*)&(hit.first),sizeof(G4int));
+    out.write((const char*)hit.second,sizeof(G4double));
+  }
+}
+
+G4bool G4Run::UnPackHitsMap(std::istream& in, const G4THitsMap<G4double>* map)
+{
+  G4int nEntries = 0;
+  in.read((char*)&nEntries,sizeof(G4int));
+  for(G4int ie=0;ie<nEntries && in;ie++)
+  {
+    G4int key = 0;
+    G4double val = 0.;
+    in.read((char*)&key,sizeof(G4int));
+    in.read((char*)&val,sizeof(G4double));
+    if(in) map->add(key,val);
+  }
+  return !in.fail();
+}
+
+void G4Run::PackData(std::ostream&) const
+{
+  if(typeid(*this)==typeid(G4Run)) return;
+  G4ExceptionDescription ED;
+  ED << "The run class <" << typeid(*this).name() << "> does not implement"
+     << " PackData() and UnPackData(). Its data would be lost when runs are"
+     << " transferred between processes or written to a checkpoint.";
+  G4Exception("G4Run::PackData","Run0304",FatalException,ED);
+}
+
+void G4Run::UnPackData(std::istream&)
+{
+  if(typeid(*this)==typeid(G4Run)) return;
+  G4ExceptionDescription ED;
+  ED << "The run class <" << typeid(*this).name() << "> does not implement"
+     << " PackData() and UnPackData().";
+  G4Exception("G4Run::UnPackData","Run0304",FatalException,ED);
+}
+
 void G4Run::StoreEvent(G4Event* evt)
 { eventVector->push_back(evt); }
 
@@ -40,6 +40,7 @@
 #include "G4StateManager.hh"
 #include "G4ApplicationState.hh"
 #include "Randomize.hh"
+#include "CLHEP/Random/PhiloxEngine.h"
 #include "G4Run.hh"
 #include "G4RunMessenger.hh"
 #include "G4VUserPhysicsList.hh"
@@ -61,7 +62,17 @@
 #include "G4ParallelWorldProcessStore.hh"
 
 #include "G4ios.hh"
+#include "G4MTRunManager.hh"
+#include "G4ScoringManager.hh"
+#include "G4VScoringMesh.hh"
+#include "G4THitsMap.hh"
+#include "G4SteppingProfiler.hh"
+#include "G4StepTraceWriter.hh"
+#include "G4AnalysisPacker.hh"
 #include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <climits>
 
 using namespace CLHEP;
 
@@ -93,7 +104,11 @@ G4RunManager::G4RunManager()
  numberOfEventToBeProcessed(0),storeRandomNumberStatus(false),
  storeRandomNumberStatusToG4Event(0),rngStatusEventsFlag(false),
  currentWorld(0),nParallelWorlds(0),msgText(" "),n_select_msg(-1),
- numberOfEventProcessed(0),selectMacro(""),fakeRun(false)
+ numberOfEventProcessed(0),selectMacro(""),fakeRun(false),
+ eventRandomStreams(false),eventStreamSeed(0),streamRunID(0),
+ streamEventOffset(0),replayRunID(-1),replayEventID(-1),
+ streamEngine(nullptr),engineBeforeStreams(nullptr),
+ checkpointInterval(0),checkpointGeneration(0),eventsSinceCheckpoint(0)
 {
   if(fRunManager)
   {
@@ -132,7 +147,11 @@ G4RunManager::G4RunManager( RMType rmType )
  numberOfEventToBeProcessed(0),storeRandomNumberStatus(false),
  storeRandomNumberStatusToG4Event(0),rngStatusEventsFlag(false),
  currentWorld(0),nParallelWorlds(0),msgText(" "),n_select_msg(-1),
- numberOfEventProcessed(0),selectMacro(""),fakeRun(false)
+ numberOfEventProcessed(0),selectMacro(""),fakeRun(false),
+ eventRandomStreams(false),eventStreamSeed(0),streamRunID(0),
+ streamEventOffset(0),replayRunID(-1),replayEventID(-1),
+ streamEngine(nullptr),engineBeforeStreams(nullptr),
+ checkpointInterval(0),checkpointGeneration(0),eventsSinceCheckpoint(0)
 {
   //This version of the constructor should never be called in sequential mode!
 #ifndef G4MULTITHREADED
@@ -191,6 +210,8 @@ G4RunManager::~G4RunManager()
   }
 
   CleanUpPreviousEvents();
+  EndEventRandomStreams();
+  delete streamEngine;
   if(currentRun) delete currentRun;
   delete timer;
   delete runMessenger;
@@ -328,6 +349,7 @@ void G4RunManager::RunInitialization()
 
   currentRun->SetRunID(runIDCounter);
   currentRun->SetNumberOfEventToBeProcessed(numberOfEventToBeProcessed);
+  if(eventRandomStreams) PrepareEventRandomStreams();
 
   currentRun->SetDCtable(DCtable);
   G4SDManager* fSDM = G4SDManager::GetSDMpointerIfExist();
@@ -355,6 +377,17 @@ void G4RunManager::RunInitialization()
       }
       StoreRNGStatus(fileN);
   }
+
+  completedEvents.clear();
+  resumedEvents.clear();
+  eventsSinceCheckpoint = 0;
+  if(!resumeFile.empty())
+  {
+    ReadCheckpoint();
+    resumeFile = "";
+  }
+  // Workers do not write anything before their first events are completed
+  if(checkpointInterval>0 && runManagerType!=workerRM) WriteCheckpoint();
 }
 
 void G4RunManager::DoEventLoop(G4int n_event,const char* macroFile,G4int n_select)
@@ -364,6 +397,7 @@ void G4RunManager::DoEventLoop(G4int n_event,const char* macroFile,G4int n_selec
 // Event loop
   for(G4int i_event=0; i_event<n_event; i_event++ )
   {
+    if(IsEventCompleted(i_event)) continue;
     ProcessOneEvent(i_event);
     TerminateOneEvent();
     if(runAborted) break;
@@ -391,6 +425,8 @@ void G4RunManager::InitializeEventLoop(G4int n_event,const char* macroFile,G4int
       n_select_msg = -1;
       selectMacro = "";
   }
+
+  if(eventRandomStreams && !fakeRun) StartEventRandomStreams();
 }
 
 void G4RunManager::ProcessOneEvent(G4int i_event)
@@ -404,6 +440,8 @@ void G4RunManager::ProcessOneEvent(G4int i_event)
 
 void G4RunManager::TerminateOneEvent()
 {
+  if(checkpointInterval>0 && currentEvent)
+  { RecordCompletedEvent(currentEvent->GetEventID()); }
   StackPreviousEvent(currentEvent);
   currentEvent = 0;
   numberOfEventProcessed++;
@@ -411,6 +449,7 @@ void G4RunManager::TerminateOneEvent()
 
 void G4RunManager::TerminateEventLoop()
 {
+  EndEventRandomStreams();
   if(verboseLevel>0 && !fakeRun)
   {
     timer->Stop();
@@ -436,6 +475,7 @@ G4Event* G4RunManager::GenerateEvent(G4int i_event)
   }
 
   G4Event* anEvent = new G4Event(i_event);
+  if(eventRandomStreams) SetUpEventRandomStream(i_event);
 
   if(storeRandomNumberStatusToG4Event==1 || storeRandomNumberStatusToG4Event==3)
   {
@@ -474,12 +514,388 @@ void G4RunManager::AnalyzeEvent(G4Event* anEvent)
   currentRun->RecordEvent(anEvent);
 }
 
+void G4RunManager::SetEventRandomStreams(G4bool flag, G4long seed)
+{
+  if(flag && !CLHEP::PhiloxEngine::selfTest())
+  {
+    G4Exception("G4RunManager::SetEventRandomStreams","Run0312",FatalException,
+                "CLHEP::PhiloxEngine does not reproduce its known-answer vectors.");
+  }
+  eventRandomStreams = flag;
+  eventStreamSeed = seed;
+}
+
+void G4RunManager::ReplayEventRandomStream(G4int runID, G4int eventID)
+{
+  if(!eventRandomStreams)
+  {
+    G4Exception("G4RunManager::ReplayEventRandomStream()","Run0311",JustWarning,
+                "Event random streams are not used. Command is ignored.");
+    return;
+  }
+  replayRunID = runID;
+  replayEventID = eventID;
+}
+
+void G4RunManager::PrepareEventRandomStreams()
+{
+  // Zero would make all runs of all jobs identical
+  if(eventStreamSeed==0)
+  { eventStreamSeed = (G4long)(100000000L*G4UniformRand()) + 1; }
+
+  streamRunID = currentRun->GetRunID();
+  streamEventOffset = 0;
+  if(replayRunID>=0)
+  {
+    streamRunID = replayRunID;
+    streamEventOffset = replayEventID;
+    replayRunID = -1;
+    replayEventID = -1;
+  }
+
+  if(printModulo>=0 || verboseLevel>0)
+  {
+    G4cout << "### Run " << currentRun->GetRunID()
+           << " uses event random streams with seed " << eventStreamSeed;
+    if(streamRunID!=currentRun->GetRunID() || streamEventOffset!=0)
+    {
+      G4cout << " (replaying the streams of run " << streamRunID
+             << " from event " << streamEventOffset << ")";
+    }
+    G4cout << "." << G4endl;
+  }
+}
+
+void G4RunManager::CopyEventRandomStreams(const G4RunManager* masterRunManager)
+{
+  eventRandomStreams = masterRunManager->eventRandomStreams;
+  eventStreamSeed = masterRunManager->eventStreamSeed;
+  streamRunID = masterRunManager->streamRunID;
+  streamEventOffset = masterRunManager->streamEventOffset;
+}
+
+void G4RunManager::StartEventRandomStreams()
+{
+  if(!streamEngine) streamEngine = new CLHEP::PhiloxEngine(eventStreamSeed);
+  else streamEngine->setSeed(eventStreamSeed);
+  if(!engineBeforeStreams)
+  {
+    engineBeforeStreams = G4Random::getTheEngine();
+    G4Random::setTheEngine(streamEngine);
+  }
+}
+
+void G4RunManager::SetUpEventRandomStream(G4int eventID)
+{
+  if(streamEngine)
+  { streamEngine->setStream(streamRunID,streamEventOffset+eventID); }
+}
+
+void G4RunManager::EndEventRandomStreams()
+{
+  if(engineBeforeStreams)
+  {
+    G4Random::setTheEngine(engineBeforeStreams);
+    engineBeforeStreams = nullptr;
+  }
+}
+
+void G4RunManager::SetCheckpoint(const G4String& fileName, G4int interval)
+{
+  checkpointFile = fileName;
+  checkpointInterval = fileName.empty() ? 0 : std::max(interval,0);
+}
+
+void G4RunManager::ResumeFromCheckpoint(const G4String& fileName)
+{ resumeFile = fileName; }
+
+void G4RunManager::CopyCheckpointSettings(const G4RunManager* masterRunManager)
+{
+  checkpointFile = masterRunManager->checkpointFile;
+  checkpointInterval = masterRunManager->checkpointInterval;
+  checkpointGeneration = masterRunManager->checkpointGeneration;
+  resumedEvents = masterRunManager->resumedEvents;
+  completedEvents.clear();
+  eventsSinceCheckpoint = 0;
+}
+
+namespace
+{
+  const char checkpointMagic[8] = { 'G','4','C','K','P','T','0','2' };
+
+  void NormalizeRanges(std::vector<std::pair<G4int,G4int> >& ranges)
+  {
+    if(ranges.size()<2) return;
+    std::sort(ranges.begin(),ranges.end());
+    size_t n = 0;
+    for(size_t i=1;i<ranges.size();i++)
+    {
+      if(ranges[i].first<=ranges[n].second+1)
+      { ranges[n].second = std::max(ranges[n].second,ranges[i].second); }
+      else
+      { ranges[++n] = ranges[i]; }
+    }
+    ranges.resize(n+1);
+  }
+
+  G4String WorkerCheckpointFile(const G4String& fileName, G4int threadID)
+  {
+    std::ostringstream os;
+    os << fileName << ".t" << threadID;
+    return os.str();
+  }
+}
+
+void G4RunManager::RecordCompletedEvent(G4int eventID)
+{
+  if(!completedEvents.empty() && completedEvents.back().second+1==eventID)
+  { completedEvents.back().second = eventID; }
+  else
+  { completedEvents.push_back(std::make_pair(eventID,eventID)); }
+
+  if(++eventsSinceCheckpoint>=checkpointInterval)
+  {
+    WriteCheckpoint();
+    eventsSinceCheckpoint = 0;
+  }
+}
+
+G4bool G4RunManager::IsEventCompleted(G4int eventID) const
+{
+  if(resumedEvents.empty()) return false;
+  G4EventIDRanges::const_iterator itr
+    = std::upper_bound(resumedEvents.begin(),resumedEvents.end(),
+                       std::make_pair(eventID,INT_MAX));
+  if(itr==resumedEvents.begin()) return false;
+  --itr;
+  return (eventID<=itr->second);
+}
+
+void G4RunManager::WriteCheckpoint()
+{
+  if(fakeRun || !currentRun || checkpointFile.empty()) return;
+
+  G4String fileName = checkpointFile;
+  G4int nWorkers = 0;
+  G4String engineStatus;
+  G4EventIDRanges ranges = completedEvents;
+  if(runManagerType==workerRM)
+  {
+    // The status of the engine of the master at the beginning of the run
+    // is sufficient to regenerate the seeds of the events
+    fileName = WorkerCheckpointFile(checkpointFile,G4Threading::G4GetThreadId());
+  }
+  else
+  {
+    ranges.insert(ranges.end(),resumedEvents.begin(),resumedEvents.end());
+    if(runManagerType==masterRM)
+    {
+      nWorkers = static_cast<G4MTRunManager*>(this)->GetNumberOfThreads();
+      engineStatus = randomNumberStatusForThisRun;
+    }
+    else if(!eventRandomStreams)
+    {
+      std::ostringstream oss;
+      G4Random::saveFullState(oss);
+      engineStatus = oss.str();
+    }
+  }
+  NormalizeRanges(ranges);
+
+  G4String tmpName = fileName + ".tmp";
+  std::ofstream out(tmpName.c_str(),std::ios::out|std::ios::binary|std::ios::trunc);
+  G4int runID = currentRun->GetRunID();
+  G4int nRanges = ranges.size();
+  G4int nStatus = engineStatus.size();
+  out.write(checkpointMagic,sizeof(checkpointMagic));
+  out.write((const char*)&checkpointGeneration,sizeof(G4int));
+  out.write((const char*)&runID,sizeof(G4int));
+  out.write((const char*)&numberOfEventToBeProcessed,sizeof(G4int));
+  out.write((const char*)&nWorkers,sizeof(G4int));
+  out.write((const char*)&nStatus,sizeof(G4int));
+  out.write(engineStatus.data(),nStatus);
+  out.write((const char*)&nRanges,sizeof(G4int));
+  for(G4int i=0;i<nRanges;i++)
+  {
+    out.write((const char*)&(ranges[i].first),sizeof(G4int));
+    out.write((const char*)&(ranges[i].second),sizeof(G4int));
+  }
+  currentRun->Pack(out);
+  PackScoringMeshes(out);
+  G4AnalysisPacker::Write(out);
+  out.close();
+
+  if(out.fail() || std::rename(tmpName.c_str(),fileName.c_str())!=0)
+  {
+    G4ExceptionDescription ED;
+    ED << "Checkpoint file <" << fileName << "> cannot be written.";
+    G4Exception("G4RunManager::WriteCheckpoint","Run0322",JustWarning,ED);
+  }
+}
+
+void G4RunManager::ReadCheckpoint()
+{
+  std::vector<G4String> fileNames(1,resumeFile);
+  G4int generation = -1;
+  G4int nResumedEvents = 0;
+  for(size_t iFile=0;iFile<fileNames.size();iFile++)
+  {
+    std::ifstream in(fileNames[iFile].c_str(),std::ios::in|std::ios::binary);
+    char magic[sizeof(checkpointMagic)];
+    G4int header[5] = { 0, 0, 0, 0, 0 };
+    in.read(magic,sizeof(magic));
+    in.read((char*)header,sizeof(header));
+    if(!in || std::string(magic,sizeof(magic))!=std::string(checkpointMagic,sizeof(magic)))
+    {
+      // Workers which did not complete any event before the job was
+      // stopped have not written any file
+      if(iFile>0) continue;
+      G4ExceptionDescription ED;
+      ED << "Checkpoint file <" << resumeFile << "> cannot be read. "
+         << "The run starts from the first event.";
+      G4Exception("G4RunManager::ReadCheckpoint","Run0321",JustWarning,ED);
+      return;
+    }
+    if(iFile==0)
+    {
+      if(header[2]!=numberOfEventToBeProcessed)
+      {
+        G4ExceptionDescription ED;
+        ED << "Checkpoint file <" << resumeFile << "> was written for a run of "
+           << header[2] << " events, while " << numberOfEventToBeProcessed
+           << " events are requested. The run starts from the first event.";
+        G4Exception("G4RunManager::ReadCheckpoint","Run0321",JustWarning,ED);
+        return;
+      }
+      if(header[1]!=currentRun->GetRunID())
+      {
+        G4ExceptionDescription ED;
+        ED << "Checkpoint file <" << resumeFile << "> was written for run "
+           << header[1] << ". It is merged to run " << currentRun->GetRunID() << ".";
+        G4Exception("G4RunManager::ReadCheckpoint","Run0321",JustWarning,ED);
+      }
+      generation = header[0];
+      for(G4int i=0;i<header[3];i++)
+      { fileNames.push_back(WorkerCheckpointFile(resumeFile,i)); }
+    }
+    // Files of the workers of older jobs are ignored. Their events are
+    // already included in the file of the master.
+    else if(header[0]!=generation) continue;
+
+    std::string engineStatus(header[4],'\0');
+    if(header[4]>0) in.read(&engineStatus[0],header[4]);
+    G4int nRanges = 0;
+    in.read((char*)&nRanges,sizeof(G4int));
+    G4EventIDRanges ranges(nRanges>0 ? nRanges : 0);
+    for(G4int i=0;i<nRanges && in;i++)
+    {
+      in.read((char*)&(ranges[i].first),sizeof(G4int));
+      in.read((char*)&(ranges[i].second),sizeof(G4int));
+    }
+    G4Run* aRun = 0;
+    if(userRunAction) aRun = userRunAction->GenerateRun();
+    if(!aRun) aRun = new G4Run();
+    aRun->UnPack(in);
+    if(!in)
+    {
+      G4ExceptionDescription ED;
+      ED << "Checkpoint file <" << fileNames[iFile] << "> is corrupted and ignored.";
+      if(iFile==0) ED << " The run starts from the first event.";
+      G4Exception("G4RunManager::ReadCheckpoint","Run0321",JustWarning,ED);
+      delete aRun;
+      if(iFile==0) return;
+      continue;
+    }
+    currentRun->Merge(aRun);
+    delete aRun;
+    if(!MergeScoringMeshes(in))
+    {
+      G4ExceptionDescription ED;
+      ED << "Scores stored in checkpoint file <" << fileNames[iFile]
+         << "> do not match the scoring meshes and are not restored.";
+      G4Exception("G4RunManager::ReadCheckpoint","Run0321",JustWarning,ED);
+    }
+    G4AnalysisPacker analysisPacker;
+    if(!analysisPacker.Read(in) || !analysisPacker.Merge())
+    {
+      G4ExceptionDescription ED;
+      ED << "Histograms stored in checkpoint file <" << fileNames[iFile]
+         << "> do not match those of the analysis manager and are not restored.";
+      G4Exception("G4RunManager::ReadCheckpoint","Run0321",JustWarning,ED);
+    }
+    resumedEvents.insert(resumedEvents.end(),ranges.begin(),ranges.end());
+    for(G4int i=0;i<nRanges;i++)
+    { nResumedEvents += ranges[i].second - ranges[i].first + 1; }
+
+    if(!engineStatus.empty())
+    {
+      std::istringstream is(engineStatus);
+      G4Random::restoreFullState(is);
+      // The seeds of the events are generated from this status
+      if(runManagerType==masterRM)
+      {
+        randomNumberStatusForThisRun = engineStatus;
+        currentRun->SetRandomNumberStatus(randomNumberStatusForThisRun);
+      }
+    }
+  }
+  NormalizeRanges(resumedEvents);
+  checkpointGeneration = generation+1;
+
+  if(verboseLevel>0 || printModulo>=0)
+  {
+    G4cout << "### Run " << currentRun->GetRunID() << " is resumed from <"
+           << resumeFile << ">: " << nResumedEvents
+           << " events are already completed." << G4endl;
+  }
+}
+
+void G4RunManager::PackScoringMeshes(std::ostream& out) const
+{
+  G4ScoringManager* ScM = G4ScoringManager::GetScoringManagerIfExist();
+  G4int nMesh = ScM ? G4int(ScM->GetNumberOfMesh()) : 0;
+  out.write((const char*)&nMesh,sizeof(G4int));
+  for(G4int iw=0;iw<nMesh;iw++)
+  {
+    MeshScoreMap scMap = ScM->GetMesh(iw)->GetScoreMap();
+    G4int nMap = scMap.size();
+    out.write((const char*)&nMap,sizeof(G4int));
+    for(auto& mapItr : scMap)
+    { G4Run::PackHitsMap(out,mapItr.second); }
+  }
+}
+
+G4bool G4RunManager::MergeScoringMeshes(std::istream& in)
+{
+  // Meshes and quantities are the same in all threads and processes
+  G4ScoringManager* ScM = G4ScoringManager::GetScoringManagerIfExist();
+  G4int nMesh = 0;
+  in.read((char*)&nMesh,sizeof(G4int));
+  if(nMesh>0 && (!ScM || G4int(ScM->GetNumberOfMesh())!=nMesh)) return false;
+  for(G4int iw=0;iw<nMesh && in;iw++)
+  {
+    MeshScoreMap scMap = ScM->GetMesh(iw)->GetScoreMap();
+    G4int nMap = 0;
+    in.read((char*)&nMap,sizeof(G4int));
+    if(nMap!=G4int(scMap.size())) return false;
+    MeshScoreMap::iterator mapItr = scMap.begin();
+    for(G4int im=0;im<nMap && in;im++,mapItr++)
+    { G4Run::UnPackHitsMap(in,mapItr->second); }
+  }
+  return !in.fail();
+}
+
 void G4RunManager::RunTermination()
 {
   if(!fakeRun)
   {
     CleanUpUnnecessaryEvents(0);
     if(userRunAction) userRunAction->EndOfRunAction(currentRun);
+    // Worker threads are done with the run at this point
+    if(runManagerType!=workerRM && G4SteppingProfiler::IsEnabled())
+    { G4SteppingProfiler::Report(); }
+    // Each thread completes its own step trace file
+    G4StepTraceWriter::EndOfRun();
     G4VPersistencyManager* fPersM = G4VPersistencyManager::GetPersistencyManager();
     if(fPersM) fPersM->Store(currentRun);
     runIDCounter++;
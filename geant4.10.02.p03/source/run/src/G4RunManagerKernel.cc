@@ -622,6 +622,10 @@ G4bool G4RunManagerKernel::RunInitialization(G4bool fakeRun)
  
   GetPrimaryTransformer()->CheckUnknown();
 
+  // Process dispatch tables used by the stepping loop
+  if(runManagerKernelType!=masterRMK)
+  { GetTrackingManager()->GetSteppingManager()->BuildDispatchTables(); }
+
   stateManager->SetNewState(G4State_GeomClosed);
   return true;
 }
@@ -30,6 +30,7 @@
 #include "G4RunMessenger.hh"
 #include "G4RunManager.hh"
 #include "G4MTRunManager.hh"
+#include "G4ForkRunManager.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithAString.hh"
@@ -133,6 +134,29 @@ G4RunMessenger::G4RunMessenger(G4RunManager * runMgr)
   pinAffinityCmd->SetRange("pinAffinity > 0 || pinAffinity < 0");
   pinAffinityCmd->AvailableForStates(G4State_PreInit);
 
+  affinityPolicyCmd = new G4UIcommand("/run/affinityPolicy",this);
+  affinityPolicyCmd->SetGuidance("Set the placement policy of worker threads on logical CPUs.");
+  affinityPolicyCmd->SetGuidance(" none     : threads are not pinned by this policy (default).");
+  affinityPolicyCmd->SetGuidance(" compact  : fill all CPUs of a socket before using the next one.");
+  affinityPolicyCmd->SetGuidance(" scatter  : distribute threads round-robin over the sockets,");
+  affinityPolicyCmd->SetGuidance("            using distinct physical cores first.");
+  affinityPolicyCmd->SetGuidance(" explicit : thread i is pinned to the i-th CPU of the given list,");
+  affinityPolicyCmd->SetGuidance("            e.g. /run/affinityPolicy explicit 0 2 4 6");
+  affinityPolicyCmd->SetGuidance("Threads are pinned before their thread-local data are created, so");
+  affinityPolicyCmd->SetGuidance("that these are allocated on the NUMA node of the thread.");
+  affinityPolicyCmd->SetGuidance("If a policy other than none is set, /run/pinAffinity is ignored.");
+  affinityPolicyCmd->SetGuidance("This command is valid only for multi-threaded mode.");
+  affinityPolicyCmd->SetGuidance("This command works only in PreInit state.");
+  affinityPolicyCmd->SetGuidance("This command is ignored if it is issued in sequential mode.");
+  G4UIparameter* afp1 = new G4UIparameter("policy",'s',false);
+  afp1->SetParameterCandidates("none compact scatter explicit");
+  affinityPolicyCmd->SetParameter(afp1);
+  G4UIparameter* afp2 = new G4UIparameter("cpuList",'s',true);
+  afp2->SetDefaultValue("");
+  affinityPolicyCmd->SetParameter(afp2);
+  affinityPolicyCmd->SetToBeBroadcasted(false);
+  affinityPolicyCmd->AvailableForStates(G4State_PreInit);
+
   evModCmd = new G4UIcommand("/run/eventModulo",this);
   evModCmd->SetGuidance("Set the event modulo for dispatching events to worker threads"); 
   evModCmd->SetGuidance("i.e. each worker thread is ordered to simulate N events and then");
@@ -171,6 +195,61 @@ G4RunMessenger::G4RunMessenger(G4RunManager * runMgr)
   evModCmd->SetToBeBroadcasted(false);
   evModCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 
+  workStealCmd = new G4UIcmdWithABool("/run/workStealing",this);
+  workStealCmd->SetGuidance("Dispatch events to worker threads through per-thread queues");
+  workStealCmd->SetGuidance("with work stealing instead of bunches of N events (see /run/eventModulo).");
+  workStealCmd->SetGuidance("Events of a run are distributed in blocks over the worker threads");
+  workStealCmd->SetGuidance("at the beginning of the run; a thread which has processed all its");
+  workStealCmd->SetGuidance("events takes over half of the remaining events of another thread.");
+  workStealCmd->SetGuidance("Seeds are assigned to every event beforehand by the master, so event");
+  workStealCmd->SetGuidance("reproducibility does not depend on the number of threads, and");
+  workStealCmd->SetGuidance("the seedOnce parameter of /run/eventModulo is ignored.");
+  workStealCmd->SetGuidance("This is useful if the CPU time per event has a large spread.");
+  workStealCmd->SetGuidance("This command is valid only for multi-threaded mode.");
+  workStealCmd->SetGuidance("This command is ignored if it is issued in sequential mode.");
+  workStealCmd->SetParameterName("flag",true);
+  workStealCmd->SetDefaultValue(true);
+  workStealCmd->SetToBeBroadcasted(false);
+  workStealCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  nProcessesCmd = new G4UIcmdWithAnInteger("/run/numberOfProcesses",this);
+  nProcessesCmd->SetGuidance("Set the number of worker processes forked at each run.");
+  nProcessesCmd->SetGuidance("Worker processes share the geometry and physics tables of the");
+  nProcessesCmd->SetGuidance("master process copy-on-write.");
+  nProcessesCmd->SetGuidance("This command is valid only for G4ForkRunManager.");
+  nProcessesCmd->SetGuidance("The command is ignored for other run managers.");
+  nProcessesCmd->SetParameterName("nProcesses",true);
+  nProcessesCmd->SetDefaultValue(2);
+  nProcessesCmd->SetRange("nProcesses >0");
+  nProcessesCmd->SetToBeBroadcasted(false);
+  nProcessesCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  checkpointCmd = new G4UIcommand("/run/checkpoint",this);
+  checkpointCmd->SetGuidance("Write the state of the current run to a file every N events,");
+  checkpointCmd->SetGuidance("so that the run can be resumed with /run/resume if the job is killed.");
+  checkpointCmd->SetGuidance("The file contains the IDs of the completed events, the run object,");
+  checkpointCmd->SetGuidance("the command-based scores and the status of the random number engine.");
+  checkpointCmd->SetGuidance("In multi-threaded mode each worker thread writes <fileName>.t<threadID>.");
+  checkpointCmd->SetGuidance("N = 0 disables checkpointing.");
+  G4UIparameter* ckp1 = new G4UIparameter("fileName",'s',false);
+  checkpointCmd->SetParameter(ckp1);
+  G4UIparameter* ckp2 = new G4UIparameter("N",'i',true);
+  ckp2->SetDefaultValue(100);
+  ckp2->SetParameterRange("N >= 0");
+  checkpointCmd->SetParameter(ckp2);
+  checkpointCmd->SetToBeBroadcasted(false);
+  checkpointCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  resumeCmd = new G4UIcmdWithAString("/run/resume",this);
+  resumeCmd->SetGuidance("The next run is resumed from the given checkpoint file.");
+  resumeCmd->SetGuidance("The results stored in the file are merged to the run and the");
+  resumeCmd->SetGuidance("completed events are not simulated again. The number of events");
+  resumeCmd->SetGuidance("given to /run/beamOn must be the same as for the original run.");
+  resumeCmd->SetGuidance("If the file does not exist, the run starts from the first event.");
+  resumeCmd->SetParameterName("fileName",false);
+  resumeCmd->SetToBeBroadcasted(false);
+  resumeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
   dumpRegCmd = new G4UIcmdWithAString("/run/dumpRegion",this);
   dumpRegCmd->SetGuidance("Dump region information.");
   dumpRegCmd->SetGuidance("In case name of a region is not given, all regions will be displayed.");
@@ -310,6 +389,41 @@ G4RunMessenger::G4RunMessenger(G4RunManager * runMgr)
   saveEachEventCmd->SetGuidance("File name contains run and event numbers: runXXXevtYYY.rndm");
   saveEachEventCmd->SetParameterName("flag",true);
   saveEachEventCmd->SetDefaultValue(true);
+
+  evtStreamCmd = new G4UIcommand("/random/eventStreams",this);
+  evtStreamCmd->SetGuidance("Use a random stream of a counter-based engine (Philox) for each event.");
+  evtStreamCmd->SetGuidance("The stream of an event is derived only from the seed, the run ID");
+  evtStreamCmd->SetGuidance("and the event ID, thus it does not depend on the number of threads");
+  evtStreamCmd->SetGuidance("nor on the thread processing the event, and no seed is generated");
+  evtStreamCmd->SetGuidance("by the master thread at the beginning of the run.");
+  evtStreamCmd->SetGuidance("The engine of each thread is replaced by the counter-based engine");
+  evtStreamCmd->SetGuidance("during the event loop. The seed is not that of /random/setSeeds.");
+  evtStreamCmd->SetGuidance("If the seed is 0 (default), it is drawn from the current engine.");
+  evtStreamCmd->SetGuidance("The seed in use is printed at the beginning of each run.");
+  G4UIparameter* esp1 = new G4UIparameter("flag",'b',true);
+  esp1->SetDefaultValue(true);
+  evtStreamCmd->SetParameter(esp1);
+  G4UIparameter* esp2 = new G4UIparameter("seed",'i',true);
+  esp2->SetDefaultValue(0);
+  esp2->SetParameterRange("seed >= 0");
+  evtStreamCmd->SetParameter(esp2);
+  evtStreamCmd->SetToBeBroadcasted(false);
+  evtStreamCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  replayStreamCmd = new G4UIcommand("/random/replayEventStream",this);
+  replayStreamCmd->SetGuidance("The next run uses the random stream of the given run ID and");
+  replayStreamCmd->SetGuidance("event ID for its first event, the stream of the next event ID for");
+  replayStreamCmd->SetGuidance("its second event, and so on. With the seed of the original job,");
+  replayStreamCmd->SetGuidance("this reproduces these events in isolation, e.g. with /run/beamOn 1.");
+  replayStreamCmd->SetGuidance("This command is valid only if /random/eventStreams is set.");
+  G4UIparameter* rsp1 = new G4UIparameter("runID",'i',false);
+  rsp1->SetParameterRange("runID >= 0");
+  replayStreamCmd->SetParameter(rsp1);
+  G4UIparameter* rsp2 = new G4UIparameter("eventID",'i',false);
+  rsp2->SetParameterRange("eventID >= 0");
+  replayStreamCmd->SetParameter(rsp2);
+  replayStreamCmd->SetToBeBroadcasted(false);
+  replayStreamCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
   
   randEvtCmd = new G4UIcmdWithAnInteger("/run/storeRndmStatToEvent",this);
   randEvtCmd->SetGuidance("Flag to store rndm status to G4Event object.");
@@ -335,6 +449,11 @@ G4RunMessenger::~G4RunMessenger()
   delete nThreadsCmd;
   delete maxThreadsCmd;
   delete evModCmd;
+  delete workStealCmd;
+  delete nProcessesCmd;
+  delete checkpointCmd;
+  delete resumeCmd;
+  delete affinityPolicyCmd;
   delete optCmd;
   delete dumpRegCmd;
   delete dumpCoupleCmd;
@@ -356,6 +475,8 @@ G4RunMessenger::~G4RunMessenger()
   delete restoreRandCmd;
   delete randomDirectory;
   delete saveEachEventCmd;
+  delete evtStreamCmd;
+  delete replayStreamCmd;
     
   delete randDirCmd;
   delete runDirectory;
@@ -439,6 +560,34 @@ void G4RunMessenger::SetNewValue(G4UIcommand * command,G4String newValue)
     }
 
   }
+  else if ( command == affinityPolicyCmd )
+  {
+    G4RunManager::RMType rmType = runManager->GetRunManagerType();
+    if( rmType==G4RunManager::masterRM )
+    {
+      std::istringstream is(newValue);
+      G4String policyName;
+      is >> policyName;
+      G4MTRunManager::AffinityPolicy policy = G4MTRunManager::noAffinityPolicy;
+      if ( policyName == "compact" ) policy = G4MTRunManager::compactAffinity;
+      else if ( policyName == "scatter" ) policy = G4MTRunManager::scatterAffinity;
+      else if ( policyName == "explicit" ) policy = G4MTRunManager::explicitAffinity;
+      std::vector<G4int> cpus;
+      G4int cpu;
+      while ( is >> cpu ) cpus.push_back(cpu);
+      static_cast<G4MTRunManager*>(runManager)->SetAffinityPolicy(policy,cpus);
+    }
+    else if ( rmType==G4RunManager::sequentialRM )
+    {
+      G4cout<<"*** /run/affinityPolicy command is issued in sequential mode."
+            <<"\nCommand is ignored."<<G4endl;
+    }
+    else
+    {
+      G4Exception("G4RunMessenger::ApplyNewCommand","Run0901",FatalException,
+      "/run/affinityPolicy command is issued to local thread.");
+    }
+  }
   else if( command==evModCmd)
   {
     G4RunManager::RMType rmType = runManager->GetRunManagerType();
@@ -463,6 +612,45 @@ void G4RunMessenger::SetNewValue(G4UIcommand * command,G4String newValue)
       "/run/eventModulo command is issued to local thread.");
     }
   }
+  else if( command==workStealCmd)
+  {
+    G4RunManager::RMType rmType = runManager->GetRunManagerType();
+    if( rmType==G4RunManager::masterRM )
+    {
+      static_cast<G4MTRunManager*>(runManager)->SetWorkStealing(
+       workStealCmd->GetNewBoolValue(newValue));
+    }
+    else if ( rmType==G4RunManager::sequentialRM )
+    {
+      G4cout<<"*** /run/workStealing command is issued in sequential mode."
+            <<"\nCommand is ignored."<<G4endl;
+    }
+    else
+    {
+      G4Exception("G4RunMessenger::ApplyNewCommand","Run0902",FatalException,
+      "/run/workStealing command is issued to local thread.");
+    }
+  }
+  else if( command==nProcessesCmd )
+  {
+    G4ForkRunManager* frm = G4ForkRunManager::GetForkRunManager();
+    if( frm )
+    { frm->SetNumberOfProcesses(nProcessesCmd->GetNewIntValue(newValue)); }
+    else
+    {
+      G4cout<<"*** /run/numberOfProcesses command is valid only for G4ForkRunManager."
+            <<"\nCommand is ignored."<<G4endl;
+    }
+  }
+  else if( command==checkpointCmd )
+  {
+    G4Tokenizer next(newValue);
+    G4String fileName = next();
+    G4int interval = StoI(next());
+    runManager->SetCheckpoint(fileName,interval);
+  }
+  else if( command==resumeCmd )
+  { runManager->ResumeFromCheckpoint(newValue); }
   else if( command==dumpRegCmd )
   { 
     if(newValue=="**ALL**")
@@ -526,6 +714,24 @@ void G4RunMessenger::SetNewValue(G4UIcommand * command,G4String newValue)
   { runManager->ConstructScoringWorlds(); }
   else if( command==restoreRandCmdMT)
   { runManager->RestoreRndmEachEvent(restoreRandCmdMT->GetNewBoolValue(newValue)); }
+  else if( command==evtStreamCmd)
+  {
+    G4String flag;
+    G4long seed = 0;
+    const char* nv = (const char*)newValue;
+    std::istringstream is(nv);
+    is >> flag >> seed;
+    runManager->SetEventRandomStreams(G4UIcommand::ConvertToBool(flag),seed);
+  }
+  else if( command==replayStreamCmd)
+  {
+    G4int runID = 0;
+    G4int eventID = 0;
+    const char* nv = (const char*)newValue;
+    std::istringstream is(nv);
+    is >> runID >> eventID;
+    runManager->ReplayEventRandomStream(runID,eventID);
+  }
 }
 
 G4String G4RunMessenger::GetCurrentValue(G4UIcommand * command)
@@ -565,6 +771,38 @@ G4String G4RunMessenger::GetCurrentValue(G4UIcommand * command)
     else if ( rmType==G4RunManager::sequentialRM )
     { G4cout<<"*** /run/eventModulo command is valid only in MT mode."<<G4endl; }
   }
+  else if( command==workStealCmd)
+  {
+    G4RunManager::RMType rmType = runManager->GetRunManagerType();
+    if( rmType==G4RunManager::masterRM )
+    {
+      cv = workStealCmd->ConvertToString(
+       static_cast<G4MTRunManager*>(runManager)->IsWorkStealing());
+    }
+    else if ( rmType==G4RunManager::sequentialRM )
+    { cv = "0"; }
+  }
+  else if( command==evtStreamCmd )
+  {
+    std::ostringstream os;
+    os << evtStreamCmd->ConvertToString(runManager->UseEventRandomStreams())
+       << " " << runManager->GetEventRandomStreamSeed();
+    cv = os.str();
+  }
+  else if( command==nProcessesCmd )
+  {
+    G4ForkRunManager* frm = G4ForkRunManager::GetForkRunManager();
+    if( frm )
+    { cv = nProcessesCmd->ConvertToString(frm->GetNumberOfProcesses()); }
+    else
+    { cv = "0"; }
+  }
+  else if( command==checkpointCmd )
+  {
+    std::ostringstream os;
+    os << runManager->GetCheckpointFile() << " " << runManager->GetCheckpointInterval();
+    cv = os.str();
+  }
   
   return cv;
 }
@@ -0,0 +1,168 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+
+#include "G4WorkStealingEventQueue.hh"
+#include "G4AutoLock.hh"
+
+G4WorkStealingEventQueue::EventQueue::EventQueue()
+  : nDispatched(0), nSteals(0)
+{
+  G4MUTEXINIT(mutex);
+}
+
+G4WorkStealingEventQueue::EventQueue::~EventQueue()
+{
+  G4MUTEXDESTROY(mutex);
+}
+
+G4WorkStealingEventQueue::G4WorkStealingEventQueue()
+{
+}
+
+G4WorkStealingEventQueue::~G4WorkStealingEventQueue()
+{
+  for(size_t i=0;i<queues.size();i++) delete queues[i];
+  queues.clear();
+}
+
+void G4WorkStealingEventQueue::Reset(G4int nQueues)
+{
+  if(nQueues<1) nQueues = 1;
+  while(G4int(queues.size())<nQueues) queues.push_back(new EventQueue);
+  while(G4int(queues.size())>nQueues)
+  {
+    delete queues.back();
+    queues.pop_back();
+  }
+  for(size_t iq=0;iq<queues.size();iq++)
+  {
+    EventQueue* q = queues[iq];
+    G4AutoLock l(&(q->mutex));
+    q->events.clear();
+    q->nDispatched = 0;
+    q->nSteals = 0;
+  }
+}
+
+void G4WorkStealingEventQueue::Fill(G4int firstEvent, G4int nEvents,
+                                    const G4long* seeds, G4int nSeedsPerEvent)
+{
+  // Contiguous blocks keep consecutive event IDs on the same thread as
+  // long as no stealing is needed.
+  G4int nQueues = queues.size();
+  for(G4int iq=0;iq<nQueues;iq++)
+  {
+    EventQueue* q = queues[iq];
+    G4AutoLock l(&(q->mutex));
+    G4int first = G4int((G4long(nEvents)*iq)/nQueues);
+    G4int last  = G4int((G4long(nEvents)*(iq+1))/nQueues);
+    for(G4int i=first;i<last;i++)
+    {
+      QueuedEvent qev;
+      qev.eventID = firstEvent+i;
+      for(G4int j=0;j<3;j++)
+      { qev.seeds[j] = (seeds && j<nSeedsPerEvent) ? seeds[nSeedsPerEvent*i+j] : 0; }
+      q->events.push_back(qev);
+    }
+  }
+}
+
+G4bool G4WorkStealingEventQueue::NextEvent(G4int queueId, G4int& eventID,
+                                           long seeds[3])
+{
+  if(queueId<0 || queueId>=G4int(queues.size())) return false;
+  EventQueue* own = queues[queueId];
+  do
+  {
+    G4AutoLock l(&(own->mutex));
+    if(!own->events.empty())
+    {
+      const QueuedEvent& qev = own->events.front();
+      eventID = qev.eventID;
+      for(G4int j=0;j<3;j++) seeds[j] = qev.seeds[j];
+      own->events.pop_front();
+      own->nDispatched++;
+      return true;
+    }
+  }
+  while(Steal(queueId));
+  return false;
+}
+
+G4bool G4WorkStealingEventQueue::Steal(G4int thiefId)
+{
+  // Visit the other queues in round robin starting from the next one,
+  // so that thieves do not all target the same victim.
+  G4int nQueues = queues.size();
+  std::vector<QueuedEvent> loot;
+  for(G4int i=1;i<nQueues;i++)
+  {
+    EventQueue* victim = queues[(thiefId+i)%nQueues];
+    G4AutoLock lv(&(victim->mutex));
+    size_t nAvail = victim->events.size();
+    if(nAvail==0) continue;
+    size_t nTake = (nAvail+1)/2;
+    for(size_t j=0;j<nTake;j++)
+    {
+      loot.push_back(victim->events.back());
+      victim->events.pop_back();
+    }
+    break;
+  }
+  if(loot.empty()) return false;
+
+  EventQueue* own = queues[thiefId];
+  G4AutoLock l(&(own->mutex));
+  // loot is in reversed order: restore ascending event IDs
+  for(size_t j=0;j<loot.size();j++) own->events.push_front(loot[j]);
+  own->nSteals++;
+  return true;
+}
+
+void G4WorkStealingEventQueue::Clear()
+{
+  for(size_t i=0;i<queues.size();i++)
+  {
+    G4AutoLock l(&(queues[i]->mutex));
+    queues[i]->events.clear();
+  }
+}
+
+G4int G4WorkStealingEventQueue::GetNumberOfDispatchedEvents() const
+{
+  G4int n = 0;
+  for(size_t i=0;i<queues.size();i++) n += queues[i]->nDispatched;
+  return n;
+}
+
+G4int G4WorkStealingEventQueue::GetNumberOfSteals() const
+{
+  G4int n = 0;
+  for(size_t i=0;i<queues.size();i++) n += queues[i]->nSteals;
+  return n;
+}
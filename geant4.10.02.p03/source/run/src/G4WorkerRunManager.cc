@@ -46,6 +46,7 @@
 #include "G4SDManager.hh"
 #include "G4VScoringMesh.hh"
 #include "G4Timer.hh"
+#include "G4SubEventQueue.hh"
 #include <sstream>
 #include <fstream>
 
@@ -145,6 +146,8 @@ void G4WorkerRunManager::RunInitialization()
 #endif
 
   if(!(kernel->RunInitialization(fakeRun))) return;
+  CopyEventRandomStreams(G4MTRunManager::GetMasterRunManager());
+  CopyCheckpointSettings(G4MTRunManager::GetMasterRunManager());
 
   //Signal this thread can start event loop.
   //Note this will return only when all threads reach this point
@@ -241,6 +244,13 @@ void G4WorkerRunManager::DoEventLoop(G4int n_event, const char* macroFile , G4in
 //////        }
       }
     }
+
+    // Help other threads transporting their events (sub-event parallelism)
+    // until the last worker thread has finished its event loop
+    G4SubEventQueue* subEventQueue = G4SubEventQueue::GetInstance();
+    subEventQueue->LeaveEventLoop();
+    if(!runAborted && subEventQueue->IsEnabled())
+    { eventManager->ProcessSubEvents(); }
      
     TerminateEventLoop();
 }
@@ -248,6 +258,13 @@ void G4WorkerRunManager::DoEventLoop(G4int n_event, const char* macroFile , G4in
 void G4WorkerRunManager::ProcessOneEvent(G4int i_event)
 {
   currentEvent = GenerateEvent(i_event);
+  // Events completed before the restart from a checkpoint are skipped.
+  // Their seeds are consumed as if they were processed.
+  while(eventLoopOnGoing && IsEventCompleted(currentEvent->GetEventID()))
+  {
+    delete currentEvent;
+    currentEvent = GenerateEvent(i_event);
+  }
   if(eventLoopOnGoing)
   {  
     eventManager->ProcessOneEvent(currentEvent);
@@ -266,11 +283,22 @@ G4Event* G4WorkerRunManager::GenerateEvent(G4int i_event)
   G4bool eventHasToBeSeeded = true;
   if(G4MTRunManager::SeedOncePerCommunication()==1 && runIsSeeded)
   { eventHasToBeSeeded = false; }
+  // The random stream of the event is given by the event ID
+  if(eventRandomStreams)
+  { eventHasToBeSeeded = false; }
 
   if(i_event<0)
   {
-    G4int nevM = G4MTRunManager::GetMasterRunManager()->GetEventModulo();
-    if(nevM==1)
+    G4MTRunManager* mrm = G4MTRunManager::GetMasterRunManager();
+    G4int nevM = mrm->GetEventModulo();
+    if(mrm->IsWorkStealing())
+    {
+      // Every event carries its own pre-assigned seeds
+      eventHasToBeSeeded = !eventRandomStreams;
+      eventLoopOnGoing = mrm->SetUpAnEventFromQueue(anEvent,
+                           workerContext->GetThreadId(),s1,s2,s3);
+    }
+    else if(nevM==1)
     {
       eventLoopOnGoing = G4MTRunManager::GetMasterRunManager()
                        ->SetUpAnEvent(anEvent,s1,s2,s3,eventHasToBeSeeded);
@@ -324,6 +352,8 @@ G4Event* G4WorkerRunManager::GenerateEvent(G4int i_event)
     runIsSeeded = true;
 ////G4cout<<"Event "<<currEvID<<" is seeded with { "<<s1<<", "<<s2<<" }"<<G4endl;
   }
+  else if(eventRandomStreams)
+  { SetUpEventRandomStream(anEvent->GetEventID()); }
 
   //Read from file seed.
   //Andrea Dotti 4 November 2015
@@ -409,6 +439,7 @@ void G4WorkerRunManager::RunTermination()
 
 void G4WorkerRunManager::TerminateEventLoop()
 {
+    EndEventRandomStreams();
     if(verboseLevel>0 && !fakeRun)
     {
         timer->Stop();
@@ -227,15 +227,27 @@ void G4WorkerThread::SetPinAffinity(G4int affinity) const
       cpuindex = myidx + (myidx>=offset);
   }
   G4cout<<"Setting affinity to:"<<cpuindex<<G4endl;
+  PinToCPU(cpuindex);
+#endif
+}
+
+void G4WorkerThread::PinToCPU(G4int cpu) const
+{
+  if ( cpu < 0 || cpu >= G4Threading::G4GetNumberOfCores() ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot set thread affinity of thread " << GetThreadId()
+          << " to CPU " << cpu << ", no such logical CPU.";
+      G4Exception("G4WorkerThread::PinToCPU","Run0035",JustWarning,msg);
+      return;
+  }
   //Avoid compilation warning in C90 standard w/o MT
 #if defined(G4MULTITHREADED)
   G4Thread t = G4THREADSELF();
 #else
   G4Thread t;
 #endif
-  G4bool success = G4Threading::G4SetPinAffinity(cpuindex,t);
+  G4bool success = G4Threading::G4SetPinAffinity(cpu,t);
   if ( ! success ) {
       G4Exception("G4MTRunManagerKernel::StarThread","Run0035",JustWarning,"Cannot set thread affinity.");
   }
-#endif
 }
@@ -0,0 +1,157 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4CompactTrajectory.hh
+//
+// class description:
+//   This class represents the trajectory of a particle with a small
+//   memory footprint, for storing the trajectories of large events.
+//   It is made from another trajectory once the track is completed
+//   (see G4TrajectoryStore):
+//     1) the points, including the auxiliary points of smooth and
+//        rich trajectories, are reduced with the Douglas-Peucker
+//        algorithm: a point is removed if the polyline passes within
+//        the given tolerance of it,
+//     2) the remaining positions are stored as integer multiples of
+//        the given quantum relative to the first point (12 bytes per
+//        point instead of a G4TrajectoryPoint object).
+//   Only the static information of the particle and of the track is
+//   kept, as for G4Trajectory. G4TrajectoryPoint objects are created
+//   on the first call to GetPoint() (e.g. for drawing) and kept until
+//   the trajectory is deleted.
+//
+// ---------------------------------------------------------------
+
+#ifndef G4CompactTrajectory_h
+#define G4CompactTrajectory_h 1
+
+#include <vector>
+
+#include "trkgdefs.hh"
+#include "G4VTrajectory.hh"
+#include "G4Allocator.hh"
+#include "G4ios.hh"
+#include "globals.hh"
+#include "G4TrajectoryPoint.hh"
+
+class G4CompactTrajectory : public G4VTrajectory
+{
+  public: // with description
+
+    G4CompactTrajectory(const G4VTrajectory& source,
+                        G4double tolerance, G4double quantum);
+    //  Compacts the points of source, which is left unchanged.
+    G4CompactTrajectory(G4int trackID, G4int parentID,
+                        const G4String& particleName, G4int pdgEncoding,
+                        G4double charge, const G4ThreeVector& initialMomentum,
+                        const G4ThreeVector& origin, G4double quantum,
+                        const std::vector<G4int>& quantisedPoints);
+    //  Restores a trajectory with already quantised points, e.g. from
+    // a file written by G4TrajectoryStore.
+    virtual ~G4CompactTrajectory();
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+    inline int operator == (const G4CompactTrajectory& right) const
+    { return (this==&right); }
+
+    inline G4int GetTrackID() const
+    { return fTrackID; }
+    inline G4int GetParentID() const
+    { return fParentID; }
+    inline G4String GetParticleName() const
+    { return ParticleName; }
+    inline G4double GetCharge() const
+    { return PDGCharge; }
+    inline G4int GetPDGEncoding() const
+    { return PDGEncoding; }
+    inline G4ThreeVector GetInitialMomentum() const
+    { return initialMomentum; }
+
+    inline const G4ThreeVector& GetOrigin() const
+    { return origin; }
+    inline G4double GetQuantum() const
+    { return quantum; }
+    inline const std::vector<G4int>& GetQuantisedPoints() const
+    { return points; }
+    //  Three integers (x, y and z) per point, relative to GetOrigin()
+    // in units of GetQuantum()
+    inline G4ThreeVector GetPosition(G4int i) const
+    { return origin + quantum*G4ThreeVector(points[3*i],points[3*i+1],points[3*i+2]); }
+    inline G4bool IsClamped() const
+    { return clamped; }
+    //  True if some points were beyond the range of the quantisation
+    size_t GetMemorySize() const;
+    //  Approximate heap and object size in bytes (without point cache)
+
+    virtual void ShowTrajectory(std::ostream& os=G4cout) const;
+    virtual void DrawTrajectory() const;
+    virtual void AppendStep(const G4Step* aStep);
+    virtual int GetPointEntries() const
+    { return points.size()/3; }
+    virtual G4VTrajectoryPoint* GetPoint(G4int i) const;
+    virtual void MergeTrajectory(G4VTrajectory* secondTrajectory);
+
+    virtual const std::map<G4String,G4AttDef>* GetAttDefs() const;
+    virtual std::vector<G4AttValue>* CreateAttValues() const;
+
+  private:
+    void AddPoint(const G4ThreeVector& position);
+    void ClearCache();
+
+  private:
+    std::vector<G4int> points;
+    mutable std::vector<G4TrajectoryPoint*>* pointCache;
+    G4ThreeVector origin;
+    G4double quantum;
+    G4bool clamped;
+    G4int fTrackID;
+    G4int fParentID;
+    G4int PDGEncoding;
+    G4double PDGCharge;
+    G4String ParticleName;
+    G4ThreeVector initialMomentum;
+};
+
+extern G4TRACKING_DLL G4ThreadLocal
+G4Allocator<G4CompactTrajectory> *aCompactTrajectoryAllocator;
+
+inline void* G4CompactTrajectory::operator new(size_t)
+{
+  if (!aCompactTrajectoryAllocator)
+  { aCompactTrajectoryAllocator = new G4Allocator<G4CompactTrajectory>; }
+  return (void*)aCompactTrajectoryAllocator->MallocSingle();
+}
+
+inline void G4CompactTrajectory::operator delete(void* aTrajectory)
+{
+  aCompactTrajectoryAllocator->FreeSingle((G4CompactTrajectory*)aTrajectory);
+}
+
+#endif
@@ -0,0 +1,97 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4ProcessDispatchTable.hh
+//
+// class description:
+//  This class holds, for the G4ProcessManager of one particle type,
+//  contiguous copies of the six GetPhysicalInteractionLength and DoIt
+//  process vectors in which the inactivated processes (null entries)
+//  are removed. Each entry keeps the index of the process in the
+//  original vector, which is the index used by the selection vectors
+//  and by G4SteppingVerbose. G4SteppingManager walks these tables in
+//  its step loop instead of the G4ProcessVector objects.
+//  A table is valid as long as the revision number of the process
+//  manager is unchanged, i.e. until a process is added, removed,
+//  activated or inactivated. G4SteppingManager checks it at each step
+//  and rebuilds the table when needed.
+//
+//---------------------------------------------------------------
+
+#ifndef G4ProcessDispatchTable_h
+#define G4ProcessDispatchTable_h 1
+
+#include "globals.hh"
+#include "G4ProcessManager.hh"
+#include <vector>
+
+class G4VProcess;
+
+class G4ProcessDispatchTable
+{
+  public:
+    struct Entry
+    {
+      G4VProcess* process;
+      size_t index;
+    };
+    typedef std::vector<Entry> G4DispatchVector;
+
+  public: // with description
+    explicit G4ProcessDispatchTable(const G4ProcessManager* aProcessManager);
+    ~G4ProcessDispatchTable() {}
+
+    void Build();
+    // (Re)builds the table from the process vectors of the process manager
+
+    inline G4bool IsUpToDate() const
+    { return revision == processManager->GetProcessVectorRevision(); }
+
+    inline const G4DispatchVector& GetAtRestGPIL() const
+    { return dispatch[0]; }
+    inline const G4DispatchVector& GetAtRestDoIt() const
+    { return dispatch[1]; }
+    inline const G4DispatchVector& GetAlongStepGPIL() const
+    { return dispatch[2]; }
+    inline const G4DispatchVector& GetAlongStepDoIt() const
+    { return dispatch[3]; }
+    inline const G4DispatchVector& GetPostStepGPIL() const
+    { return dispatch[4]; }
+    inline const G4DispatchVector& GetPostStepDoIt() const
+    { return dispatch[5]; }
+    // Active processes in the order of the corresponding G4ProcessVector
+
+  private:
+    const G4ProcessManager* processManager;
+    G4int revision;
+    G4DispatchVector dispatch[G4ProcessManager::SizeOfProcVectorArray];
+};
+
+#endif
@@ -0,0 +1,218 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4StepTraceWriter.hh
+//
+// class description:
+//  This class writes a binary trace of the steps, one fixed-size
+//  G4StepTraceRecord per step, for offline analysis and for comparing
+//  the tracking of two builds. It is filled by G4TrackingManager when
+//  the trace is enabled with /tracking/trace/file.
+//  Each thread owns its own instance and file (the name is suffixed by
+//  ".t<thread ID>" in multi-threaded mode) and buffers the records in
+//  memory; the buffer is written when it is full. The settings below are
+//  set by the master thread in Idle state; the instance of a thread is
+//  created at the first traced track of a run with a copy of them, and
+//  deleted at the end of the run, which closes the file. The following
+//  runs append to the file until a file name is given again.
+//  Steps may be selected by particle name, by name of the physical
+//  volume of the pre-step point and by a range of event IDs.
+//  The process and volume IDs of the records refer to name records,
+//  written to the file the first time an ID is used. The file layout
+//  and the reading are implemented by G4StepTraceReader.
+//
+//---------------------------------------------------------------
+
+#ifndef G4StepTraceWriter_h
+#define G4StepTraceWriter_h 1
+
+#include "globals.hh"
+#include <fstream>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4Track;
+class G4ParticleDefinition;
+class G4VPhysicalVolume;
+class G4VProcess;
+
+struct G4StepTraceRecord
+{
+  // Step records have eventID >= 0
+  G4int eventID;
+  G4int trackID;
+  G4int parentID;
+  G4int stepNumber;
+  G4int pdgCode;
+  G4int processID;   // -1 if no process defined the step
+  G4int volumeID;    // physical volume of the pre-step point
+  G4int copyNo;
+  G4double prePosition[3];
+  G4double preGlobalTime;
+  G4double preKineticEnergy;
+  G4double postPosition[3];
+  G4double postGlobalTime;
+  G4double postKineticEnergy;
+  G4double energyDeposit;
+  G4double stepLength;
+};
+
+struct G4StepTraceName
+{
+  // Name records have marker == kNameMarker and share the size of
+  // G4StepTraceRecord
+  enum { kProcess = 0, kVolume = 1, kNameMarker = -1,
+         kMaxLength = sizeof(G4StepTraceRecord) - 4*sizeof(G4int) };
+  G4int marker;
+  G4int kind;
+  G4int id;
+  G4int length;
+  char name[kMaxLength];
+};
+
+struct G4StepTraceHeader
+{
+  char magic[8];        // "G4STRACE"
+  G4int version;
+  G4int recordSize;
+  G4int byteOrder;      // 0x01020304 as written by the producer
+  G4int threadID;       // -1 in sequential mode or for the master
+};
+
+class G4StepTraceWriter
+{
+  public: // with description
+    static G4StepTraceWriter* GetInstance();
+    //  Instance of the calling thread
+    static G4StepTraceWriter* GetInstanceIfExist();
+
+    static void SetFileName(const G4String& fileName);
+    //  Base name of the trace files. The trace is disabled if empty.
+    static inline G4bool IsEnabled()
+    { return enabled; }
+    static const G4String& GetFileName();
+
+    static void AddParticle(const G4String& particleName);
+    static void AddVolume(const G4String& physicalVolumeName);
+    static void ClearFilters();
+    //  Steps are written if the particle and the pre-step volume are
+    // selected. No selection means all particles (volumes).
+    static void SetEventRange(G4int firstEvent, G4int lastEvent);
+    //  lastEvent < 0 means no upper limit
+    static void SetBufferSize(G4int nRecords);
+
+    static inline void SetCurrentEventID(G4int id)
+    { currentEventID = id; }
+    static inline G4int GetCurrentEventID()
+    { return currentEventID; }
+    //  Set by G4EventManager for the calling thread
+
+    static void EndOfRun();
+    //  Deletes the instance of the calling thread, if any
+
+  public:
+    G4bool AcceptTrack(const G4Track* track);
+    //  Track-level selection (particle and event range), to be checked
+    // before the steps of the track are passed to Write()
+    void Write(const G4Step* step, const G4Track* track);
+    void Flush();
+    void Close();
+
+  private:
+    G4StepTraceWriter();
+    ~G4StepTraceWriter();
+    G4bool Open();
+    G4int ProcessID(const G4VProcess* process);
+    G4int VolumeID(const G4VPhysicalVolume* volume);
+    void WriteName(G4int kind, G4int id, const G4String& name);
+
+  private:
+    std::ofstream file;
+    std::vector<G4StepTraceRecord> buffer;
+    std::unordered_map<const G4VProcess*,G4int> processIDs;
+    std::unordered_map<const G4VPhysicalVolume*,G4int> volumeIDs;
+    std::unordered_map<const G4ParticleDefinition*,G4bool> particleSelection;
+    std::unordered_map<const G4VPhysicalVolume*,G4bool> volumeSelection;
+
+    // Copy of the settings for the current run
+    G4String threadFileName;
+    G4int threadFileRevision;
+    std::set<G4String> threadParticleNames;
+    std::set<G4String> threadVolumeNames;
+    G4int threadFirstEventID;
+    G4int threadLastEventID;
+    G4int threadBufferSize;
+
+    static G4bool enabled;
+    static G4String fileName;
+    static G4int fileRevision;
+    static std::set<G4String> particleNames;
+    static std::set<G4String> volumeNames;
+    static G4int firstEventID;
+    static G4int lastEventID;
+    static G4int bufferSize;
+    static G4ThreadLocal G4int currentEventID;
+};
+
+class G4StepTraceReader
+{
+  // Sequential reader of a file written by G4StepTraceWriter.
+  // Name records are consumed transparently.
+
+  public: // with description
+    G4StepTraceReader(const G4String& fileName);
+    ~G4StepTraceReader();
+
+    inline G4bool IsValid() const
+    { return valid; }
+    inline const G4StepTraceHeader& GetHeader() const
+    { return header; }
+
+    G4bool Next(G4StepTraceRecord& record);
+    //  Reads the next step record, returns false at the end of the file
+
+    const G4String& GetProcessName(G4int processID) const;
+    const G4String& GetVolumeName(G4int volumeID) const;
+    //  Names of the IDs met so far
+
+    static G4long Dump(const G4String& fileName, G4long maxRecords = -1);
+    //  Prints the records of the file in a text format and returns the
+    // number of step records
+
+  private:
+    std::ifstream file;
+    G4StepTraceHeader header;
+    G4bool valid;
+    std::vector<G4String> processNames;
+    std::vector<G4String> volumeNames;
+};
+
+#endif
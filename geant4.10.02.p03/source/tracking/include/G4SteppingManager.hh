@@ -58,6 +58,7 @@ class G4VSensitiveDetector;
 #include "G4ios.hh"                   // Include from 'system'
 #include <iomanip>              // Include from 'system'
 #include <vector>               // Include from 'system'
+#include <map>                  // Include from 'system'
 #include "globals.hh"                 // Include from 'global'
 #include "Randomize.hh"               // Include from 'global'
 
@@ -76,6 +77,7 @@ class G4VSensitiveDetector;
 #include "G4VSteppingVerbose.hh"      // Include from 'tracking'
 #include "G4TouchableHandle.hh"             // Include from 'geometry'
 #include "G4TouchableHistoryHandle.hh"      // Include from 'geometry'
+#include "G4ProcessDispatchTable.hh"  // Include from 'tracking'
 
 // 
    typedef std::vector<G4int> 
@@ -133,6 +135,12 @@ public: //without description
 
   void GetProcessNumber();
 
+  void BuildDispatchTables();
+     // Builds the process dispatch tables of all the particles which
+     // have a process manager. Invoked by G4RunManagerKernel at the
+     // beginning of each run. Tables of other process managers are
+     // built when the first track of the particle type is processed.
+
 // Get methods
    G4double GetPhysicalStep();
    G4double GetGeometricalStep();
@@ -201,6 +209,7 @@ public: //without description
    G4double CalculateSafety();
       // Return the estimated safety value at the PostStepPoint
    void ApplyProductionCut(G4Track*);
+   G4ProcessDispatchTable* GetDispatchTable(const G4ProcessManager*);
 
 // Member data 
    
@@ -247,6 +256,11 @@ public: //without description
    size_t MAXofAlongStepLoops;
    size_t MAXofPostStepLoops;
 
+   G4ProcessDispatchTable* fDispatchTable;
+      // Active processes of the current particle type, see
+      // G4ProcessDispatchTable
+   std::map<const G4ProcessManager*,G4ProcessDispatchTable*> fDispatchTables;
+
    size_t fAtRestDoItProcTriggered;
    size_t fAlongStepDoItProcTriggered;
    size_t fPostStepDoItProcTriggered;
@@ -0,0 +1,137 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4SteppingProfiler.hh
+//
+// class description:
+//  This class accumulates the wall-clock time and the number of calls
+//  spent in tracking, per particle type, per process limiting the step,
+//  per logical volume and per region. It is filled by G4TrackingManager
+//  when profiling is enabled with /tracking/profile/enable.
+//  Each thread fills its own instance without locking. At the end of a
+//  run the master (or sequential) run manager invokes Report(), which
+//  merges the instances of all threads by names, prints the most
+//  expensive entries sorted by time together with the totals per region,
+//  particle and process, optionally writes all entries to a CSV file,
+//  and resets the accumulators.
+//  The time of a step includes the user stepping action and the
+//  sensitive detectors. The time spent in a track outside of its steps
+//  (user tracking actions, trajectories, process StartTracking) is
+//  accounted with the "(tracking)" process and the logical volume of
+//  the track vertex.
+//
+//---------------------------------------------------------------
+
+#ifndef G4SteppingProfiler_h
+#define G4SteppingProfiler_h 1
+
+#include "globals.hh"
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+class G4ParticleDefinition;
+class G4VProcess;
+class G4LogicalVolume;
+
+class G4SteppingProfiler
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+  public: // with description
+    static G4SteppingProfiler* GetInstance();
+    //  Instance of the calling thread
+
+    static void SetEnabled(G4bool val);
+    static inline G4bool IsEnabled()
+    { return enabled; }
+    static void SetOutputFile(const G4String& fileName);
+    //  CSV file written by Report(). Nothing is written if empty.
+    static void SetReportSize(G4int n);
+    //  Number of entries printed by Report()
+
+    static void Report();
+    //  Merge the instances of all threads, print and write the result,
+    // then reset. Must be invoked while no thread is tracking.
+    static void Reset();
+
+  public:
+    inline void Add(const G4ParticleDefinition* particle,
+                    const G4VProcess* process,
+                    const G4LogicalVolume* volume,
+                    Clock::duration time);
+
+  private:
+    G4SteppingProfiler();
+
+    struct Key
+    {
+      const G4ParticleDefinition* particle;
+      const G4VProcess* process;
+      const G4LogicalVolume* volume;
+      inline G4bool operator==(const Key& right) const
+      { return particle==right.particle && process==right.process
+               && volume==right.volume; }
+    };
+    struct KeyHash
+    {
+      inline size_t operator()(const Key& k) const
+      {
+        size_t h = std::hash<const void*>()(k.particle);
+        h = h*31 + std::hash<const void*>()(k.process);
+        return h*31 + std::hash<const void*>()(k.volume);
+      }
+    };
+    struct Entry
+    {
+      Clock::duration time;
+      G4long calls;
+      Entry() : time(Clock::duration::zero()), calls(0) {}
+    };
+    std::unordered_map<Key,Entry,KeyHash> table;
+
+    static G4bool enabled;
+    static G4String outputFile;
+    static G4int reportSize;
+    static std::vector<G4SteppingProfiler*>* instances;
+};
+
+inline void G4SteppingProfiler::Add(const G4ParticleDefinition* particle,
+                                    const G4VProcess* process,
+                                    const G4LogicalVolume* volume,
+                                    Clock::duration time)
+{
+  Key key = { particle, process, volume };
+  Entry& entry = table[key];
+  entry.time += time;
+  ++(entry.calls);
+}
+
+#endif
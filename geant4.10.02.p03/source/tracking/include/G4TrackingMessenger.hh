@@ -49,6 +49,8 @@ class G4UIdirectory;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithAnInteger;
 class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcommand;
 class G4TrackingManager;
 class G4SteppingManager;
 #include "G4UImessenger.hh"
@@ -79,6 +81,19 @@ public: // without description
     G4UIcmdWithoutParameter *   ResumeCmd;
     G4UIcmdWithAnInteger *      StoreTrajectoryCmd;
     G4UIcmdWithAnInteger *      VerboseCmd;
+    G4UIdirectory *             ProfileDirectory;
+    G4UIcmdWithABool *          ProfileEnableCmd;
+    G4UIcmdWithAString *        ProfileOutputCmd;
+    G4UIcmdWithAnInteger *      ProfileSizeCmd;
+    G4UIcmdWithoutParameter *   ProfileReportCmd;
+    G4UIdirectory *             TraceDirectory;
+    G4UIcmdWithAString *        TraceFileCmd;
+    G4UIcmdWithAString *        TraceParticleCmd;
+    G4UIcmdWithAString *        TraceVolumeCmd;
+    G4UIcommand *               TraceEventRangeCmd;
+    G4UIcmdWithoutParameter *   TraceClearCmd;
+    G4UIcmdWithAnInteger *      TraceBufferCmd;
+    G4UIcommand *               TraceDumpCmd;
 
 };
 
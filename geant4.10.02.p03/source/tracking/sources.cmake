@@ -47,12 +47,16 @@ GEANT4_DEFINE_MODULE(NAME G4tracking
         G4AdjointCrossSurfChecker.hh
         G4AdjointSteppingAction.hh
         G4AdjointTrackingAction.hh
+        G4CompactTrajectory.hh
+        G4ProcessDispatchTable.hh
         G4RichTrajectory.hh
         G4RichTrajectoryPoint.hh
         G4SmoothTrajectory.hh
         G4SmoothTrajectoryPoint.hh
         G4SteppingManager.hh
+        G4SteppingProfiler.hh
         G4SteppingVerbose.hh
+        G4StepTraceWriter.hh
         G4TrackingManager.hh
         G4TrackingMessenger.hh
         G4Trajectory.hh
@@ -67,13 +71,17 @@ GEANT4_DEFINE_MODULE(NAME G4tracking
         G4AdjointCrossSurfChecker.cc
         G4AdjointSteppingAction.cc
         G4AdjointTrackingAction.cc
+        G4CompactTrajectory.cc
+        G4ProcessDispatchTable.cc
         G4RichTrajectory.cc
         G4RichTrajectoryPoint.cc
         G4SmoothTrajectory.cc
         G4SmoothTrajectoryPoint.cc
         G4SteppingManager.cc
         G4SteppingManager2.cc
+        G4SteppingProfiler.cc
         G4SteppingVerbose.cc
+        G4StepTraceWriter.cc
         G4TrackingManager.cc
         G4TrackingMessenger.cc
         G4Trajectory.cc
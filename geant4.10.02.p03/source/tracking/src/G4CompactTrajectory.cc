@@ -0,0 +1,283 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+// ---------------------------------------------------------------
+//
+// G4CompactTrajectory.cc
+//
+// ---------------------------------------------------------------
+
+#include "G4CompactTrajectory.hh"
+#include "G4Step.hh"
+#include "G4AttDefStore.hh"
+#include "G4AttDef.hh"
+#include "G4AttValue.hh"
+#include "G4UIcommand.hh"
+#include "G4UnitsTable.hh"
+#include <climits>
+#include <cmath>
+
+G4ThreadLocal G4Allocator<G4CompactTrajectory> *aCompactTrajectoryAllocator = 0;
+
+namespace
+{
+  // Distance of p to the segment [a,b]
+  G4double DistanceToSegment(const G4ThreeVector& p,
+                             const G4ThreeVector& a, const G4ThreeVector& b)
+  {
+    G4ThreeVector ab = b - a;
+    G4ThreeVector ap = p - a;
+    G4double len2 = ab.mag2();
+    if(len2<=0.) return ap.mag();
+    G4double t = ap.dot(ab)/len2;
+    if(t<0.) t = 0.;
+    else if(t>1.) t = 1.;
+    return (ap - t*ab).mag();
+  }
+
+  // Douglas-Peucker reduction: flags the points to be kept
+  void Reduce(const std::vector<G4ThreeVector>& pos, G4double tolerance,
+              std::vector<char>& keep)
+  {
+    size_t n = pos.size();
+    keep.assign(n,0);
+    if(n==0) return;
+    keep[0] = 1;
+    keep[n-1] = 1;
+    std::vector<std::pair<size_t,size_t> > ranges;
+    if(n>2) ranges.push_back(std::make_pair(size_t(0),n-1));
+    while(!ranges.empty()) // Loop checking 17.10.2026
+    {
+      size_t first = ranges.back().first;
+      size_t last = ranges.back().second;
+      ranges.pop_back();
+      G4double dMax = -1.;
+      size_t iMax = first;
+      for(size_t i=first+1;i<last;i++)
+      {
+        G4double d = DistanceToSegment(pos[i],pos[first],pos[last]);
+        if(d>dMax) { dMax = d; iMax = i; }
+      }
+      if(dMax>tolerance)
+      {
+        keep[iMax] = 1;
+        if(iMax-first>1) ranges.push_back(std::make_pair(first,iMax));
+        if(last-iMax>1) ranges.push_back(std::make_pair(iMax,last));
+      }
+    }
+  }
+}
+
+G4CompactTrajectory::G4CompactTrajectory(const G4VTrajectory& source,
+                                         G4double tol, G4double qnt)
+  : pointCache(0), quantum(qnt), clamped(false),
+    fTrackID(source.GetTrackID()), fParentID(source.GetParentID()),
+    PDGEncoding(source.GetPDGEncoding()), PDGCharge(source.GetCharge()),
+    ParticleName(source.GetParticleName()),
+    initialMomentum(source.GetInitialMomentum())
+{
+  // Auxiliary points lie between the previous point and the point
+  std::vector<G4ThreeVector> pos;
+  G4int n = source.GetPointEntries();
+  pos.reserve(n);
+  for(G4int i=0;i<n;i++)
+  {
+    const G4VTrajectoryPoint* point = source.GetPoint(i);
+    const std::vector<G4ThreeVector>* aux = point->GetAuxiliaryPoints();
+    if(aux) pos.insert(pos.end(),aux->begin(),aux->end());
+    pos.push_back(point->GetPosition());
+  }
+  if(pos.empty()) return;
+
+  std::vector<char> keep;
+  Reduce(pos,tol,keep);
+  size_t nKept = 0;
+  for(size_t i=0;i<keep.size();i++)
+  { if(keep[i]) ++nKept; }
+
+  origin = pos[0];
+  points.reserve(3*nKept);
+  for(size_t i=0;i<pos.size();i++)
+  { if(keep[i]) AddPoint(pos[i]); }
+}
+
+G4CompactTrajectory::G4CompactTrajectory(G4int trackID, G4int parentID,
+                        const G4String& particleName, G4int pdgEncoding,
+                        G4double charge, const G4ThreeVector& initialMom,
+                        const G4ThreeVector& org, G4double qnt,
+                        const std::vector<G4int>& quantisedPoints)
+  : points(quantisedPoints), pointCache(0), origin(org), quantum(qnt),
+    clamped(false), fTrackID(trackID), fParentID(parentID),
+    PDGEncoding(pdgEncoding), PDGCharge(charge), ParticleName(particleName),
+    initialMomentum(initialMom)
+{;}
+
+G4CompactTrajectory::~G4CompactTrajectory()
+{
+  ClearCache();
+}
+
+void G4CompactTrajectory::ClearCache()
+{
+  if(!pointCache) return;
+  for(size_t i=0;i<pointCache->size();i++)
+  { delete (*pointCache)[i]; }
+  delete pointCache;
+  pointCache = 0;
+}
+
+void G4CompactTrajectory::AddPoint(const G4ThreeVector& position)
+{
+  G4ThreeVector d = (position - origin)/quantum;
+  for(G4int k=0;k<3;k++)
+  {
+    G4double v = std::floor(d[k]+0.5);
+    if(v>G4double(INT_MAX)) { v = INT_MAX; clamped = true; }
+    else if(v<-G4double(INT_MAX)) { v = -INT_MAX; clamped = true; }
+    points.push_back(G4int(v));
+  }
+}
+
+size_t G4CompactTrajectory::GetMemorySize() const
+{
+  return sizeof(G4CompactTrajectory) + points.capacity()*sizeof(G4int)
+         + ParticleName.capacity();
+}
+
+G4VTrajectoryPoint* G4CompactTrajectory::GetPoint(G4int i) const
+{
+  if(!pointCache)
+  {
+    G4int n = GetPointEntries();
+    pointCache = new std::vector<G4TrajectoryPoint*>(n);
+    for(G4int j=0;j<n;j++)
+    { (*pointCache)[j] = new G4TrajectoryPoint(GetPosition(j)); }
+  }
+  return (*pointCache)[i];
+}
+
+void G4CompactTrajectory::ShowTrajectory(std::ostream& os) const
+{
+  G4VTrajectory::ShowTrajectory(os);
+}
+
+void G4CompactTrajectory::DrawTrajectory() const
+{
+  G4VTrajectory::DrawTrajectory();
+}
+
+void G4CompactTrajectory::AppendStep(const G4Step* aStep)
+{
+  ClearCache();
+  if(points.empty()) origin = aStep->GetPostStepPoint()->GetPosition();
+  AddPoint(aStep->GetPostStepPoint()->GetPosition());
+}
+
+void G4CompactTrajectory::MergeTrajectory(G4VTrajectory* secondTrajectory)
+{
+  if(!secondTrajectory) return;
+  ClearCache();
+  // Initial point of the second trajectory is not merged
+  G4int ent = secondTrajectory->GetPointEntries();
+  for(G4int i=1;i<ent;i++)
+  { AddPoint(secondTrajectory->GetPoint(i)->GetPosition()); }
+}
+
+const std::map<G4String,G4AttDef>* G4CompactTrajectory::GetAttDefs() const
+{
+  G4bool isNew;
+  std::map<G4String,G4AttDef>* store
+    = G4AttDefStore::GetInstance("G4CompactTrajectory",isNew);
+  if (isNew) {
+
+    G4String ID("ID");
+    (*store)[ID] = G4AttDef(ID,"Track ID","Physics","","G4int");
+
+    G4String PID("PID");
+    (*store)[PID] = G4AttDef(PID,"Parent ID","Physics","","G4int");
+
+    G4String PN("PN");
+    (*store)[PN] = G4AttDef(PN,"Particle Name","Physics","","G4String");
+
+    G4String Ch("Ch");
+    (*store)[Ch] = G4AttDef(Ch,"Charge","Physics","e+","G4double");
+
+    G4String PDG("PDG");
+    (*store)[PDG] = G4AttDef(PDG,"PDG Encoding","Physics","","G4int");
+
+    G4String IMom("IMom");
+    (*store)[IMom] = G4AttDef(IMom, "Initial momentum",
+                              "Physics","G4BestUnit","G4ThreeVector");
+
+    G4String IMag("IMag");
+    (*store)[IMag] =
+      G4AttDef(IMag, "Initial momentum magnitude",
+               "Physics","G4BestUnit","G4double");
+
+    G4String NTP("NTP");
+    (*store)[NTP] = G4AttDef(NTP,"No. of points","Physics","","G4int");
+
+    G4String Qnt("Qnt");
+    (*store)[Qnt] = G4AttDef(Qnt,"Position quantum","Physics",
+                             "G4BestUnit","G4double");
+
+  }
+  return store;
+}
+
+std::vector<G4AttValue>* G4CompactTrajectory::CreateAttValues() const
+{
+  std::vector<G4AttValue>* values = new std::vector<G4AttValue>;
+
+  values->push_back
+    (G4AttValue("ID",G4UIcommand::ConvertToString(fTrackID),""));
+
+  values->push_back
+    (G4AttValue("PID",G4UIcommand::ConvertToString(fParentID),""));
+
+  values->push_back(G4AttValue("PN",ParticleName,""));
+
+  values->push_back
+    (G4AttValue("Ch",G4UIcommand::ConvertToString(PDGCharge),""));
+
+  values->push_back
+    (G4AttValue("PDG",G4UIcommand::ConvertToString(PDGEncoding),""));
+
+  values->push_back
+    (G4AttValue("IMom",G4BestUnit(initialMomentum,"Energy"),""));
+
+  values->push_back
+    (G4AttValue("IMag",G4BestUnit(initialMomentum.mag(),"Energy"),""));
+
+  values->push_back
+    (G4AttValue("NTP",G4UIcommand::ConvertToString(GetPointEntries()),""));
+
+  values->push_back
+    (G4AttValue("Qnt",G4BestUnit(quantum,"Length"),""));
+
+  return values;
+}
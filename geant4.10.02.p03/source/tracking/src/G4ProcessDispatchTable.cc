@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4ProcessDispatchTable.cc
+//
+//---------------------------------------------------------------
+
+#include "G4ProcessDispatchTable.hh"
+#include "G4ProcessVector.hh"
+
+G4ProcessDispatchTable::
+G4ProcessDispatchTable(const G4ProcessManager* aProcessManager)
+  : processManager(aProcessManager), revision(-1)
+{
+  Build();
+}
+
+void G4ProcessDispatchTable::Build()
+{
+  G4ProcessVector* vectors[G4ProcessManager::SizeOfProcVectorArray] =
+  {
+    processManager->GetAtRestProcessVector(typeGPIL),
+    processManager->GetAtRestProcessVector(typeDoIt),
+    processManager->GetAlongStepProcessVector(typeGPIL),
+    processManager->GetAlongStepProcessVector(typeDoIt),
+    processManager->GetPostStepProcessVector(typeGPIL),
+    processManager->GetPostStepProcessVector(typeDoIt)
+  };
+
+  for(G4int i=0; i<G4ProcessManager::SizeOfProcVectorArray; i++)
+  {
+    G4DispatchVector& table = dispatch[i];
+    table.clear();
+    G4int n = vectors[i]->entries();
+    table.reserve(n);
+    for(G4int j=0; j<n; j++)
+    {
+      // A null entry is a process inactivated by the user
+      G4VProcess* aProcess = (*vectors[i])[j];
+      if(!aProcess) continue;
+      Entry anEntry;
+      anEntry.process = aProcess;
+      anEntry.index = j;
+      table.push_back(anEntry);
+    }
+  }
+  revision = processManager->GetProcessVectorRevision();
+}
@@ -0,0 +1,397 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4StepTraceWriter.cc
+//
+//---------------------------------------------------------------
+
+#include "G4StepTraceWriter.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+#include "G4Threading.hh"
+#include "G4UIcommand.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+G4bool G4StepTraceWriter::enabled = false;
+G4String G4StepTraceWriter::fileName = "";
+G4int G4StepTraceWriter::fileRevision = 0;
+std::set<G4String> G4StepTraceWriter::particleNames;
+std::set<G4String> G4StepTraceWriter::volumeNames;
+G4int G4StepTraceWriter::firstEventID = 0;
+G4int G4StepTraceWriter::lastEventID = -1;
+G4int G4StepTraceWriter::bufferSize = 8192;
+G4ThreadLocal G4int G4StepTraceWriter::currentEventID = 0;
+
+static_assert(sizeof(G4StepTraceName)==sizeof(G4StepTraceRecord),
+              "Name and step records of the trace must have the same size");
+
+namespace
+{
+  const G4int traceVersion = 1;
+  const G4int traceByteOrder = 0x01020304;
+
+  G4ThreadLocal G4StepTraceWriter* traceInstance = 0;
+  // File revision written last by the calling thread, to which the
+  // following runs append
+  G4ThreadLocal G4int appendRevision = -1;
+}
+
+G4StepTraceWriter::G4StepTraceWriter()
+  : threadFileName(fileName), threadFileRevision(fileRevision),
+    threadParticleNames(particleNames), threadVolumeNames(volumeNames),
+    threadFirstEventID(firstEventID), threadLastEventID(lastEventID),
+    threadBufferSize(bufferSize)
+{;}
+
+G4StepTraceWriter::~G4StepTraceWriter()
+{ Close(); }
+
+G4StepTraceWriter* G4StepTraceWriter::GetInstance()
+{
+  if(!traceInstance) traceInstance = new G4StepTraceWriter();
+  return traceInstance;
+}
+
+G4StepTraceWriter* G4StepTraceWriter::GetInstanceIfExist()
+{ return traceInstance; }
+
+// The static settings below are changed by the master thread in Idle
+// state only, while no thread is tracking. Worker threads read them only
+// when their instance is created, after the start of the run.
+
+void G4StepTraceWriter::SetFileName(const G4String& name)
+{
+  fileName = name;
+  enabled = !(fileName.empty());
+  ++fileRevision;
+}
+
+const G4String& G4StepTraceWriter::GetFileName()
+{ return fileName; }
+
+void G4StepTraceWriter::AddParticle(const G4String& particleName)
+{
+  particleNames.insert(particleName);
+}
+
+void G4StepTraceWriter::AddVolume(const G4String& physicalVolumeName)
+{
+  volumeNames.insert(physicalVolumeName);
+}
+
+void G4StepTraceWriter::ClearFilters()
+{
+  particleNames.clear();
+  volumeNames.clear();
+  firstEventID = 0;
+  lastEventID = -1;
+}
+
+void G4StepTraceWriter::SetEventRange(G4int firstEvent, G4int lastEvent)
+{
+  firstEventID = firstEvent;
+  lastEventID = lastEvent;
+}
+
+void G4StepTraceWriter::SetBufferSize(G4int nRec)
+{ bufferSize = (nRec>0) ? nRec : 1; }
+
+void G4StepTraceWriter::EndOfRun()
+{
+  // The file is complete once the run is over; the next run takes a new
+  // copy of the settings
+  delete traceInstance;
+  traceInstance = 0;
+}
+
+G4bool G4StepTraceWriter::AcceptTrack(const G4Track* track)
+{
+  if(currentEventID<threadFirstEventID) return false;
+  if(threadLastEventID>=0 && currentEventID>threadLastEventID) return false;
+  if(threadParticleNames.empty()) return true;
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  std::unordered_map<const G4ParticleDefinition*,G4bool>::const_iterator
+    itr = particleSelection.find(particle);
+  if(itr != particleSelection.end()) return itr->second;
+  G4bool accepted = (threadParticleNames.count(particle->GetParticleName())>0);
+  particleSelection[particle] = accepted;
+  return accepted;
+}
+
+G4bool G4StepTraceWriter::Open()
+{
+  G4String name = threadFileName;
+  G4int threadID = -1;
+  if(G4Threading::IsWorkerThread())
+  {
+    threadID = G4Threading::G4GetThreadId();
+    name += ".t";
+    name += G4UIcommand::ConvertToString(threadID);
+  }
+  G4bool append = (appendRevision == threadFileRevision);
+  file.open(name, std::ios::out | std::ios::binary
+                  | (append ? std::ios::app : std::ios::trunc));
+  if(!file)
+  {
+    G4ExceptionDescription ed;
+    ed << "Step trace file <" << name << "> cannot be opened.";
+    G4Exception("G4StepTraceWriter::Open()","Tracking0501",JustWarning,ed);
+    file.clear();
+    return false;
+  }
+  appendRevision = threadFileRevision;
+  buffer.reserve(threadBufferSize);
+  // The IDs of the names are those of this instance; the name records
+  // are written again after those of the previous runs
+  if(append) return true;
+  G4StepTraceHeader header;
+  std::memset(&header,0,sizeof(header));
+  std::memcpy(header.magic,"G4STRACE",8);
+  header.version = traceVersion;
+  header.recordSize = sizeof(G4StepTraceRecord);
+  header.byteOrder = traceByteOrder;
+  header.threadID = threadID;
+  file.write(reinterpret_cast<const char*>(&header),sizeof(header));
+  return true;
+}
+
+void G4StepTraceWriter::Flush()
+{
+  if(file.is_open() && !buffer.empty())
+  {
+    file.write(reinterpret_cast<const char*>(&(buffer[0])),
+               buffer.size()*sizeof(G4StepTraceRecord));
+    file.flush();
+  }
+  buffer.clear();
+}
+
+void G4StepTraceWriter::Close()
+{
+  if(!file.is_open()) return;
+  Flush();
+  file.close();
+  processIDs.clear();
+  volumeIDs.clear();
+}
+
+void G4StepTraceWriter::WriteName(G4int kind, G4int id, const G4String& name)
+{
+  // Name records go through the buffer, hence they always precede the
+  // first step record using them
+  G4StepTraceName rec;
+  std::memset(&rec,0,sizeof(rec));
+  rec.marker = G4StepTraceName::kNameMarker;
+  rec.kind = kind;
+  rec.id = id;
+  rec.length = std::min(G4int(name.length()),G4int(G4StepTraceName::kMaxLength)-1);
+  std::memcpy(rec.name,name.c_str(),rec.length);
+  G4StepTraceRecord raw;
+  std::memcpy(&raw,&rec,sizeof(raw));
+  buffer.push_back(raw);
+}
+
+G4int G4StepTraceWriter::ProcessID(const G4VProcess* process)
+{
+  if(!process) return -1;
+  std::unordered_map<const G4VProcess*,G4int>::const_iterator
+    itr = processIDs.find(process);
+  if(itr != processIDs.end()) return itr->second;
+  G4int id = processIDs.size();
+  processIDs[process] = id;
+  WriteName(G4StepTraceName::kProcess,id,process->GetProcessName());
+  return id;
+}
+
+G4int G4StepTraceWriter::VolumeID(const G4VPhysicalVolume* volume)
+{
+  if(!volume) return -1;
+  std::unordered_map<const G4VPhysicalVolume*,G4int>::const_iterator
+    itr = volumeIDs.find(volume);
+  if(itr != volumeIDs.end()) return itr->second;
+  G4int id = volumeIDs.size();
+  volumeIDs[volume] = id;
+  WriteName(G4StepTraceName::kVolume,id,volume->GetName());
+  return id;
+}
+
+void G4StepTraceWriter::Write(const G4Step* step, const G4Track* track)
+{
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+  const G4VPhysicalVolume* volume = pre->GetPhysicalVolume();
+
+  if(!threadVolumeNames.empty())
+  {
+    std::unordered_map<const G4VPhysicalVolume*,G4bool>::const_iterator
+      itr = volumeSelection.find(volume);
+    G4bool accepted;
+    if(itr != volumeSelection.end())
+    { accepted = itr->second; }
+    else
+    {
+      accepted = volume && (threadVolumeNames.count(volume->GetName())>0);
+      volumeSelection[volume] = accepted;
+    }
+    if(!accepted) return;
+  }
+
+  if(!file.is_open())
+  { if(!Open()) return; }
+
+  G4StepTraceRecord rec;
+  rec.eventID = currentEventID;
+  rec.trackID = track->GetTrackID();
+  rec.parentID = track->GetParentID();
+  rec.stepNumber = track->GetCurrentStepNumber();
+  rec.pdgCode = track->GetDefinition()->GetPDGEncoding();
+  rec.processID = ProcessID(post->GetProcessDefinedStep());
+  rec.volumeID = VolumeID(volume);
+  rec.copyNo = volume ? pre->GetTouchable()->GetReplicaNumber() : -1;
+  const G4ThreeVector& prePos = pre->GetPosition();
+  rec.prePosition[0] = prePos.x();
+  rec.prePosition[1] = prePos.y();
+  rec.prePosition[2] = prePos.z();
+  rec.preGlobalTime = pre->GetGlobalTime();
+  rec.preKineticEnergy = pre->GetKineticEnergy();
+  const G4ThreeVector& postPos = post->GetPosition();
+  rec.postPosition[0] = postPos.x();
+  rec.postPosition[1] = postPos.y();
+  rec.postPosition[2] = postPos.z();
+  rec.postGlobalTime = post->GetGlobalTime();
+  rec.postKineticEnergy = post->GetKineticEnergy();
+  rec.energyDeposit = step->GetTotalEnergyDeposit();
+  rec.stepLength = step->GetStepLength();
+  buffer.push_back(rec);
+
+  if(G4int(buffer.size())>=threadBufferSize) Flush();
+}
+
+//---------------------------------------------------------------
+// G4StepTraceReader
+//---------------------------------------------------------------
+
+G4StepTraceReader::G4StepTraceReader(const G4String& fileName)
+  : file(fileName, std::ios::in | std::ios::binary), valid(false)
+{
+  std::memset(&header,0,sizeof(header));
+  if(!file) return;
+  file.read(reinterpret_cast<char*>(&header),sizeof(header));
+  if(!file || std::memcmp(header.magic,"G4STRACE",8)!=0) return;
+  if(header.version!=traceVersion
+     || header.recordSize!=G4int(sizeof(G4StepTraceRecord))
+     || header.byteOrder!=traceByteOrder)
+  {
+    G4ExceptionDescription ed;
+    ed << "Step trace file <" << fileName << "> has version "
+       << header.version << " and records of " << header.recordSize
+       << " bytes, or was written with another byte order.";
+    G4Exception("G4StepTraceReader::G4StepTraceReader()","Tracking0502",
+                JustWarning,ed);
+    return;
+  }
+  valid = true;
+}
+
+G4StepTraceReader::~G4StepTraceReader()
+{;}
+
+G4bool G4StepTraceReader::Next(G4StepTraceRecord& record)
+{
+  if(!valid) return false;
+  while(file.read(reinterpret_cast<char*>(&record),sizeof(record))) // Loop checking 17.10.2026
+  {
+    if(record.eventID!=G4StepTraceName::kNameMarker) return true;
+    G4StepTraceName rec;
+    std::memcpy(&rec,&record,sizeof(rec));
+    std::vector<G4String>& names =
+      (rec.kind==G4StepTraceName::kProcess) ? processNames : volumeNames;
+    if(rec.id<0) continue;
+    if(G4int(names.size())<=rec.id) names.resize(rec.id+1);
+    names[rec.id] = G4String(rec.name,rec.length);
+  }
+  return false;
+}
+
+const G4String& G4StepTraceReader::GetProcessName(G4int processID) const
+{
+  static const G4String none = "none";
+  if(processID<0 || processID>=G4int(processNames.size())) return none;
+  return processNames[processID];
+}
+
+const G4String& G4StepTraceReader::GetVolumeName(G4int volumeID) const
+{
+  static const G4String none = "none";
+  if(volumeID<0 || volumeID>=G4int(volumeNames.size())) return none;
+  return volumeNames[volumeID];
+}
+
+G4long G4StepTraceReader::Dump(const G4String& fileName, G4long maxRecords)
+{
+  G4StepTraceReader reader(fileName);
+  if(!reader.IsValid())
+  {
+    G4cerr << "G4StepTraceReader::Dump() - <" << fileName
+           << "> is not a valid step trace file." << G4endl;
+    return 0;
+  }
+  G4cout << "# Step trace " << fileName << " (thread "
+         << reader.GetHeader().threadID << ")" << G4endl
+         << "# event track parent step pdg volume copyNo"
+         << " preX preY preZ preT preEkin postX postY postZ postT postEkin"
+         << " eDep stepLength process  [mm ns MeV]" << G4endl;
+  G4long n = 0;
+  G4StepTraceRecord rec;
+  G4int oldPrecision = G4cout.precision(8);
+  while( (maxRecords<0 || n<maxRecords) && reader.Next(rec) ) // Loop checking 17.10.2026
+  {
+    G4cout << rec.eventID << " " << rec.trackID << " " << rec.parentID
+           << " " << rec.stepNumber << " " << rec.pdgCode
+           << " " << reader.GetVolumeName(rec.volumeID) << " " << rec.copyNo
+           << " " << rec.prePosition[0] << " " << rec.prePosition[1]
+           << " " << rec.prePosition[2] << " " << rec.preGlobalTime
+           << " " << rec.preKineticEnergy
+           << " " << rec.postPosition[0] << " " << rec.postPosition[1]
+           << " " << rec.postPosition[2] << " " << rec.postGlobalTime
+           << " " << rec.postKineticEnergy
+           << " " << rec.energyDeposit << " " << rec.stepLength
+           << " " << reader.GetProcessName(rec.processID) << G4endl;
+    ++n;
+  }
+  G4cout.precision(oldPrecision);
+  G4cout << "# " << n << " step records" << G4endl;
+  return n;
+}
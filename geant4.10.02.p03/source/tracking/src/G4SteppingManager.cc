@@ -55,7 +55,7 @@
 //////////////////////////////////////
 G4SteppingManager::G4SteppingManager()
 //////////////////////////////////////
-  : fUserSteppingAction(0), verboseLevel(0)
+  : fUserSteppingAction(0), fDispatchTable(0), verboseLevel(0)
 {
 
 // Construct simple 'has-a' related objects
@@ -105,6 +105,9 @@ G4SteppingManager::~G4SteppingManager()
    delete fSelectedAtRestDoItVector;
    delete fSelectedAlongStepDoItVector;
    delete fSelectedPostStepDoItVector;
+   std::map<const G4ProcessManager*,G4ProcessDispatchTable*>::iterator itr;
+   for(itr=fDispatchTables.begin();itr!=fDispatchTables.end();itr++)
+   { delete itr->second; }
    if (fUserSteppingAction) delete fUserSteppingAction;
 #ifdef G4VERBOSE
    if(KillVerbose) delete fVerbose;
@@ -150,6 +153,9 @@ G4StepStatus G4SteppingManager::Stepping()
 // Reset the step's auxiliary points vector pointer
    fStep->SetPointerToVectorOfAuxiliaryPoints(0);
 
+// Processes may have been added, (in)activated since the previous step
+   if( !fDispatchTable || !fDispatchTable->IsUpToDate() ) GetProcessNumber();
+
 //-----------------
 // AtRest Processes
 //-----------------
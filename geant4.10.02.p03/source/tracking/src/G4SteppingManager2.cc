@@ -114,6 +114,38 @@ void G4SteppingManager::GetProcessNumber()
                  "Tracking0012", FatalException,
                  "The array size is smaller than the actual No of processes.");
    }
+
+// Dispatch table of the active processes. The inactivated ones are never
+// selected, their flag is set once here.
+   fDispatchTable = GetDispatchTable(pm);
+   for(size_t ri=0; ri < MAXofAtRestLoops; ri++)
+   { (*fSelectedAtRestDoItVector)[ri] = InActivated; }
+   for(size_t np=0; np < MAXofPostStepLoops; np++)
+   { (*fSelectedPostStepDoItVector)[np] = InActivated; }
+}
+
+/////////////////////////////////////////////////
+G4ProcessDispatchTable*
+G4SteppingManager::GetDispatchTable(const G4ProcessManager* pm)
+/////////////////////////////////////////////////
+{
+   G4ProcessDispatchTable*& aTable = fDispatchTables[pm];
+   if(!aTable) aTable = new G4ProcessDispatchTable(pm);
+   else if(!aTable->IsUpToDate()) aTable->Build();
+   return aTable;
+}
+
+/////////////////////////////////////////////////
+void G4SteppingManager::BuildDispatchTables()
+/////////////////////////////////////////////////
+{
+   G4ParticleTable::G4PTblDicIterator* pItr
+     = G4ParticleTable::GetParticleTable()->GetIterator();
+   pItr->reset();
+   while( (*pItr)() ){
+     G4ProcessManager* pm = pItr->value()->GetProcessManager();
+     if(pm) GetDispatchTable(pm);
+   }
 }
 
 
@@ -162,12 +194,13 @@ void G4SteppingManager::GetProcessNumber()
 // GPIL for PostStep
    fPostStepDoItProcTriggered = MAXofPostStepLoops;
 
-   for(size_t np=0; np < MAXofPostStepLoops; np++){
-     fCurrentProcess = (*fPostStepGetPhysIntVector)(np);
-     if (fCurrentProcess== 0) {
-       (*fSelectedPostStepDoItVector)[np] = InActivated;
-       continue;
-     }   // NULL means the process is inactivated by a user on fly.
+   const G4ProcessDispatchTable::G4DispatchVector& postStepGPIL
+     = fDispatchTable->GetPostStepGPIL();
+   size_t nPostStepGPIL = postStepGPIL.size();
+   for(size_t ip=0; ip < nPostStepGPIL; ip++){
+     // Processes inactivated by a user on fly are not in the table
+     size_t np = postStepGPIL[ip].index;
+     fCurrentProcess = postStepGPIL[ip].process;
 
      physIntLength = fCurrentProcess->
                      PostStepGPIL( *fTrack,
@@ -234,10 +267,12 @@ void G4SteppingManager::GetProcessNumber()
    proposedSafety = DBL_MAX;
    G4double safetyProposedToAndByProcess = proposedSafety;
 
-   for(size_t kp=0; kp < MAXofAlongStepLoops; kp++){
-     fCurrentProcess = (*fAlongStepGetPhysIntVector)[kp];
-     if (fCurrentProcess== 0) continue;
-         // NULL means the process is inactivated by a user on fly.
+   const G4ProcessDispatchTable::G4DispatchVector& alongStepGPIL
+     = fDispatchTable->GetAlongStepGPIL();
+   size_t nAlongStepGPIL = alongStepGPIL.size();
+   for(size_t ip=0; ip < nAlongStepGPIL; ip++){
+     size_t kp = alongStepGPIL[ip].index;
+     fCurrentProcess = alongStepGPIL[ip].process;
 
      physIntLength = fCurrentProcess->
                      AlongStepGPIL( *fTrack, fPreviousStepSize,
@@ -290,14 +325,14 @@ void G4SteppingManager::InvokeAtRestDoItProcs()
    fAtRestDoItProcTriggered = 0;
    shortestLifeTime = DBL_MAX;
 
-   unsigned int NofInactiveProc=0;
-   for( size_t ri=0 ; ri < MAXofAtRestLoops ; ri++ ){
-     fCurrentProcess = (*fAtRestGetPhysIntVector)[ri];
-     if (fCurrentProcess== 0) {
-       (*fSelectedAtRestDoItVector)[ri] = InActivated;
-       NofInactiveProc++;
-       continue;
-     }   // NULL means the process is inactivated by a user on fly.
+   const G4ProcessDispatchTable::G4DispatchVector& atRestGPIL
+     = fDispatchTable->GetAtRestGPIL();
+   size_t nAtRestGPIL = atRestGPIL.size();
+   unsigned int NofInactiveProc = MAXofAtRestLoops - nAtRestGPIL;
+   for( size_t ip=0 ; ip < nAtRestGPIL ; ip++ ){
+     // Processes inactivated by a user on fly are not in the table
+     size_t ri = atRestGPIL[ip].index;
+     fCurrentProcess = atRestGPIL[ip].process;
 
      lifeTime =
        fCurrentProcess->AtRestGPIL( *fTrack, &fCondition );
@@ -408,10 +443,12 @@ void G4SteppingManager::InvokeAlongStepDoItProcs()
    }
 
 // Invoke the all active continuous processes
-   for( size_t ci=0 ; ci<MAXofAlongStepLoops ; ci++ ){
-     fCurrentProcess = (*fAlongStepDoItVector)[ci];
-     if (fCurrentProcess== 0) continue;
-         // NULL means the process is inactivated by a user on fly.
+   const G4ProcessDispatchTable::G4DispatchVector& alongStepDoIt
+     = fDispatchTable->GetAlongStepDoIt();
+   size_t nAlongStepDoIt = alongStepDoIt.size();
+   for( size_t ci=0 ; ci<nAlongStepDoIt ; ci++ ){
+     // Processes inactivated by a user on fly are not in the table
+     fCurrentProcess = alongStepDoIt[ci].process;
 
      fParticleChange 
        = fCurrentProcess->AlongStepDoIt( *fTrack, *fStep );
@@ -485,11 +522,15 @@ void G4SteppingManager::InvokePostStepDoItProcs()
 {
 
 // Invoke the specified discrete processes
-   for(size_t np=0; np < MAXofPostStepLoops; np++){
+   const G4ProcessDispatchTable::G4DispatchVector& postStepDoIt
+     = fDispatchTable->GetPostStepDoIt();
+   size_t nPostStepDoIt = postStepDoIt.size();
+   for(size_t ip=0; ip < nPostStepDoIt; ip++){
    //
    // Note: DoItVector has inverse order against GetPhysIntVector
    //       and SelectedPostStepDoItVector.
    //
+     size_t np = postStepDoIt[ip].index;
      G4int Cond = (*fSelectedPostStepDoItVector)[MAXofPostStepLoops-np-1];
      if(Cond != InActivated){
        if( ((Cond == NotForced) && (fStepStatus == fPostStepDoItProc)) ||
@@ -510,7 +551,8 @@ void G4SteppingManager::InvokePostStepDoItProcs()
      // Exit from PostStepLoop if the track has been killed,
      // but extra treatment for processes with Strongly Forced flag
      if(fTrack->GetTrackStatus() == fStopAndKill) {
-       for(size_t np1=np+1; np1 < MAXofPostStepLoops; np1++){ 
+       for(size_t ip1=ip+1; ip1 < nPostStepDoIt; ip1++){ 
+	 size_t np1 = postStepDoIt[ip1].index;
 	 G4int Cond2 = (*fSelectedPostStepDoItVector)[MAXofPostStepLoops-np1-1];
 	 if (Cond2 == StronglyForced) {
 	   InvokePSDIP(np1);
@@ -518,7 +560,7 @@ void G4SteppingManager::InvokePostStepDoItProcs()
        }
        break;
      }
-   } //for(size_t np=0; np < MAXofPostStepLoops; np++){
+   } //for(size_t ip=0; ip < nPostStepDoIt; ip++){
 }
 
 
@@ -0,0 +1,205 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+//
+//---------------------------------------------------------------
+//
+// G4SteppingProfiler.cc
+//
+//---------------------------------------------------------------
+
+#include "G4SteppingProfiler.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4AutoLock.hh"
+#include "G4ios.hh"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+G4bool G4SteppingProfiler::enabled = false;
+G4String G4SteppingProfiler::outputFile = "";
+G4int G4SteppingProfiler::reportSize = 20;
+std::vector<G4SteppingProfiler*>* G4SteppingProfiler::instances = 0;
+
+namespace
+{
+  G4Mutex profilerMutex = G4MUTEX_INITIALIZER;
+
+  struct G4ProfileSum
+  {
+    G4double time;
+    G4long calls;
+    G4ProfileSum() : time(0.), calls(0) {}
+  };
+
+  typedef std::vector<G4String> G4ProfileNames;
+  typedef std::pair<G4ProfileNames,G4ProfileSum> G4ProfileItem;
+
+  G4bool LargerTime(const G4ProfileItem& a, const G4ProfileItem& b)
+  { return a.second.time > b.second.time; }
+
+  std::vector<G4ProfileItem> Sorted(const std::map<G4ProfileNames,G4ProfileSum>& m)
+  {
+    std::vector<G4ProfileItem> v(m.begin(),m.end());
+    std::sort(v.begin(),v.end(),LargerTime);
+    return v;
+  }
+
+  void PrintLine(const G4ProfileItem& item, G4double total)
+  {
+    G4cout << std::setw(12) << item.second.time
+           << std::setw(8) << std::setprecision(3)
+           << (total>0. ? 100.*item.second.time/total : 0.)
+           << std::setw(14) << item.second.calls
+           << std::setw(12) << std::setprecision(4)
+           << (item.second.calls>0 ? 1.e6*item.second.time/item.second.calls : 0.)
+           << std::setprecision(6) << "  ";
+    for(size_t i=0;i<item.first.size();i++)
+    { G4cout << " " << item.first[i]; }
+    G4cout << G4endl;
+  }
+}
+
+G4SteppingProfiler::G4SteppingProfiler()
+{;}
+
+G4SteppingProfiler* G4SteppingProfiler::GetInstance()
+{
+  static G4ThreadLocal G4SteppingProfiler* instance = 0;
+  if(!instance)
+  {
+    instance = new G4SteppingProfiler();
+    G4AutoLock l(&profilerMutex);
+    if(!instances) instances = new std::vector<G4SteppingProfiler*>;
+    instances->push_back(instance);
+  }
+  return instance;
+}
+
+void G4SteppingProfiler::SetEnabled(G4bool val)
+{ enabled = val; }
+
+void G4SteppingProfiler::SetOutputFile(const G4String& fileName)
+{ outputFile = fileName; }
+
+void G4SteppingProfiler::SetReportSize(G4int n)
+{ reportSize = n; }
+
+void G4SteppingProfiler::Reset()
+{
+  G4AutoLock l(&profilerMutex);
+  if(!instances) return;
+  for(size_t i=0;i<instances->size();i++)
+  { (*instances)[i]->table.clear(); }
+}
+
+void G4SteppingProfiler::Report()
+{
+  // Processes and particles are not shared among threads, hence the
+  // entries are merged by names.
+  std::map<G4ProfileNames,G4ProfileSum> all, perRegion, perParticle, perProcess;
+  G4double total = 0.;
+  G4long nCalls = 0;
+  {
+    G4AutoLock l(&profilerMutex);
+    if(!instances) return;
+    for(size_t i=0;i<instances->size();i++)
+    {
+      std::unordered_map<Key,Entry,KeyHash>& tbl = (*instances)[i]->table;
+      for(std::unordered_map<Key,Entry,KeyHash>::const_iterator itr = tbl.begin();
+          itr != tbl.end(); itr++)
+      {
+        const Key& key = itr->first;
+        G4ProfileNames names(4);
+        names[0] = key.particle ? key.particle->GetParticleName() : G4String("unknown");
+        names[1] = key.process ? key.process->GetProcessName() : G4String("(tracking)");
+        names[2] = key.volume ? key.volume->GetName() : G4String("unknown");
+        const G4Region* region = key.volume ? key.volume->GetRegion() : 0;
+        names[3] = region ? region->GetName() : G4String("unknown");
+        G4double t = std::chrono::duration<G4double>(itr->second.time).count();
+        G4long n = itr->second.calls;
+        G4ProfileSum* sums[4] = { &all[names],
+                                  &perRegion[G4ProfileNames(1,names[3])],
+                                  &perParticle[G4ProfileNames(1,names[0])],
+                                  &perProcess[G4ProfileNames(1,names[1])] };
+        for(size_t j=0;j<4;j++)
+        {
+          sums[j]->time += t;
+          sums[j]->calls += n;
+        }
+        total += t;
+        nCalls += n;
+      }
+      tbl.clear();
+    }
+  }
+  if(all.empty()) return;
+
+  std::vector<G4ProfileItem> items = Sorted(all);
+  G4cout << G4endl
+         << "=== G4SteppingProfiler : " << total << " s of tracking in "
+         << nCalls << " calls, summed over all threads ===" << G4endl
+         << "    time [s]       %         calls  us/call   particle process volume region"
+         << G4endl;
+  for(size_t i=0;i<items.size() && G4int(i)<reportSize;i++)
+  { PrintLine(items[i],total); }
+
+  const char* titles[3] = { "region", "particle", "process" };
+  const std::map<G4ProfileNames,G4ProfileSum>* maps[3]
+    = { &perRegion, &perParticle, &perProcess };
+  for(size_t j=0;j<3;j++)
+  {
+    G4cout << "--- per " << titles[j] << G4endl;
+    std::vector<G4ProfileItem> sums = Sorted(*(maps[j]));
+    for(size_t i=0;i<sums.size() && G4int(i)<reportSize;i++)
+    { PrintLine(sums[i],total); }
+  }
+  G4cout << G4endl;
+
+  if(!outputFile.empty())
+  {
+    std::ofstream out(outputFile.c_str());
+    if(!out)
+    {
+      G4ExceptionDescription ED;
+      ED << "Profile file <" << outputFile << "> cannot be opened.";
+      G4Exception("G4SteppingProfiler::Report()","Tracking0401",JustWarning,ED);
+      return;
+    }
+    out << "particle,process,volume,region,calls,time_s" << std::endl;
+    out << std::setprecision(9);
+    for(size_t i=0;i<items.size();i++)
+    {
+      const G4ProfileNames& names = items[i].first;
+      out << names[0] << "," << names[1] << "," << names[2] << "," << names[3]
+          << "," << items[i].second.calls << "," << items[i].second.time << std::endl;
+    }
+  }
+}
@@ -41,6 +41,9 @@
 #include "G4Trajectory.hh"
 #include "G4SmoothTrajectory.hh"
 #include "G4RichTrajectory.hh"
+#include "G4SteppingProfiler.hh"
+#include "G4StepTraceWriter.hh"
+#include "G4LogicalVolume.hh"
 #include "G4ios.hh"
 class G4VSteppingVerbose;
 
@@ -73,6 +76,24 @@ void G4TrackingManager::ProcessOneTrack(G4Track* apValueG4Track)
   fpTrack = apValueG4Track;
   EventIsAborted = false;
 
+  // Optional profiling of the time spent per particle/process/volume
+  G4SteppingProfiler* profiler = 0;
+  G4SteppingProfiler::Clock::time_point trackStart;
+  G4SteppingProfiler::Clock::duration stepsTime(0);
+  if(G4SteppingProfiler::IsEnabled())
+  {
+    profiler = G4SteppingProfiler::GetInstance();
+    trackStart = G4SteppingProfiler::Clock::now();
+  }
+
+  // Optional binary trace of the steps
+  G4StepTraceWriter* trace = 0;
+  if(G4StepTraceWriter::IsEnabled())
+  {
+    trace = G4StepTraceWriter::GetInstance();
+    if(!trace->AcceptTrack(fpTrack)) trace = 0;
+  }
+
   // Clear 2ndary particle vector
   //  GimmeSecondaries()->clearAndDestroy();    
   //  std::vector<G4Track*>::iterator itr;
@@ -123,7 +144,23 @@ void G4TrackingManager::ProcessOneTrack(G4Track* apValueG4Track)
          (fpTrack->GetTrackStatus() == fStopButAlive) ){
 
     fpTrack->IncrementCurrentStepNumber();
-    fpSteppingManager->Stepping();
+    if(profiler)
+    {
+      G4SteppingProfiler::Clock::time_point stepStart
+        = G4SteppingProfiler::Clock::now();
+      fpSteppingManager->Stepping();
+      G4SteppingProfiler::Clock::duration stepTime
+        = G4SteppingProfiler::Clock::now() - stepStart;
+      const G4StepPoint* preStep = fpSteppingManager->GetStep()->GetPreStepPoint();
+      const G4VPhysicalVolume* pv = preStep->GetPhysicalVolume();
+      profiler->Add(fpTrack->GetDefinition(),
+                    fpSteppingManager->GetStep()->GetPostStepPoint()->GetProcessDefinedStep(),
+                    pv ? pv->GetLogicalVolume() : 0, stepTime);
+      stepsTime += stepTime;
+    }
+    else
+    { fpSteppingManager->Stepping(); }
+    if(trace) trace->Write(fpSteppingManager->GetStep(),fpTrack);
 #ifdef G4_STORE_TRAJECTORY
     if(StoreTrajectory) fpTrajectory->
                         AppendStep(fpSteppingManager->GetStep()); 
@@ -148,6 +185,12 @@ void G4TrackingManager::ProcessOneTrack(G4Track* apValueG4Track)
       delete fpTrajectory;
       fpTrajectory = 0;
   }
+
+  if(profiler)
+  {
+    profiler->Add(fpTrack->GetDefinition(),0,fpTrack->GetLogicalVolumeAtVertex(),
+                  G4SteppingProfiler::Clock::now() - trackStart - stepsTime);
+  }
 }
 
 void G4TrackingManager::SetTrajectory(G4VTrajectory* aTrajectory)
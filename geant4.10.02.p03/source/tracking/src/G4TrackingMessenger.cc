@@ -46,6 +46,9 @@
 #include "G4UIdirectory.hh"
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIparameter.hh"
 #include "G4UImanager.hh"
 #include "globals.hh"
 #include "G4TrackingManager.hh"
@@ -55,6 +58,9 @@
 #include "G4TransportationManager.hh"
 #include "G4PropagatorInField.hh"
 #include "G4IdentityTrajectoryFilter.hh"
+#include "G4SteppingProfiler.hh"
+#include "G4StepTraceWriter.hh"
+#include "G4Tokenizer.hh"
 
 ///////////////////////////////////////////////////////////////////
 G4TrackingMessenger::G4TrackingMessenger(G4TrackingManager * trMan)
@@ -105,6 +111,107 @@ G4TrackingMessenger::G4TrackingMessenger(G4TrackingManager * trMan)
 #else 
   VerboseCmd->SetGuidance("You need to recompile the tracking category defining G4VERBOSE ");  
 #endif
+
+  ProfileDirectory = new G4UIdirectory("/tracking/profile/");
+  ProfileDirectory->SetGuidance("Profiling of the time spent in tracking.");
+  ProfileDirectory->SetGuidance("Wall-clock time and number of steps are accumulated per particle,");
+  ProfileDirectory->SetGuidance("process limiting the step, logical volume and region, and are");
+  ProfileDirectory->SetGuidance("reported at the end of each run (summed over all threads).");
+
+  ProfileEnableCmd = new G4UIcmdWithABool("/tracking/profile/enable",this);
+  ProfileEnableCmd->SetGuidance("Enable/disable the tracking profiler.");
+  ProfileEnableCmd->SetParameterName("flag",true);
+  ProfileEnableCmd->SetDefaultValue(true);
+  ProfileEnableCmd->SetToBeBroadcasted(false);
+  ProfileEnableCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  ProfileOutputCmd = new G4UIcmdWithAString("/tracking/profile/output",this);
+  ProfileOutputCmd->SetGuidance("Write all entries of the profile to the given CSV file");
+  ProfileOutputCmd->SetGuidance("at the end of each run. No file is written if empty.");
+  ProfileOutputCmd->SetParameterName("fileName",true);
+  ProfileOutputCmd->SetDefaultValue("");
+  ProfileOutputCmd->SetToBeBroadcasted(false);
+  ProfileOutputCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  ProfileSizeCmd = new G4UIcmdWithAnInteger("/tracking/profile/reportSize",this);
+  ProfileSizeCmd->SetGuidance("Number of entries printed in each section of the report.");
+  ProfileSizeCmd->SetParameterName("n",true);
+  ProfileSizeCmd->SetDefaultValue(20);
+  ProfileSizeCmd->SetRange("n >= 0");
+  ProfileSizeCmd->SetToBeBroadcasted(false);
+  ProfileSizeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  ProfileReportCmd = new G4UIcmdWithoutParameter("/tracking/profile/report",this);
+  ProfileReportCmd->SetGuidance("Print (and write) the profile accumulated so far, then reset it.");
+  ProfileReportCmd->SetToBeBroadcasted(false);
+  ProfileReportCmd->AvailableForStates(G4State_Idle);
+
+  TraceDirectory = new G4UIdirectory("/tracking/trace/");
+  TraceDirectory->SetGuidance("Binary trace of the steps.");
+  TraceDirectory->SetGuidance("One fixed-size record is written per selected step (event, track,");
+  TraceDirectory->SetGuidance("step, pre/post point, process, energy deposit, volume and copy number).");
+  TraceDirectory->SetGuidance("In multi-threaded mode each worker writes its own file, suffixed");
+  TraceDirectory->SetGuidance("by \".t<thread ID>\".");
+
+  TraceFileCmd = new G4UIcmdWithAString("/tracking/trace/file",this);
+  TraceFileCmd->SetGuidance("Write the step trace to the given file.");
+  TraceFileCmd->SetGuidance("The trace is disabled if empty. The files are closed at the end");
+  TraceFileCmd->SetGuidance("of each run and the following runs append to them, until this");
+  TraceFileCmd->SetGuidance("command is given again.");
+  TraceFileCmd->SetParameterName("fileName",true);
+  TraceFileCmd->SetDefaultValue("");
+  TraceFileCmd->SetToBeBroadcasted(false);
+  TraceFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  TraceParticleCmd = new G4UIcmdWithAString("/tracking/trace/particle",this);
+  TraceParticleCmd->SetGuidance("Add a particle to the selection of the step trace.");
+  TraceParticleCmd->SetGuidance("All particles are traced if none is selected.");
+  TraceParticleCmd->SetParameterName("particleName",false);
+  TraceParticleCmd->SetToBeBroadcasted(false);
+  TraceParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  TraceVolumeCmd = new G4UIcmdWithAString("/tracking/trace/volume",this);
+  TraceVolumeCmd->SetGuidance("Add a physical volume to the selection of the step trace.");
+  TraceVolumeCmd->SetGuidance("A step is selected by the volume of its pre-step point.");
+  TraceVolumeCmd->SetGuidance("All volumes are traced if none is selected.");
+  TraceVolumeCmd->SetParameterName("physicalVolumeName",false);
+  TraceVolumeCmd->SetToBeBroadcasted(false);
+  TraceVolumeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  TraceEventRangeCmd = new G4UIcommand("/tracking/trace/eventRange",this);
+  TraceEventRangeCmd->SetGuidance("Trace the events with IDs from first to last (included).");
+  TraceEventRangeCmd->SetGuidance("A negative last event ID means no upper limit.");
+  G4UIparameter* firstParam = new G4UIparameter("first",'i',false);
+  firstParam->SetParameterRange("first >= 0");
+  TraceEventRangeCmd->SetParameter(firstParam);
+  G4UIparameter* lastParam = new G4UIparameter("last",'i',true);
+  lastParam->SetDefaultValue(-1);
+  TraceEventRangeCmd->SetParameter(lastParam);
+  TraceEventRangeCmd->SetToBeBroadcasted(false);
+  TraceEventRangeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  TraceClearCmd = new G4UIcmdWithoutParameter("/tracking/trace/clearFilters",this);
+  TraceClearCmd->SetGuidance("Clear the particle, volume and event selections of the step trace.");
+  TraceClearCmd->SetToBeBroadcasted(false);
+  TraceClearCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  TraceBufferCmd = new G4UIcmdWithAnInteger("/tracking/trace/bufferSize",this);
+  TraceBufferCmd->SetGuidance("Number of records buffered per thread before writing.");
+  TraceBufferCmd->SetParameterName("n",false);
+  TraceBufferCmd->SetRange("n > 0");
+  TraceBufferCmd->SetToBeBroadcasted(false);
+  TraceBufferCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  TraceDumpCmd = new G4UIcommand("/tracking/trace/dump",this);
+  TraceDumpCmd->SetGuidance("Print the records of a step trace file in a text format.");
+  TraceDumpCmd->SetGuidance("A negative maximum number of records means all of them.");
+  G4UIparameter* fileParam = new G4UIparameter("fileName",'s',false);
+  TraceDumpCmd->SetParameter(fileParam);
+  G4UIparameter* maxParam = new G4UIparameter("maxRecords",'i',true);
+  maxParam->SetDefaultValue(-1);
+  TraceDumpCmd->SetParameter(maxParam);
+  TraceDumpCmd->SetToBeBroadcasted(false);
+  TraceDumpCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
 }
 
 ////////////////////////////////////////////
@@ -116,6 +223,19 @@ G4TrackingMessenger::~G4TrackingMessenger()
   delete ResumeCmd;
   delete StoreTrajectoryCmd;
   delete VerboseCmd;
+  delete ProfileEnableCmd;
+  delete ProfileOutputCmd;
+  delete ProfileSizeCmd;
+  delete ProfileReportCmd;
+  delete ProfileDirectory;
+  delete TraceFileCmd;
+  delete TraceParticleCmd;
+  delete TraceVolumeCmd;
+  delete TraceEventRangeCmd;
+  delete TraceClearCmd;
+  delete TraceBufferCmd;
+  delete TraceDumpCmd;
+  delete TraceDirectory;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -151,6 +271,57 @@ void G4TrackingMessenger::SetNewValue(G4UIcommand * command,G4String newValues)
     }
     trackingManager->SetStoreTrajectory(trajType);
   }
+
+  if( command == ProfileEnableCmd ){
+    G4SteppingProfiler::SetEnabled(ProfileEnableCmd->GetNewBoolValue(newValues));
+  }
+
+  if( command == ProfileOutputCmd ){
+    G4SteppingProfiler::SetOutputFile(newValues);
+  }
+
+  if( command == ProfileSizeCmd ){
+    G4SteppingProfiler::SetReportSize(ProfileSizeCmd->GetNewIntValue(newValues));
+  }
+
+  if( command == ProfileReportCmd ){
+    G4SteppingProfiler::Report();
+  }
+
+  if( command == TraceFileCmd ){
+    G4StepTraceWriter::SetFileName(newValues);
+  }
+
+  if( command == TraceParticleCmd ){
+    G4StepTraceWriter::AddParticle(newValues);
+  }
+
+  if( command == TraceVolumeCmd ){
+    G4StepTraceWriter::AddVolume(newValues);
+  }
+
+  if( command == TraceEventRangeCmd ){
+    G4Tokenizer next(newValues);
+    G4String firstEvent = next();
+    G4String lastEvent = next();
+    G4StepTraceWriter::SetEventRange(G4UIcommand::ConvertToInt(firstEvent),
+                                     G4UIcommand::ConvertToInt(lastEvent));
+  }
+
+  if( command == TraceClearCmd ){
+    G4StepTraceWriter::ClearFilters();
+  }
+
+  if( command == TraceBufferCmd ){
+    G4StepTraceWriter::SetBufferSize(TraceBufferCmd->GetNewIntValue(newValues));
+  }
+
+  if( command == TraceDumpCmd ){
+    G4Tokenizer next(newValues);
+    G4String fileName = next();
+    G4String maxRecords = next();
+    G4StepTraceReader::Dump(fileName,G4UIcommand::ConvertToInt(maxRecords));
+  }
 }
 
 
@@ -164,6 +335,12 @@ G4String G4TrackingMessenger::GetCurrentValue(G4UIcommand * command)
   else if( command == StoreTrajectoryCmd ){
     return StoreTrajectoryCmd->ConvertToString(trackingManager->GetStoreTrajectory());
   }
+  else if( command == ProfileEnableCmd ){
+    return ProfileEnableCmd->ConvertToString(G4SteppingProfiler::IsEnabled());
+  }
+  else if( command == TraceFileCmd ){
+    return G4StepTraceWriter::GetFileName();
+  }
   return G4String('\0');
 }
 